@@ -0,0 +1,322 @@
+#include "ApiServer.h"
+
+// Commands accepted by POST /commands (same syntax as Telegram, without the slash)
+static const char COMMAND_LIST_JSON[] PROGMEM =
+  "{\"commands\":[\"pee\",\"poo\",\"out\",\"setpee <minutes>\",\"setpoo <minutes>\","
+  "\"setout <minutes>\",\"setall <minutes>\",\"setyellow <minutes>\",\"setred <minutes>\","
+  "\"set <key> <value>\",\"config\",\"config reset\","
+  "\"stats\",\"resetstats\",\"predict\",\"predict on|off\",\"resetpredict\",\"history\",\"power\",\"update\",\"update <url> <sha256> <secret>\"]}";
+
+// Sent by hand because the connection is handed over to EventStream afterwards
+static const char SSE_HEADERS[] PROGMEM =
+  "HTTP/1.1 200 OK\r\n"
+  "Content-Type: text/event-stream\r\n"
+  "Cache-Control: no-cache\r\n"
+  "Connection: keep-alive\r\n"
+  "Access-Control-Allow-Origin: *\r\n\r\n";
+
+ApiServer::ApiServer() :
+  server(API_SERVER_PORT),
+  timerManager(nullptr),
+  eventLog(nullptr),
+  storage(nullptr),
+  eventStream(nullptr),
+  historyExport(nullptr),
+  history(nullptr),
+  commandCallback(nullptr),
+  started(false),
+  statusLength(0),
+  statusRevision(0),
+  statusAlertLevel(0),
+  statusYellowThreshold(0),
+  statusRedThreshold(0),
+  statusCommitsToday(0),
+  statusTimeSynced(false),
+  statusValid(false)
+{
+  statusBuffer[0] = '\0';
+  statusEtag[0] = '\0';
+}
+
+void ApiServer::begin(TimerManager* timerManager, EventLog* eventLog, Storage* storage) {
+  this->timerManager = timerManager;
+  this->eventLog = eventLog;
+  this->storage = storage;
+
+  // Needed to read If-None-Match for conditional /status requests
+  static const char* headerKeys[] = {"If-None-Match"};
+  server.collectHeaders(headerKeys, 1);
+
+  server.on("/status", HTTP_GET, [this]() { handleStatus(); });
+  server.on("/events", HTTP_GET, [this]() { handleEvents(); });
+  server.on("/commands", HTTP_GET, [this]() { handleCommandList(); });
+  server.on("/commands", HTTP_POST, [this]() { handleCommand(); });
+  server.on("/stream", HTTP_GET, [this]() { handleStream(); });
+  server.on("/export", HTTP_GET, [this]() { handleExport(); });
+  server.onNotFound([this]() { handleNotFound(); });
+
+  server.begin();
+  started = true;
+
+  DEBUG_PRINT("ApiServer: Listening on port ");
+  DEBUG_PRINTLN(API_SERVER_PORT);
+}
+
+void ApiServer::update() {
+  if (started) {
+    server.handleClient();
+  }
+}
+
+void ApiServer::setCommandCallback(ApiCommandCallback callback) {
+  commandCallback = callback;
+}
+
+void ApiServer::setEventStream(EventStream* eventStream) {
+  this->eventStream = eventStream;
+}
+
+void ApiServer::setHistoryExport(HistoryExport* historyExport, History* history) {
+  this->historyExport = historyExport;
+  this->history = history;
+}
+
+void ApiServer::handleStatus() {
+  refreshStatus();
+
+  server.sendHeader("ETag", statusEtag);
+  server.sendHeader("Cache-Control", "no-cache");
+
+  // Client already has this version - answer without a body
+  if (server.hasHeader("If-None-Match") && server.header("If-None-Match").indexOf(statusEtag) >= 0) {
+    server.send(304);
+    return;
+  }
+
+  server.send(200, "application/json", statusBuffer, statusLength);
+}
+
+void ApiServer::handleEvents() {
+  // Only return events newer than ?since=<sequence>
+  uint32_t since = 0;
+  if (server.hasArg("since")) {
+    since = (uint32_t)server.arg("since").toInt();
+  }
+
+  char line[80];
+  server.chunkedResponseModeStart(200, "application/json");
+
+  snprintf(line, sizeof(line), "{\"last\":%lu,\"events\":[", (unsigned long)eventLog->getLastSequence());
+  server.sendContent(line, strlen(line));
+
+  bool first = true;
+  TimerEvent event;
+  for (int i = 0; i < eventLog->getCount(); i++) {
+    if (!eventLog->getEvent(i, &event) || event.sequence <= since) {
+      continue;
+    }
+    snprintf(line, sizeof(line), "%s{\"seq\":%lu,\"timer\":\"%s\",\"ts\":%lu}",
+             first ? "" : ",",
+             (unsigned long)event.sequence,
+             EventLog::getTimerName(event.timer),
+             (unsigned long)event.timestamp);
+    server.sendContent(line, strlen(line));
+    first = false;
+  }
+
+  server.sendContent("]}", 2);
+  server.chunkedResponseFinalize();
+}
+
+void ApiServer::handleCommandList() {
+  server.send_P(200, "application/json", COMMAND_LIST_JSON);
+}
+
+void ApiServer::handleCommand() {
+  // Accept form field cmd=<command> or the raw request body
+  String command = server.hasArg("cmd") ? server.arg("cmd") : server.arg("plain");
+  command.trim();
+
+  if (command.length() == 0) {
+    server.send(400, "text/plain", "Missing command (use cmd=<command>)");
+    return;
+  }
+
+  if (commandCallback == nullptr) {
+    server.send(503, "text/plain", "Commands not available");
+    return;
+  }
+
+  String response;
+  if (commandCallback(command, response)) {
+    server.send(200, "text/plain", response);
+  } else {
+    server.send(400, "text/plain", response.length() > 0 ? response : String("Unknown command"));
+  }
+}
+
+void ApiServer::handleStream() {
+  if (eventStream == nullptr) {
+    handleNotFound();
+    return;
+  }
+
+  if (!eventStream->hasFreeSlot()) {
+    server.send(503, "text/plain", "Too many stream clients");
+    return;
+  }
+
+  // Unknown length keeps the server from closing the connection after the handler
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.sendContent_P(SSE_HEADERS);
+
+  WiFiClient client = server.client();
+  eventStream->addClient(client, timerManager);
+}
+
+void ApiServer::handleExport() {
+  if (historyExport == nullptr || history == nullptr || !history->isReady()) {
+    handleNotFound();
+    return;
+  }
+
+  time_t now = time(nullptr);
+  if (now < 1000000000) {
+    server.send(503, "text/plain", "Time not synced");
+    return;
+  }
+
+  if (historyExport->isBusy()) {
+    server.send(503, "text/plain", "Export already running");
+    return;
+  }
+
+  // Range defaults to the last HISTORY_EXPORT_DEFAULT_DAYS days
+  time_t from = server.hasArg("from") ? parseDate(server.arg("from"), false)
+                                      : now - (time_t)HISTORY_EXPORT_DEFAULT_DAYS * 86400;
+  time_t to = server.hasArg("to") ? parseDate(server.arg("to"), true) : now;
+  if (from == 0 || to == 0 || to < from) {
+    server.send(400, "text/plain", "Invalid range (use from/to=YYYY-MM-DD or Unix time)");
+    return;
+  }
+
+  ExportFormat format = EXPORT_CSV;
+  if (server.hasArg("format")) {
+    String value = server.arg("format");
+    if (value == "json") {
+      format = EXPORT_JSON;
+    } else if (value != "csv") {
+      server.send(400, "text/plain", "Invalid format (csv or json)");
+      return;
+    }
+  }
+
+  // Finest tier that still covers the start of the range unless one is asked for
+  HistoryTier tier = history->selectTier(from);
+  if (server.hasArg("tier")) {
+    String value = server.arg("tier");
+    if (value == "raw") {
+      tier = TIER_RAW;
+    } else if (value == "hourly") {
+      tier = TIER_HOURLY;
+    } else if (value == "daily") {
+      tier = TIER_DAILY;
+    } else if (value == "weekly") {
+      tier = TIER_WEEKLY;
+    } else {
+      server.send(400, "text/plain", "Invalid tier (raw, hourly, daily or weekly)");
+      return;
+    }
+  }
+
+  // Unknown length keeps the server from closing the connection after the handler;
+  // HistoryExport sends the headers and chunk framing itself from the main loop
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+
+  WiFiClient client = server.client();
+  historyExport->start(client, history, tier, format, from, to);
+}
+
+void ApiServer::handleNotFound() {
+  server.send(404, "text/plain", "Not found");
+}
+
+void ApiServer::refreshStatus() {
+  extern unsigned int activeYellowThreshold;
+  extern unsigned int activeRedThreshold;
+
+  unsigned long revision = timerManager->getRevision();
+  int alertLevel = LEDController::getAlertLevel(timerManager);
+  unsigned long commitsToday = storage->getCommitsToday();
+  bool timeSynced = timerManager->isTimeSynced();
+
+  // Nothing visible changed since the last build - keep serving the cached buffer
+  if (statusValid &&
+      revision == statusRevision &&
+      alertLevel == statusAlertLevel &&
+      activeYellowThreshold == statusYellowThreshold &&
+      activeRedThreshold == statusRedThreshold &&
+      commitsToday == statusCommitsToday &&
+      timeSynced == statusTimeSynced) {
+    return;
+  }
+
+  int length = snprintf(statusBuffer, sizeof(statusBuffer),
+    "{\"revision\":%lu,\"synced\":%s,"
+    "\"outside\":%lu,\"pee\":%lu,\"poop\":%lu,"
+    "\"alert\":\"%s\",\"yellowThreshold\":%u,\"redThreshold\":%u,"
+    "\"eepromCommitsToday\":%lu}",
+    revision,
+    timeSynced ? "true" : "false",
+    (unsigned long)timerManager->getTimestamp(TIMER_OUTSIDE),
+    (unsigned long)timerManager->getTimestamp(TIMER_PEE),
+    (unsigned long)timerManager->getTimestamp(TIMER_POOP),
+    LEDController::getAlertName((AlertLevel)alertLevel),
+    activeYellowThreshold,
+    activeRedThreshold,
+    commitsToday);
+
+  // snprintf returns the untruncated length
+  statusLength = min((size_t)max(length, 0), sizeof(statusBuffer) - 1);
+  snprintf(statusEtag, sizeof(statusEtag), "\"%08lx\"", (unsigned long)hashBuffer(statusBuffer, statusLength));
+
+  statusRevision = revision;
+  statusAlertLevel = alertLevel;
+  statusYellowThreshold = activeYellowThreshold;
+  statusRedThreshold = activeRedThreshold;
+  statusCommitsToday = commitsToday;
+  statusTimeSynced = timeSynced;
+  statusValid = true;
+
+  DEBUG_PRINT("ApiServer: Status rebuilt, ETag ");
+  DEBUG_PRINTLN(statusEtag);
+}
+
+time_t ApiServer::parseDate(const String& value, bool endOfDay) {
+  int year, month, day;
+  if (sscanf(value.c_str(), "%d-%d-%d", &year, &month, &day) == 3) {
+    if (year < 2000 || month < 1 || month > 12 || day < 1 || day > 31) {
+      return 0;
+    }
+    struct tm timeinfo;
+    memset(&timeinfo, 0, sizeof(timeinfo));
+    timeinfo.tm_year = year - 1900;
+    timeinfo.tm_mon = month - 1;
+    timeinfo.tm_mday = day;
+    timeinfo.tm_isdst = -1;
+    time_t midnight = mktime(&timeinfo);
+    return endOfDay ? midnight + 86399 : midnight;
+  }
+
+  long timestamp = value.toInt();
+  return timestamp >= 1000000000 ? (time_t)timestamp : 0;
+}
+
+uint32_t ApiServer::hashBuffer(const char* buffer, size_t length) {
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (uint8_t)buffer[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
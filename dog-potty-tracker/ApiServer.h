@@ -0,0 +1,80 @@
+#ifndef API_SERVER_H
+#define API_SERVER_H
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include "config.h"
+#include "TimerManager.h"
+#include "EventLog.h"
+#include "Storage.h"
+#include "EventStream.h"
+#include "History.h"
+#include "HistoryExport.h"
+#include "LEDController.h"
+
+// Callback type for executing commands received over HTTP
+// Returns true if the command was recognized, response holds the reply text
+typedef bool (*ApiCommandCallback)(String command, String& response);
+
+class ApiServer {
+public:
+  ApiServer();
+
+  // Start HTTP server
+  void begin(TimerManager* timerManager, EventLog* eventLog, Storage* storage);
+
+  // Handle pending HTTP requests (call every loop iteration)
+  void update();
+
+  // Set callback for POST /commands
+  void setCommandCallback(ApiCommandCallback callback);
+
+  // Enable GET /stream (Server-Sent Events)
+  void setEventStream(EventStream* eventStream);
+
+  // Enable GET /export (history as chunked CSV or JSON)
+  void setHistoryExport(HistoryExport* historyExport, History* history);
+
+private:
+  ESP8266WebServer server;
+  TimerManager* timerManager;
+  EventLog* eventLog;
+  Storage* storage;
+  EventStream* eventStream;
+  HistoryExport* historyExport;
+  History* history;
+  ApiCommandCallback commandCallback;
+  bool started;
+
+  // Preformatted /status response, rebuilt only when its inputs change
+  char statusBuffer[API_STATUS_BUFFER_SIZE];
+  size_t statusLength;
+  char statusEtag[12];
+  unsigned long statusRevision;
+  int statusAlertLevel;
+  unsigned int statusYellowThreshold;
+  unsigned int statusRedThreshold;
+  unsigned long statusCommitsToday;
+  bool statusTimeSynced;
+  bool statusValid;
+
+  // Request handlers
+  void handleStatus();
+  void handleEvents();
+  void handleCommandList();
+  void handleCommand();
+  void handleStream();
+  void handleExport();
+  void handleNotFound();
+
+  // Rebuild status JSON if timer state, alert level or thresholds changed
+  void refreshStatus();
+
+  // Parse YYYY-MM-DD (local midnight, or last second of the day) or a Unix timestamp; 0 if invalid
+  time_t parseDate(const String& value, bool endOfDay);
+
+  // FNV-1a hash used for the ETag
+  uint32_t hashBuffer(const char* buffer, size_t length);
+};
+
+#endif
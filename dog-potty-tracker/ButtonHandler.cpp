@@ -57,6 +57,15 @@ void ButtonHandler::checkButton(Button button) {
   lastButtonState[button] = reading;
 }
 
+bool ButtonHandler::isSettling() {
+  for (int i = 0; i < 3; i++) {
+    if (lastButtonState[i] != buttonState[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool ButtonHandler::isPressed(uint8_t pin) {
   // Buttons are active HIGH (pressed = HIGH, released = LOW)
   return digitalRead(pin) == HIGH;
@@ -26,6 +26,9 @@ public:
   // Set callback for button press
   void setCallback(Button button, ButtonCallback callback);
 
+  // Check if any button is bouncing or waiting out the debounce delay (needs polling)
+  bool isSettling();
+
 private:
   // Button state tracking
   bool buttonState[3];
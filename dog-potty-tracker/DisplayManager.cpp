@@ -1,97 +1,199 @@
 #include "DisplayManager.h"
 
 DisplayManager::DisplayManager() :
-  display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET),
+  display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET, OLED_I2C_CLOCK, OLED_I2C_CLOCK),
   currentView(VIEW_ELAPSED),
   lastViewSwitch(0),
   feedbackUntil(0),
   showingFeedback(false),
-  nightMode(false),
-  displayOn(true),
-  displayMode(2),  // Default to cycle mode
-  cycleInterval(5000),  // Default to 5 seconds
-  currentTimer(0)  // Start with first timer (Outside)
+  powerState(POWER_ON),
+  nightHours(false),
+  lastActivity(0),
+  stats(nullptr),
+  currentTimer(0),  // Start with first timer (Outside)
+  renderPending(true),
+  lastTimeSynced(false),
+  nextRenderAt(0),
+  renderCount(0),
+  renderCountLogged(0),
+  lastRenderLog(0),
+  dirtyPages(0),
+  flushPage(0),
+  flushColumn(0),
+  chunkMicros(0),
+  frameStart(0)
 {
+  for (int i = 0; i < labelCacheCount; i++) {
+    labelCached[i] = false;
+  }
+  for (int i = 0; i < SCREEN_HEIGHT / 8; i++) {
+    pageHashes[i] = 0;
+  }
 }
 
 bool DisplayManager::begin() {
   // Initialize I2C with custom pins
   Wire.begin(PIN_OLED_SDA, PIN_OLED_SCL);
 
-  Serial.println("DisplayManager: Initializing I2C...");
-  Serial.print("DisplayManager: SDA=GPIO");
+  Serial.println(F("DisplayManager: Initializing I2C..."));
+  Serial.print(F("DisplayManager: SDA=GPIO"));
   Serial.print(PIN_OLED_SDA);
-  Serial.print(", SCL=GPIO");
+  Serial.print(F(", SCL=GPIO"));
   Serial.println(PIN_OLED_SCL);
 
   // Scan I2C bus to find devices
-  Serial.println("DisplayManager: Scanning I2C bus...");
+  Serial.println(F("DisplayManager: Scanning I2C bus..."));
   byte error, address;
   int nDevices = 0;
   for(address = 1; address < 127; address++) {
     Wire.beginTransmission(address);
     error = Wire.endTransmission();
     if (error == 0) {
-      Serial.print("DisplayManager: I2C device found at 0x");
-      if (address < 16) Serial.print("0");
+      Serial.print(F("DisplayManager: I2C device found at 0x"));
+      if (address < 16) Serial.print(F("0"));
       Serial.println(address, HEX);
       nDevices++;
     }
   }
   if (nDevices == 0) {
-    Serial.println("DisplayManager: No I2C devices found!");
+    Serial.println(F("DisplayManager: No I2C devices found!"));
   } else {
-    Serial.print("DisplayManager: Found ");
+    Serial.print(F("DisplayManager: Found "));
     Serial.print(nDevices);
-    Serial.println(" I2C device(s)");
+    Serial.println(F(" I2C device(s)"));
   }
 
-  Serial.print("DisplayManager: Trying I2C address 0x");
+  Serial.print(F("DisplayManager: Trying I2C address 0x"));
   Serial.println(OLED_ADDRESS, HEX);
 
   // Initialize display
   if (!display.begin(SSD1306_SWITCHCAPVCC, OLED_ADDRESS)) {
-    Serial.println("DisplayManager: SSD1306 allocation FAILED!");
-    Serial.println("DisplayManager: Check wiring and I2C address");
-    Serial.println("DisplayManager: Try changing OLED_ADDRESS in config.h to 0x3D");
+    Serial.println(F("DisplayManager: SSD1306 allocation FAILED!"));
+    Serial.println(F("DisplayManager: Check wiring and I2C address"));
+    Serial.println(F("DisplayManager: Try changing OLED_ADDRESS in config.h to 0x3D"));
     return false;
   }
 
   // Rotate display 180 degrees
   display.setRotation(2);
 
-  Serial.println("DisplayManager: Display initialized successfully!");
+  Serial.println(F("DisplayManager: Display initialized successfully!"));
+
+  // Frames are sent with our own page transfers in fast mode
+  Wire.setClock(OLED_I2C_CLOCK);
 
-  // Clear display
+  // Clear display (also measures how long a transfer takes)
   display.clearDisplay();
-  display.display();
+  flushNow();
+
+  // Start the view/timer rotation now
+  lastViewSwitch = millis();
+  DEBUG_PRINT(F("DisplayManager: Mode "));
+  DEBUG_PRINT(displayMode);
+  DEBUG_PRINT(F(", cycle "));
+  DEBUG_PRINT(cycleInterval);
+  DEBUG_PRINTLN(F(" ms"));
 
   return true;
 }
 
-void DisplayManager::setDisplayMode(int mode, float cycleSeconds) {
-  displayMode = mode;
-  cycleInterval = (unsigned long)(cycleSeconds * 1000.0);  // Convert seconds to milliseconds
-
-  // Set initial view based on mode
-  if (displayMode == 0) {
-    currentView = VIEW_ELAPSED;
-  } else if (displayMode == 1) {
-    currentView = VIEW_TIMESTAMP;
-  } else if (displayMode == 3) {
-    // Mode 3: Initialize the timer rotation
-    currentTimer = 0;
-    lastViewSwitch = millis();  // Start the cycle timer now
-  }
-
-  DEBUG_PRINT("Display mode set to: ");
-  DEBUG_PRINTLN(displayMode);
-  DEBUG_PRINT("Cycle interval: ");
-  DEBUG_PRINT(cycleSeconds);
-  DEBUG_PRINTLN(" seconds");
+void DisplayManager::setStats(PottyStats* stats) {
+  this->stats = stats;
 }
 
 void DisplayManager::update(TimerManager* timerManager, bool timeSynced) {
+  updatePower();
+
+  // Blanked - no rendering and no I2C traffic until the next wake()
+  if (powerState == POWER_BLANKED) {
+    return;
+  }
+
+  // Previous frame still going out - keep sending it and leave the buffer alone
+  if (dirtyPages != 0) {
+    flushStep();
+    return;
+  }
+
+  if (millis() - lastRenderLog >= DISPLAY_RENDER_LOG_INTERVAL) {
+    DEBUG_PRINT(F("DisplayManager: "));
+    DEBUG_PRINT(renderCount - renderCountLogged);
+    DEBUG_PRINT(F(" renders in the last "));
+    DEBUG_PRINT((millis() - lastRenderLog) / 1000);
+    DEBUG_PRINTLN(F(" s"));
+    renderCountLogged = renderCount;
+    lastRenderLog = millis();
+  }
+
+  // Time sync changes what can be shown (timestamps, clock)
+  if (timeSynced != lastTimeSynced) {
+    lastTimeSynced = timeSynced;
+    renderPending = true;
+  }
+
+  // Nothing on screen can have changed yet
+  if (!renderPending && (long)(millis() - nextRenderAt) < 0) {
+    return;
+  }
+
+  renderPending = false;
+  render(timerManager, timeSynced);
+  scheduleNextRender(timerManager, timeSynced);
+}
+
+void DisplayManager::invalidate() {
+  renderPending = true;
+}
+
+unsigned long DisplayManager::getRenderCount() {
+  return renderCount;
+}
+
+unsigned long DisplayManager::getIdleTime() {
+  // Blanked panels only come back through wake() (called from the loop)
+  if (powerState == POWER_BLANKED) {
+    return 0xFFFFFFFF;
+  }
+  if (dirtyPages != 0 || renderPending) {
+    return 0;
+  }
+  long wait = (long)(nextRenderAt - millis());
+  return wait > 0 ? (unsigned long)wait : 0;
+}
+
+void DisplayManager::scheduleNextRender(TimerManager* timerManager, bool timeSynced) {
+  unsigned long now = millis();
+  unsigned long wait = 60000;
+
+  // Elapsed times tick over a whole minute after each timer's start (seconds are
+  // whole, so this never wakes before the change, at most a second after it)
+  for (int i = 0; i < 3; i++) {
+    unsigned long elapsed = timerManager->getElapsed((Timer)i);
+    wait = min(wait, (60 - elapsed % 60) * 1000UL);
+  }
+
+  // Clock and "today" figures change on the wall-clock minute
+  if (timeSynced) {
+    wait = min(wait, (unsigned long)(60 - time(nullptr) % 60) * 1000UL);
+  }
+
+  // Next view rotation (modes 2 and 3)
+  if constexpr (displayMode == 2 || displayMode == 3) {
+    if (displayMode == 3 || timeSynced) {
+      unsigned long sinceSwitch = now - lastViewSwitch;
+      wait = min(wait, sinceSwitch >= cycleInterval ? 0UL : cycleInterval - sinceSwitch);
+    }
+  }
+
+  // Feedback message ends (update() compares with >)
+  if (showingFeedback) {
+    wait = min(wait, (long)(feedbackUntil - now) >= 0 ? feedbackUntil - now + 1 : 0UL);
+  }
+
+  nextRenderAt = now + wait;
+}
+
+void DisplayManager::render(TimerManager* timerManager, bool timeSynced) {
   // Check if we should stop showing feedback
   if (showingFeedback && millis() > feedbackUntil) {
     showingFeedback = false;
@@ -100,65 +202,72 @@ void DisplayManager::update(TimerManager* timerManager, bool timeSynced) {
   // If showing feedback, render that instead
   if (showingFeedback) {
     renderFeedback();
-    return;
-  }
-
-  // Don't update display if in night mode and display is off
-  if (nightMode && !displayOn) {
+    renderCount++;
     return;
   }
 
   // Rotate view every VIEW_ROTATION_INTERVAL
   rotateView(timeSynced);
 
+  renderCount++;
+
   // Render current view based on display mode
-  if (displayMode == 3) {
+  if constexpr (displayMode == 3) {
     // Mode 3: Show single timer with large text
     renderSingleTimerView(timerManager, currentTimer);
-  } else if (currentView == VIEW_ELAPSED || !timeSynced) {
+  } else if constexpr (displayMode == 0) {
     renderElapsedView(timerManager);
+  } else if constexpr (displayMode == 1) {
+    // Timestamps need time sync - fall back to elapsed
+    if (timeSynced) {
+      renderTimestampView(timerManager);
+    } else {
+      renderElapsedView(timerManager);
+    }
   } else {
-    renderTimestampView(timerManager);
+    if (currentView == VIEW_ELAPSED || !timeSynced) {
+      renderElapsedView(timerManager);
+    } else if (currentView == VIEW_STATS) {
+      renderStatsView();
+    } else {
+      renderTimestampView(timerManager);
+    }
   }
 }
 
 void DisplayManager::rotateView(bool timeSynced) {
-  // Handle fixed display modes (0 = elapsed only, 1 = timestamps only)
-  if (displayMode == 0) {
-    currentView = VIEW_ELAPSED;
-    return;
-  } else if (displayMode == 1) {
-    // Timestamps mode requires time sync
-    if (!timeSynced) {
-      currentView = VIEW_ELAPSED;  // Fall back to elapsed if no time sync
-    } else {
-      currentView = VIEW_TIMESTAMP;
-    }
+  // Fixed display modes (0 = elapsed only, 1 = timestamps only) have nothing to rotate
+  if constexpr (displayMode == 0 || displayMode == 1) {
     return;
-  } else if (displayMode == 3) {
+  } else if constexpr (displayMode == 3) {
     // Mode 3: Rotate through individual timers
     if (millis() - lastViewSwitch >= cycleInterval) {
       currentTimer = (currentTimer + 1) % 3;  // Cycle through 0, 1, 2 (Outside, Pee, Poop)
       lastViewSwitch = millis();
-      DEBUG_PRINT("Timer switched to: ");
-      DEBUG_PRINTLN(currentTimer == 0 ? "OUTSIDE" : (currentTimer == 1 ? "PEE" : "POOP"));
+      DEBUG_PRINT(F("Timer switched to: "));
+      DEBUG_PRINTLN(currentTimer == 0 ? F("OUTSIDE") : (currentTimer == 1 ? F("PEE") : F("POOP")));
+    }
+  } else {
+    // Mode 2: Cycle between views
+    // Only rotate if time is synced (otherwise always show elapsed)
+    if (!timeSynced) {
+      currentView = VIEW_ELAPSED;
+      return;
     }
-    return;
-  }
-
-  // Mode 2: Cycle between views
-  // Only rotate if time is synced (otherwise always show elapsed)
-  if (!timeSynced) {
-    currentView = VIEW_ELAPSED;
-    return;
-  }
 
-  if (millis() - lastViewSwitch >= cycleInterval) {
-    // Toggle view
-    currentView = (currentView == VIEW_ELAPSED) ? VIEW_TIMESTAMP : VIEW_ELAPSED;
-    lastViewSwitch = millis();
-    DEBUG_PRINT("View switched to: ");
-    DEBUG_PRINTLN(currentView == VIEW_ELAPSED ? "ELAPSED" : "TIMESTAMP");
+    if (millis() - lastViewSwitch >= cycleInterval) {
+      // Next view (elapsed -> timestamps -> stats if enabled -> elapsed)
+      if (currentView == VIEW_ELAPSED) {
+        currentView = VIEW_TIMESTAMP;
+      } else if (currentView == VIEW_TIMESTAMP && stats != nullptr) {
+        currentView = VIEW_STATS;
+      } else {
+        currentView = VIEW_ELAPSED;
+      }
+      lastViewSwitch = millis();
+      DEBUG_PRINT(F("View switched to: "));
+      DEBUG_PRINTLN(currentView == VIEW_ELAPSED ? F("ELAPSED") : (currentView == VIEW_TIMESTAMP ? F("TIMESTAMP") : F("STATS")));
+    }
   }
 }
 
@@ -169,24 +278,24 @@ void DisplayManager::renderElapsedView(TimerManager* timerManager) {
 
   // Line 1: Outside timer (Yellow section - top 16px)
   display.setCursor(0, 0);
-  display.print("OUT: ");
+  display.print(F("OUT: "));
   display.print(timerManager->getElapsedFormatted(TIMER_OUTSIDE));
 
   // Line 2: Pee timer
   display.setCursor(0, 16);
-  display.print("PEE: ");
+  display.print(F("PEE: "));
   display.print(timerManager->getElapsedFormatted(TIMER_PEE));
 
   // Line 3: Poop timer (Blue section - bottom 48px)
   display.setCursor(0, 32);
-  display.print("POO: ");
+  display.print(F("POO: "));
   display.print(timerManager->getElapsedFormatted(TIMER_POOP));
 
   // Line 4: Current time or status
   display.setCursor(0, 48);
   display.print(getCurrentTimeString());
 
-  display.display();
+  commitFrame();
 }
 
 void DisplayManager::renderTimestampView(TimerManager* timerManager) {
@@ -196,24 +305,24 @@ void DisplayManager::renderTimestampView(TimerManager* timerManager) {
 
   // Line 1: Outside timestamp (Yellow section)
   display.setCursor(0, 0);
-  display.print("OUT: ");
+  display.print(F("OUT: "));
   display.print(timerManager->getTimestampFormatted(TIMER_OUTSIDE));
 
   // Line 2: Pee timestamp
   display.setCursor(0, 16);
-  display.print("PEE: ");
+  display.print(F("PEE: "));
   display.print(timerManager->getTimestampFormatted(TIMER_PEE));
 
   // Line 3: Poop timestamp (Blue section)
   display.setCursor(0, 32);
-  display.print("POO: ");
+  display.print(F("POO: "));
   display.print(timerManager->getTimestampFormatted(TIMER_POOP));
 
   // Line 4: Current time
   display.setCursor(0, 48);
   display.print(getCurrentTimeString());
 
-  display.display();
+  commitFrame();
 }
 
 void DisplayManager::renderSingleTimerView(TimerManager* timerManager, int timerIndex) {
@@ -222,52 +331,250 @@ void DisplayManager::renderSingleTimerView(TimerManager* timerManager, int timer
 
   // Determine which timer to show
   Timer timer;
-  const char* label;
+  const __FlashStringHelper* label;
 
   switch(timerIndex) {
     case 0:
+    default:
+      timerIndex = 0;
       timer = TIMER_OUTSIDE;
-      label = "OUTSIDE";
+      label = F("OUTSIDE");
       break;
     case 1:
       timer = TIMER_PEE;
-      label = "PEE";
+      label = F("PEE");
       break;
     case 2:
       timer = TIMER_POOP;
-      label = "POOP";
-      break;
-    default:
-      timer = TIMER_OUTSIDE;
-      label = "OUTSIDE";
+      label = F("POOP");
       break;
   }
 
   // Line 1: Timer label (size 1 - keep small so elapsed time can be huge)
+  drawCachedLabel(timerIndex, label);
+
+  // Elapsed time without " ago", same format as TimerManager::formatElapsed
+  char elapsed[16];
+  unsigned long minutes = timerManager->getElapsed(timer) / 60;
+  snprintf_P(elapsed, sizeof(elapsed), PSTR("%luh %02lum"), minutes / 60, minutes % 60);
+
+  // Line 2: Elapsed time (24 px flash font, centered, pages 2-4 - EXTRA LARGE for easy reading from distance)
+  int x = max(0, (SCREEN_WIDTH - LargeFont::measure(elapsed)) / 2);
+  LargeFont::draw(display.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT, x, 2, elapsed, display.getRotation() == 2);
+
+  // Line 3: Timestamp (size 1 - small)
+  display.setTextSize(1);
+  display.setCursor(0, 56);
+  display.print(F("At: "));
+  display.print(timerManager->getTimestampFormatted(timer));
+
+  commitFrame();
+}
+
+void DisplayManager::drawCachedLabel(int timerIndex, const __FlashStringHelper* label) {
+  uint8_t* buffer = display.getBuffer();
+  bool rotated = display.getRotation() == 2;
+
+  if (labelCached[timerIndex]) {
+    for (int x = 0; x < LABEL_CACHE_WIDTH; x++) {
+      buffer[LargeFont::bufferIndex(SCREEN_WIDTH, SCREEN_HEIGHT, x, 0, rotated)] = labelCache[timerIndex][x];
+    }
+    return;
+  }
+
+  // First use - draw with the GFX font and keep the resulting bytes
   display.setTextSize(1);
   display.setCursor(0, 0);
   display.print(label);
+  for (int x = 0; x < LABEL_CACHE_WIDTH; x++) {
+    labelCache[timerIndex][x] = buffer[LargeFont::bufferIndex(SCREEN_WIDTH, SCREEN_HEIGHT, x, 0, rotated)];
+  }
+  labelCached[timerIndex] = true;
+}
 
-  // Get elapsed time string and remove " ago" suffix (last 4 characters)
-  String elapsed = timerManager->getElapsedFormatted(timer);
+void DisplayManager::commitFrame() {
+  uint8_t* buffer = display.getBuffer();
 
-  // Remove " ago" by truncating the string (remove last 4 characters)
-  if (elapsed.endsWith(" ago")) {
-    elapsed = elapsed.substring(0, elapsed.length() - 4);
+  // Only pages whose content changed since the last frame are sent
+  for (int page = 0; page < SCREEN_HEIGHT / 8; page++) {
+    uint32_t hash = hashPage(buffer + page * SCREEN_WIDTH);
+    if (hash != pageHashes[page]) {
+      pageHashes[page] = hash;
+      dirtyPages |= 1 << page;
+    }
   }
 
-  // Line 2: Elapsed time (size 3 - EXTRA LARGE for easy reading from distance)
-  display.setTextSize(3);
-  display.setCursor(0, 12);
-  display.print(elapsed);
+  if (dirtyPages == 0) {
+    return;
+  }
 
-  // Line 3: Timestamp (size 1 - small)
+  flushPage = 0;
+  flushColumn = 0;
+  frameStart = millis();
+  flushStep();
+}
+
+bool DisplayManager::flushStep() {
+  uint8_t* buffer = display.getBuffer();
+  unsigned long start = micros();
+
+  // Always send one chunk; more only while the next one still fits the budget
+  do {
+    if (flushColumn == 0) {
+      while (!(dirtyPages & (1 << flushPage))) {
+        flushPage++;
+      }
+      setPageAddress(flushPage);
+    }
+
+    sendData(buffer + flushPage * SCREEN_WIDTH + flushColumn, OLED_FLUSH_CHUNK);
+    flushColumn += OLED_FLUSH_CHUNK;
+    if (flushColumn >= SCREEN_WIDTH) {
+      dirtyPages &= ~(1 << flushPage);
+      flushPage++;
+      flushColumn = 0;
+    }
+  } while (dirtyPages != 0 && micros() - start + chunkMicros <= OLED_FLUSH_BUDGET_US);
+
+  if (dirtyPages != 0) {
+    return false;
+  }
+
+  onFrameComplete();
+  return true;
+}
+
+void DisplayManager::flushNow() {
+  uint8_t* buffer = display.getBuffer();
+  int transfers = 0;
+  unsigned long start = micros();
+
+  for (int page = 0; page < SCREEN_HEIGHT / 8; page++) {
+    pageHashes[page] = hashPage(buffer + page * SCREEN_WIDTH);
+    setPageAddress(page);
+    for (int column = 0; column < SCREEN_WIDTH; column += OLED_FLUSH_CHUNK) {
+      sendData(buffer + page * SCREEN_WIDTH + column, OLED_FLUSH_CHUNK);
+      transfers++;
+    }
+  }
+
+  unsigned long elapsed = max(micros() - start, 1UL);
+  dirtyPages = 0;
+  flushPage = 0;
+  flushColumn = 0;
+
+  // Per data transfer, including its share of the page addressing
+  chunkMicros = elapsed / transfers;
+
+  // 9 clocks per byte: address byte + 7 addressing bytes per page, address + control + data per transfer
+  unsigned long clocks = 9UL * ((SCREEN_HEIGHT / 8) * 8UL + transfers * (2UL + OLED_FLUSH_CHUNK));
+  unsigned long effectiveKHz = clocks * 1000UL / elapsed;
+  DEBUG_PRINT(F("DisplayManager: Frame sent in "));
+  DEBUG_PRINT(elapsed);
+  DEBUG_PRINT(F(" us, "));
+  DEBUG_PRINT(chunkMicros);
+  DEBUG_PRINT(F(" us per chunk (~"));
+  DEBUG_PRINT(effectiveKHz);
+  DEBUG_PRINTLN(F(" kHz)"));
+  if (effectiveKHz < OLED_I2C_CLOCK / 2000) {
+    DEBUG_PRINTLN(F("DisplayManager: I2C much slower than configured - check pull-ups and wiring"));
+  }
+}
+
+void DisplayManager::onFrameComplete() {
+  flushPage = 0;
+  flushColumn = 0;
+
+  DEBUG_PRINT(F("DisplayManager: Frame complete in "));
+  DEBUG_PRINT(millis() - frameStart);
+  DEBUG_PRINTLN(F(" ms"));
+}
+
+void DisplayManager::setPageAddress(uint8_t page) {
+  // Control byte 0x00: a stream of commands follows
+  const uint8_t commands[] = {
+    0x00,
+    SSD1306_COLUMNADDR, 0, SCREEN_WIDTH - 1,
+    SSD1306_PAGEADDR, page, page
+  };
+  Wire.beginTransmission(OLED_ADDRESS);
+  Wire.write(commands, sizeof(commands));
+  Wire.endTransmission();
+}
+
+void DisplayManager::sendData(const uint8_t* data, uint8_t length) {
+  // Control byte 0x40: display data follows (written at the RAM pointer, which auto-increments)
+  Wire.beginTransmission(OLED_ADDRESS);
+  Wire.write((uint8_t)0x40);
+  Wire.write(data, length);
+  Wire.endTransmission();
+}
+
+uint32_t DisplayManager::hashPage(const uint8_t* data) {
+  // FNV-1a
+  uint32_t hash = 2166136261UL;
+  for (int i = 0; i < SCREEN_WIDTH; i++) {
+    hash ^= data[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+void DisplayManager::renderStatsView() {
+  char mean[12];
+  char ewma[12];
+
+  display.clearDisplay();
   display.setTextSize(1);
-  display.setCursor(0, 56);
-  display.print("At: ");
-  display.print(timerManager->getTimestampFormatted(timer));
+  display.setTextColor(SSD1306_WHITE);
+
+  // Line 1: Pee average interval and recent trend (Yellow section)
+  display.setCursor(0, 0);
+  if (stats->getIntervalCount(TIMER_PEE) > 0) {
+    PottyStats::formatDuration(stats->getMean(TIMER_PEE), mean, sizeof(mean));
+    PottyStats::formatDuration(stats->getEwma(TIMER_PEE), ewma, sizeof(ewma));
+    display.print(F("PEE avg "));
+    display.print(mean);
+    display.print(F(" ~"));
+    display.print(ewma);
+  } else {
+    display.print(F("PEE avg --"));
+  }
+
+  // Line 2: Poop average interval and recent trend
+  display.setCursor(0, 16);
+  if (stats->getIntervalCount(TIMER_POOP) > 0) {
+    PottyStats::formatDuration(stats->getMean(TIMER_POOP), mean, sizeof(mean));
+    PottyStats::formatDuration(stats->getEwma(TIMER_POOP), ewma, sizeof(ewma));
+    display.print(F("POO avg "));
+    display.print(mean);
+    display.print(F(" ~"));
+    display.print(ewma);
+  } else {
+    display.print(F("POO avg --"));
+  }
 
-  display.display();
+  // Line 3: Today's counts
+  display.setCursor(0, 32);
+  display.print(F("Today: "));
+  display.print(stats->getDailyCount(TIMER_PEE, 0));
+  display.print(F(" pee "));
+  display.print(stats->getDailyCount(TIMER_POOP, 0));
+  display.print(F(" poo"));
+
+  // Line 4: Busiest hour for pee
+  display.setCursor(0, 48);
+  int peak = stats->getPeakHour(TIMER_PEE);
+  if (peak >= 0) {
+    int hour = peak % 12 == 0 ? 12 : peak % 12;
+    display.print(F("Peak pee: "));
+    display.print(hour);
+    display.print(peak >= 12 ? F(" PM") : F(" AM"));
+  } else {
+    display.print(F("Peak pee: --"));
+  }
+
+  commitFrame();
 }
 
 void DisplayManager::renderFeedback() {
@@ -286,7 +593,7 @@ void DisplayManager::renderFeedback() {
   display.setCursor(x, y);
   display.print(feedbackMessage);
 
-  display.display();
+  commitFrame();
 }
 
 String DisplayManager::getCurrentTimeString() {
@@ -294,7 +601,7 @@ String DisplayManager::getCurrentTimeString() {
 
   // Check if time is synced
   if (now < 1000000000) {
-    return "No WiFi";
+    return F("No WiFi");
   }
 
   struct tm* timeinfo = localtime(&now);
@@ -306,8 +613,8 @@ String DisplayManager::getCurrentTimeString() {
   if (hour == 0) hour = 12;
 
   char buffer[10];
-  snprintf(buffer, sizeof(buffer), "%d:%02d %s",
-           hour, timeinfo->tm_min, isPM ? "PM" : "AM");
+  snprintf_P(buffer, sizeof(buffer), isPM ? PSTR("%d:%02d PM") : PSTR("%d:%02d AM"),
+             hour, timeinfo->tm_min);
 
   return String(buffer);
 }
@@ -318,53 +625,86 @@ void DisplayManager::showStartup() {
   display.setTextColor(SSD1306_WHITE);
 
   display.setCursor(0, 0);
-  display.println("Dog Potty");
-  display.println("Tracker");
+  display.println(F("Dog Potty"));
+  display.println(F("Tracker"));
 
   display.setTextSize(1);
   display.setCursor(0, 48);
-  display.print("Starting...");
+  display.print(F("Starting..."));
 
-  display.display();
+  flushNow();
   delay(2000);
 }
 
+void DisplayManager::showFeedback(const __FlashStringHelper* message, unsigned long duration) {
+  feedbackMessage = message;
+  feedbackUntil = millis() + duration;
+  showingFeedback = true;
+  renderPending = true;
+  DEBUG_PRINT(F("Feedback: "));
+  DEBUG_PRINTLN(message);
+}
+
 void DisplayManager::showFeedback(const char* message, unsigned long duration) {
-  feedbackMessage = String(message);
+  feedbackMessage = message;
   feedbackUntil = millis() + duration;
   showingFeedback = true;
-  DEBUG_PRINT("Feedback: ");
+  renderPending = true;
+  DEBUG_PRINT(F("Feedback: "));
   DEBUG_PRINTLN(message);
 }
 
-void DisplayManager::setNightMode(bool enabled) {
-  // Only change state and log if actually changing
-  if (nightMode != enabled) {
-    nightMode = enabled;
-    if (enabled && displayOn) {
-      // Entering night mode - turn display off
-      display.ssd1306_command(SSD1306_DISPLAYOFF);
-      displayOn = false;
-      DEBUG_PRINTLN("Display: Night mode ON");
-    } else if (!enabled) {
-      // Exiting night mode - always turn display on
-      display.ssd1306_command(SSD1306_DISPLAYON);
-      displayOn = true;
-      DEBUG_PRINTLN("Display: Night mode OFF");
-    }
-  } else {
-    nightMode = enabled;
+void DisplayManager::setNightHours(bool night) {
+  // Morning - show the display again without waiting for a button press
+  if (nightHours && !night) {
+    nightHours = night;
+    wake();
+    return;
   }
+  nightHours = night;
 }
 
-void DisplayManager::setDisplayOn(bool on) {
-  if (on && !displayOn) {
-    display.ssd1306_command(SSD1306_DISPLAYON);
-    displayOn = true;
-    DEBUG_PRINTLN("Display: ON");
-  } else if (!on && displayOn) {
+void DisplayManager::wake() {
+  lastActivity = millis();
+  if (powerState != POWER_ON) {
+    setPower(POWER_ON);
+  }
+}
+
+void DisplayManager::updatePower() {
+  unsigned long idle = millis() - lastActivity;
+
+  DisplayPower target = POWER_ON;
+  if (nightHours) {
+    target = idle >= NIGHT_MODE_WAKE_DURATION ? POWER_BLANKED : POWER_ON;
+  } else if (DISPLAY_BLANK_TIMEOUT > 0 && idle >= DISPLAY_BLANK_TIMEOUT) {
+    target = POWER_BLANKED;
+  } else if (DISPLAY_DIM_TIMEOUT > 0 && idle >= DISPLAY_DIM_TIMEOUT) {
+    target = POWER_DIMMED;
+  }
+
+  // Only activity brightens the panel again (not e.g. the end of night hours)
+  if (target > powerState) {
+    setPower(target);
+  }
+}
+
+void DisplayManager::setPower(DisplayPower state) {
+  if (state == POWER_BLANKED) {
     display.ssd1306_command(SSD1306_DISPLAYOFF);
-    displayOn = false;
-    DEBUG_PRINTLN("Display: OFF");
+    DEBUG_PRINTLN(F("Display: Blanked"));
+  } else {
+    display.ssd1306_command(SSD1306_SETCONTRAST);
+    display.ssd1306_command(state == POWER_DIMMED ? DISPLAY_CONTRAST_DIM : DISPLAY_CONTRAST_NORMAL);
+    if (powerState == POWER_BLANKED) {
+      display.ssd1306_command(SSD1306_DISPLAYON);
+    }
+    DEBUG_PRINTLN(state == POWER_DIMMED ? F("Display: Dimmed") : F("Display: On"));
+  }
+
+  // Coming back from blank - the panel still holds the last frame, draw the current one now
+  if (state != POWER_BLANKED && powerState == POWER_BLANKED) {
+    renderPending = true;
   }
+  powerState = state;
 }
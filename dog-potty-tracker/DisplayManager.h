@@ -5,11 +5,23 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include "config.h"
+#include "FlashStrings.h"
 #include "TimerManager.h"
+#include "PottyStats.h"
+#include "LargeFont.h"
+
+#define LABEL_CACHE_WIDTH 48  // Columns of a cached size-1 label (8 characters)
+
+enum DisplayPower {
+  POWER_ON = 0,
+  POWER_DIMMED = 1,
+  POWER_BLANKED = 2
+};
 
 enum DisplayView {
   VIEW_ELAPSED = 0,
-  VIEW_TIMESTAMP = 1
+  VIEW_TIMESTAMP = 1,
+  VIEW_STATS = 2
 };
 
 class DisplayManager {
@@ -19,23 +31,33 @@ public:
   // Initialize display
   bool begin();
 
-  // Set display mode configuration
-  void setDisplayMode(int mode, float cycleSeconds);
+  // Add a statistics page to the cycle (mode 2)
+  void setStats(PottyStats* stats);
 
-  // Update display (handles view rotation)
+  // Update display (handles view rotation; only renders when the content is due to change)
   void update(TimerManager* timerManager, bool timeSynced);
 
+  // Render on the next update (e.g. a timer was reset)
+  void invalidate();
+
+  // Frames rendered since startup
+  unsigned long getRenderCount();
+
+  // Time until update() has something to do (0 = a frame is pending or still being sent)
+  unsigned long getIdleTime();
+
   // Show startup message
   void showStartup();
 
-  // Show button feedback message
+  // Show button feedback message (F("...") for fixed text)
+  void showFeedback(const __FlashStringHelper* message, unsigned long duration = 2000);
   void showFeedback(const char* message, unsigned long duration = 2000);
 
-  // Set night mode (display off)
-  void setNightMode(bool enabled);
+  // Set whether it is night (the panel blanks soon after the last activity)
+  void setNightHours(bool night);
 
-  // Turn display on/off
-  void setDisplayOn(bool on);
+  // Button press or alert - full brightness and a fresh frame right away
+  void wake();
 
 private:
   Adafruit_SSD1306 display;
@@ -43,21 +65,83 @@ private:
   unsigned long lastViewSwitch;
   unsigned long feedbackUntil;
   bool showingFeedback;
-  bool nightMode;
-  bool displayOn;
+  DisplayPower powerState;
+  bool nightHours;
+  unsigned long lastActivity;
   String feedbackMessage;
+  PottyStats* stats;
 
-  // Display mode configuration
-  int displayMode;           // 0 = elapsed only, 1 = timestamps only, 2 = cycle, 3 = large rotating
-  unsigned long cycleInterval;  // Milliseconds between view changes in cycle mode
+  // Display mode configuration (compile time, so the other modes' branches are never built)
+  static constexpr int displayMode = DISPLAY_CONFIG.mode;  // 0 = elapsed only, 1 = timestamps only, 2 = cycle, 3 = large rotating
+  static constexpr unsigned long cycleInterval = DISPLAY_CONFIG.cycleMs;  // Milliseconds between view changes
   int currentTimer;          // For mode 3: which timer to show (0=outside, 1=pee, 2=poop)
 
+  // Mode 3 labels as rendered display bytes (top page), filled on first use
+  static constexpr int labelCacheCount = displayMode == 3 ? 3 : 1;
+  uint8_t labelCache[labelCacheCount][LABEL_CACHE_WIDTH];
+  bool labelCached[labelCacheCount];
+
   // Render views
   void renderElapsedView(TimerManager* timerManager);
   void renderTimestampView(TimerManager* timerManager);
   void renderSingleTimerView(TimerManager* timerManager, int timerIndex);
+  void renderStatsView();
   void renderFeedback();
 
+  // Draw a mode 3 label at the top left from the cache (rendered with the GFX font once)
+  void drawCachedLabel(int timerIndex, const __FlashStringHelper* label);
+
+  // Render scheduling: the next frame is drawn at nextRenderAt or when invalidated
+  bool renderPending;
+  bool lastTimeSynced;
+  unsigned long nextRenderAt;
+  unsigned long renderCount;
+  unsigned long renderCountLogged;         // renderCount at the last log line
+  unsigned long lastRenderLog;
+
+  // Dim or blank the panel once it has been idle long enough
+  void updatePower();
+
+  // Send the contrast/display on-off commands for a power state
+  void setPower(DisplayPower state);
+
+  // Draw the current view into the buffer and start sending it
+  void render(TimerManager* timerManager, bool timeSynced);
+
+  // Earliest time anything shown can change: a minute rolling over, the next view
+  // rotation or the end of the feedback message
+  void scheduleNextRender(TimerManager* timerManager, bool timeSynced);
+
+  // Incremental flush: changed pages are sent OLED_FLUSH_CHUNK bytes at a time across
+  // update() calls. The buffer is not redrawn until the frame is complete (no tearing).
+  uint32_t pageHashes[SCREEN_HEIGHT / 8];  // Hash of each page as last sent
+  uint8_t dirtyPages;                      // Bit per page still to send
+  uint8_t flushPage;                       // Page being sent
+  uint8_t flushColumn;                     // Next column of that page (0 = address not set yet)
+  unsigned long chunkMicros;               // Measured time of one data transfer
+  unsigned long frameStart;
+
+  // Mark the pages that changed since the last frame and send the first slice
+  void commitFrame();
+
+  // Send chunks for up to OLED_FLUSH_BUDGET_US (at least one)
+  // Returns true once the frame is complete
+  bool flushStep();
+
+  // Send the whole buffer at once, timing the transfers (startup only)
+  void flushNow();
+
+  // The last page of a frame went out - the buffer may be drawn again
+  void onFrameComplete();
+
+  // Point the display RAM at one page (horizontal addressing, all columns)
+  void setPageAddress(uint8_t page);
+
+  // Send one run of display data
+  void sendData(const uint8_t* data, uint8_t length);
+
+  static uint32_t hashPage(const uint8_t* data);
+
   // Helper functions
   String getCurrentTimeString();
   void rotateView(bool timeSynced);
@@ -0,0 +1,60 @@
+#include "EventLog.h"
+
+EventLog::EventLog() :
+  head(0),
+  count(0),
+  nextSequence(1)
+{
+}
+
+void EventLog::record(Timer timer, time_t timestamp) {
+  TimerEvent& event = events[head];
+  event.sequence = nextSequence++;
+  event.timestamp = (uint32_t)timestamp;
+  event.timer = (uint8_t)timer;
+
+  // Overwrite the oldest entry once full
+  head = (head + 1) % EVENT_LOG_SIZE;
+  if (count < EVENT_LOG_SIZE) {
+    count++;
+  }
+
+  DEBUG_PRINT("EventLog: #");
+  DEBUG_PRINT(event.sequence);
+  DEBUG_PRINT(" ");
+  DEBUG_PRINT(getTimerName(event.timer));
+  DEBUG_PRINT(" at ");
+  DEBUG_PRINTLN(event.timestamp);
+}
+
+int EventLog::getCount() {
+  return count;
+}
+
+bool EventLog::getEvent(int index, TimerEvent* event) {
+  if (index < 0 || index >= count) {
+    return false;
+  }
+
+  // Oldest entry sits right after the newest one once the ring is full
+  int oldest = (head - count + EVENT_LOG_SIZE) % EVENT_LOG_SIZE;
+  *event = events[(oldest + index) % EVENT_LOG_SIZE];
+  return true;
+}
+
+uint32_t EventLog::getLastSequence() {
+  return nextSequence - 1;
+}
+
+const char* EventLog::getTimerName(uint8_t timer) {
+  switch (timer) {
+    case TIMER_OUTSIDE:
+      return "outside";
+    case TIMER_PEE:
+      return "pee";
+    case TIMER_POOP:
+      return "poop";
+    default:
+      return "unknown";
+  }
+}
@@ -0,0 +1,42 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "config.h"
+#include "TimerManager.h"
+
+// Single timer event (a reset or manual set)
+struct TimerEvent {
+  uint32_t sequence;    // Increments with every event (never 0 for a valid entry)
+  uint32_t timestamp;   // New timer start, Unix epoch time
+  uint8_t timer;        // Timer enum value
+};
+
+class EventLog {
+public:
+  EventLog();
+
+  // Record a timer event
+  void record(Timer timer, time_t timestamp);
+
+  // Get number of events currently held
+  int getCount();
+
+  // Get event by age (0 = oldest held), returns false if out of range
+  bool getEvent(int index, TimerEvent* event);
+
+  // Get sequence number of the most recent event (0 if none)
+  uint32_t getLastSequence();
+
+  // Get short timer name used in logs and API output
+  static const char* getTimerName(uint8_t timer);
+
+private:
+  TimerEvent events[EVENT_LOG_SIZE];  // Ring buffer
+  int head;                           // Next slot to write
+  int count;
+  uint32_t nextSequence;
+};
+
+#endif
@@ -0,0 +1,191 @@
+#include "EventStream.h"
+#include "EventLog.h"
+
+EventStream::EventStream() :
+  lastAlertLevel(-1),
+  lastKeepalive(0)
+{
+  for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+    clients[i].active = false;
+    clients[i].queued = 0;
+    clients[i].lastProgress = 0;
+  }
+  for (int i = 0; i < 3; i++) {
+    lastMinutes[i] = 0;
+  }
+}
+
+bool EventStream::hasFreeSlot() {
+  return getClientCount() < SSE_MAX_CLIENTS;
+}
+
+void EventStream::addClient(WiFiClient& client, TimerManager* timerManager) {
+  // Find a free slot
+  StreamClient* slot = nullptr;
+  for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+    if (!clients[i].active) {
+      slot = &clients[i];
+      break;
+    }
+  }
+
+  if (slot == nullptr) {
+    DEBUG_PRINTLN("EventStream: All client slots busy - rejecting");
+    client.stop();
+    return;
+  }
+
+  slot->client = client;
+  slot->client.setNoDelay(true);  // Events are tiny, send them right away
+  slot->active = true;
+  slot->queued = 0;
+  slot->lastProgress = millis();
+
+  // Initial snapshot goes through the queue like everything else
+  char buffer[160];
+  char data[128];
+  formatSnapshot(timerManager, data, sizeof(data));
+  int length = snprintf(buffer, sizeof(buffer), "event: state\ndata: %s\n\n", data);
+  enqueue(*slot, buffer, min((size_t)length, sizeof(buffer) - 1));
+
+  DEBUG_PRINT("EventStream: Client connected (");
+  DEBUG_PRINT(getClientCount());
+  DEBUG_PRINTLN(" active)");
+}
+
+void EventStream::pushTimerChange(Timer timer, time_t timestamp) {
+  char data[48];
+  snprintf(data, sizeof(data), "{\"t\":\"%s\",\"ts\":%lu}", EventLog::getTimerName(timer), (unsigned long)timestamp);
+  broadcast("timer", data);
+}
+
+void EventStream::update(TimerManager* timerManager) {
+  if (getClientCount() == 0) {
+    // Nothing to send - new clients get the current level in their snapshot
+    lastAlertLevel = -1;
+    return;
+  }
+
+  char data[64];
+
+  // Alert level changed (yellow/red threshold crossed or timer reset)
+  int alertLevel = LEDController::getAlertLevel(timerManager);
+  if (alertLevel != lastAlertLevel) {
+    if (lastAlertLevel >= 0) {
+      snprintf(data, sizeof(data), "{\"level\":\"%s\"}", LEDController::getAlertName((AlertLevel)alertLevel));
+      broadcast("alert", data);
+    }
+    lastAlertLevel = alertLevel;
+  }
+
+  // A displayed minute rolled over on any timer
+  unsigned long minutes[3];
+  bool minuteChanged = false;
+  for (int i = 0; i < 3; i++) {
+    minutes[i] = timerManager->getElapsed((Timer)i) / 60;
+    if (minutes[i] != lastMinutes[i]) {
+      minuteChanged = true;
+      lastMinutes[i] = minutes[i];
+    }
+  }
+  if (minuteChanged) {
+    snprintf(data, sizeof(data), "{\"m\":[%lu,%lu,%lu]}", minutes[0], minutes[1], minutes[2]);
+    broadcast("tick", data);
+  }
+
+  // Keep proxies and browsers from timing out idle connections
+  if (millis() - lastKeepalive >= SSE_KEEPALIVE_INTERVAL) {
+    lastKeepalive = millis();
+    for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+      if (clients[i].active && clients[i].queued == 0) {
+        enqueue(clients[i], ":\n\n", 3);
+      }
+    }
+  }
+
+  for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+    if (clients[i].active) {
+      drain(clients[i]);
+    }
+  }
+}
+
+int EventStream::getClientCount() {
+  int count = 0;
+  for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+    if (clients[i].active) {
+      count++;
+    }
+  }
+  return count;
+}
+
+void EventStream::broadcast(const char* event, const char* data) {
+  char buffer[128];
+  int length = snprintf(buffer, sizeof(buffer), "event: %s\ndata: %s\n\n", event, data);
+  length = min(length, (int)sizeof(buffer) - 1);
+
+  for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+    if (clients[i].active && !enqueue(clients[i], buffer, length)) {
+      // Queue full - this client is not keeping up, drop it instead of growing RAM
+      evict(clients[i], "queue full");
+    }
+  }
+}
+
+bool EventStream::enqueue(StreamClient& slot, const char* text, size_t length) {
+  if (slot.queued + length > SSE_CLIENT_QUEUE_SIZE) {
+    return false;
+  }
+  if (slot.queued == 0) {
+    slot.lastProgress = millis();  // Stall timer starts when data is waiting
+  }
+  memcpy(slot.queue + slot.queued, text, length);
+  slot.queued += length;
+  return true;
+}
+
+void EventStream::drain(StreamClient& slot) {
+  if (!slot.client.connected()) {
+    evict(slot, "disconnected");
+    return;
+  }
+
+  if (slot.queued == 0) {
+    return;
+  }
+
+  // Never write more than the TCP buffer can take right now (write would block)
+  size_t space = (size_t)slot.client.availableForWrite();
+  size_t length = min(space, slot.queued);
+  if (length > 0) {
+    size_t written = slot.client.write((const uint8_t*)slot.queue, length);
+    if (written > 0) {
+      memmove(slot.queue, slot.queue + written, slot.queued - written);
+      slot.queued -= written;
+      slot.lastProgress = millis();
+      return;
+    }
+  }
+
+  if (millis() - slot.lastProgress >= SSE_STALL_TIMEOUT) {
+    evict(slot, "stalled");
+  }
+}
+
+void EventStream::evict(StreamClient& slot, const char* reason) {
+  slot.client.stop();
+  slot.active = false;
+  slot.queued = 0;
+  DEBUG_PRINT("EventStream: Client dropped (");
+  DEBUG_PRINT(reason);
+  DEBUG_PRINTLN(")");
+}
+
+void EventStream::formatSnapshot(TimerManager* timerManager, char* buffer, size_t size) {
+  snprintf(buffer, size, "{\"outside\":%lu,\"pee\":%lu,\"poop\":%lu,\"level\":\"%s\"}",
+           (unsigned long)timerManager->getTimestamp(TIMER_OUTSIDE),
+           (unsigned long)timerManager->getTimestamp(TIMER_PEE),
+           (unsigned long)timerManager->getTimestamp(TIMER_POOP),
+           LEDController::getAlertName(LEDController::getAlertLevel(timerManager)));
+}
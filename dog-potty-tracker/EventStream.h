@@ -0,0 +1,60 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include "config.h"
+#include "TimerManager.h"
+#include "LEDController.h"
+
+// One live Server-Sent Events connection with its bounded send queue
+struct StreamClient {
+  WiFiClient client;
+  bool active;
+  char queue[SSE_CLIENT_QUEUE_SIZE];
+  size_t queued;               // Bytes waiting in queue
+  unsigned long lastProgress;  // Last time the client accepted data (or had nothing to send)
+};
+
+class EventStream {
+public:
+  EventStream();
+
+  // Check if another client can be accepted
+  bool hasFreeSlot();
+
+  // Take over an HTTP connection (headers already sent) as a new SSE client
+  void addClient(WiFiClient& client, TimerManager* timerManager);
+
+  // Push a timer change to all clients
+  void pushTimerChange(Timer timer, time_t timestamp);
+
+  // Detect alert level changes and minute boundaries, drain queues (call every loop iteration)
+  void update(TimerManager* timerManager);
+
+  // Get number of connected clients
+  int getClientCount();
+
+private:
+  StreamClient clients[SSE_MAX_CLIENTS];
+  int lastAlertLevel;
+  unsigned long lastMinutes[3];
+  unsigned long lastKeepalive;
+
+  // Queue one event for every client (evicts clients whose queue is full)
+  void broadcast(const char* event, const char* data);
+
+  // Queue raw bytes for a client, returns false if it does not fit
+  bool enqueue(StreamClient& slot, const char* text, size_t length);
+
+  // Write as much of the queue as the socket accepts without blocking
+  void drain(StreamClient& slot);
+
+  // Drop a client and free its slot
+  void evict(StreamClient& slot, const char* reason);
+
+  // Format full state (timestamps + alert level) as JSON
+  void formatSnapshot(TimerManager* timerManager, char* buffer, size_t size);
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef FLASH_STRINGS_H
+#define FLASH_STRINGS_H
+
+// Constant strings in flash instead of DRAM. On the ESP8266 every plain string
+// literal is copied into the 80 KB of data RAM at boot, where it takes space the
+// TLS buffers need; PSTR()/F() literals stay in flash and are read when used.
+// Use the _P functions (strcmp_P, snprintf_P, ...) or the helpers below with them.
+// Plain C++ with no Arduino dependencies: on a Linux host the flash macros fall back
+// to ordinary memory, so the tools/ programs can include the same headers.
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <pgmspace.h>
+#else
+#include <strings.h>
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strncasecmp_P strncasecmp
+#define strstr_P strstr
+#define memcpy_P memcpy
+#define snprintf_P snprintf
+#endif
+
+// text (in RAM) equals a flash string
+inline bool flashEquals(const char* text, PGM_P flash) {
+  return strcmp_P(text, flash) == 0;
+}
+
+// text (in RAM) starts with a flash string (no String copy, unlike String::startsWith)
+inline bool flashStartsWith(const char* text, PGM_P prefix) {
+  return strncmp_P(text, prefix, strlen_P(prefix)) == 0;
+}
+
+// Position of a flash string in text (in RAM), -1 if not found
+inline int flashIndexOf(const char* text, PGM_P pattern) {
+  const char* found = strstr_P(text, pattern);
+  return found != nullptr ? (int)(found - text) : -1;
+}
+
+#endif
@@ -0,0 +1,431 @@
+#include "History.h"
+#include "PottyStats.h"
+
+#define HISTORY_STATE_PATH "/history/state.bin"
+#define HISTORY_STATE_MAGIC 0x48535401  // "HST" + layout version
+
+struct HistoryState {
+  uint32_t magic;
+  uint32_t rolledSequence;
+};
+
+History::History() :
+  ready(false),
+  nextSequence(1),
+  rolledSequence(0),
+  pendingSequence(0),
+  lastCheck(0)
+{
+  memset(&pending, 0, sizeof(pending));
+}
+
+bool History::begin() {
+  if (!LittleFS.begin()) {
+    DEBUG_PRINTLN("History: LittleFS mount failed - history disabled");
+    return false;
+  }
+  LittleFS.mkdir("/history");
+
+  // Create (or resize after a configuration change) the fixed-size tier files
+  for (int tier = TIER_RAW; tier <= TIER_WEEKLY; tier++) {
+    const char* path = getPath((HistoryTier)tier);
+    size_t expected = getCapacity((HistoryTier)tier) * getRecordSize((HistoryTier)tier);
+    File file = LittleFS.open(path, "r");
+    size_t size = file ? file.size() : 0;
+    if (file) file.close();
+    if (size == expected) continue;
+
+    DEBUG_PRINT("History: Creating ");
+    DEBUG_PRINTLN(path);
+    file = LittleFS.open(path, "w");
+    if (!file) {
+      DEBUG_PRINTLN("History: Cannot create tier file - history disabled");
+      return false;
+    }
+    uint8_t zeros[64];
+    memset(zeros, 0, sizeof(zeros));
+    for (size_t written = 0; written < expected; written += sizeof(zeros)) {
+      file.write(zeros, min(sizeof(zeros), expected - written));
+    }
+    file.close();
+  }
+
+  // Open every tier once for the lifetime of the tracker
+  for (int tier = TIER_RAW; tier <= TIER_WEEKLY; tier++) {
+    files[tier] = LittleFS.open(getPath((HistoryTier)tier), "r+");
+    if (!files[tier]) {
+      DEBUG_PRINT("History: Cannot open ");
+      DEBUG_PRINTLN(getPath((HistoryTier)tier));
+      return false;
+    }
+  }
+  ready = true;
+
+  // How far the rollup tiers got before the last reset
+  HistoryState state;
+  File file = LittleFS.open(HISTORY_STATE_PATH, "r");
+  if (file && file.read((uint8_t*)&state, sizeof(state)) == sizeof(state) && state.magic == HISTORY_STATE_MAGIC) {
+    rolledSequence = state.rolledSequence;
+  }
+  if (file) file.close();
+
+  // Find the newest raw event (several slots per read)
+  uint32_t newest = 0;
+  HistoryEvent batch[8];
+  for (uint32_t slot = 0; slot < HISTORY_RAW_EVENTS; slot += 8) {
+    uint32_t count = min((uint32_t)8, (uint32_t)HISTORY_RAW_EVENTS - slot);
+    if (!readSlot(TIER_RAW, slot, batch, count * sizeof(HistoryEvent))) {
+      break;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+      if (batch[i].sequence > newest) {
+        newest = batch[i].sequence;
+      }
+    }
+  }
+  nextSequence = newest + 1;
+  if (rolledSequence > newest) {
+    rolledSequence = newest;
+  }
+
+  // Replay events from the hour that was not rolled up yet (reset mid-hour)
+  HistoryEvent event;
+  uint32_t first = rolledSequence + 1;
+  if (newest >= HISTORY_RAW_EVENTS && first < newest - HISTORY_RAW_EVENTS + 1) {
+    first = newest - HISTORY_RAW_EVENTS + 1;
+  }
+  for (uint32_t sequence = first; sequence <= newest; sequence++) {
+    if (readSlot(TIER_RAW, sequence % HISTORY_RAW_EVENTS, &event, sizeof(event)) && event.sequence == sequence) {
+      accumulate(event);
+    }
+  }
+
+  DEBUG_PRINT("History: Ready, ");
+  DEBUG_PRINT(getEventCount());
+  DEBUG_PRINT(" raw events, replayed ");
+  DEBUG_PRINTLN(newest >= first ? newest - first + 1 : 0);
+  return true;
+}
+
+void History::record(Timer timer, time_t previous, time_t current) {
+  if (!ready || current < 1000000000) {
+    return;
+  }
+
+  HistoryEvent event;
+  memset(&event, 0, sizeof(event));
+  event.sequence = nextSequence++;
+  event.timestamp = (uint32_t)current;
+  event.previous = previous >= 1000000000 ? (uint32_t)previous : 0;
+  event.timer = (uint8_t)timer;
+
+  writeSlot(TIER_RAW, event.sequence % HISTORY_RAW_EVENTS, &event, sizeof(event));
+  accumulate(event);
+}
+
+void History::update() {
+  if (!ready || pending.period == 0 || millis() - lastCheck < HISTORY_CHECK_INTERVAL) {
+    return;
+  }
+  lastCheck = millis();
+
+  time_t now = time(nullptr);
+  if (now >= 1000000000 && getPeriod(TIER_HOURLY, now) != pending.period) {
+    rollPending();
+  }
+}
+
+bool History::isReady() {
+  return ready;
+}
+
+void History::accumulate(const HistoryEvent& event) {
+  // One-event rollup, filtered like PottyStats (corrections and double presses add nothing)
+  RollupRecord single;
+  memset(&single, 0, sizeof(single));
+  single.period = getPeriod(TIER_HOURLY, event.timestamp);
+
+  bool hasPrevious = event.previous != 0;
+  uint32_t gap = hasPrevious && event.timestamp > event.previous ? event.timestamp - event.previous : 0;
+  bool counts = !hasPrevious || (event.timestamp > event.previous && gap >= STATS_MIN_INTERVAL);
+  if (counts && event.timer <= TIMER_POOP) {
+    single.counts[event.timer] = 1;
+    if (event.timer != TIMER_OUTSIDE && hasPrevious && gap <= STATS_MAX_INTERVAL) {
+      single.intervals[event.timer - 1] = 1;
+      single.intervalMinutes[event.timer - 1] = (uint16_t)(gap / 60);
+      if (event.timer == TIMER_PEE) {
+        single.longestGap = (uint16_t)(gap / 60);
+      }
+    }
+  }
+
+  // Events for an earlier hour (e.g. setpee 90) go straight into the flash tiers
+  if (pending.period != 0 && single.period < pending.period) {
+    rollPending();
+  }
+  if (pending.period == 0 && single.period < getPeriod(TIER_HOURLY, time(nullptr))) {
+    mergeIntoTier(TIER_HOURLY, single, event.timestamp);
+    mergeIntoTier(TIER_DAILY, single, event.timestamp);
+    mergeIntoTier(TIER_WEEKLY, single, event.timestamp);
+    rolledSequence = event.sequence;
+    saveState();
+    return;
+  }
+
+  // A new hour started since the last event - roll the finished one first
+  if (pending.period != 0 && single.period != pending.period) {
+    rollPending();
+  }
+  if (pending.period == 0) {
+    pending.period = single.period;
+  }
+  mergeRecord(&pending, single);
+  pendingSequence = event.sequence;
+}
+
+void History::rollPending() {
+  if (pending.period == 0) {
+    return;
+  }
+
+  time_t start = getPeriodStart(TIER_HOURLY, pending.period);
+  mergeIntoTier(TIER_HOURLY, pending, start);
+  mergeIntoTier(TIER_DAILY, pending, start);
+  mergeIntoTier(TIER_WEEKLY, pending, start);
+
+  rolledSequence = pendingSequence;
+  saveState();
+
+  DEBUG_PRINT("History: Rolled up hour ");
+  DEBUG_PRINT(pending.period);
+  DEBUG_PRINT(" (");
+  DEBUG_PRINT(pending.counts[TIMER_PEE]);
+  DEBUG_PRINTLN(" pee)");
+
+  memset(&pending, 0, sizeof(pending));
+}
+
+void History::mergeIntoTier(HistoryTier tier, const RollupRecord& hour, time_t timestamp) {
+  uint32_t period = getPeriod(tier, timestamp);
+  uint32_t slot = period % getCapacity(tier);
+
+  // Slot holds an older period (or nothing) - start over
+  RollupRecord record;
+  if (!readSlot(tier, slot, &record, sizeof(record)) || record.period != period) {
+    memset(&record, 0, sizeof(record));
+    record.period = period;
+  }
+  mergeRecord(&record, hour);
+  writeSlot(tier, slot, &record, sizeof(record));
+}
+
+uint32_t History::getPeriod(HistoryTier tier, time_t timestamp) {
+  switch (tier) {
+    case TIER_HOURLY:
+      return (uint32_t)(timestamp / 3600);
+    case TIER_DAILY:
+      return (uint32_t)PottyStats::getLocalDay(timestamp);
+    case TIER_WEEKLY:
+      return (uint32_t)((PottyStats::getLocalDay(timestamp) + 3) / 7);  // 1970-01-01 was a Thursday
+    default:
+      return 0;
+  }
+}
+
+time_t History::getPeriodStart(HistoryTier tier, uint32_t period) {
+  if (tier == TIER_HOURLY) {
+    return (time_t)period * 3600;
+  }
+
+  int32_t day = tier == TIER_WEEKLY ? (int32_t)period * 7 - 3 : (int32_t)period;
+
+  // UTC midnight of that date, moved to local midnight
+  time_t utcMidnight = (time_t)day * 86400;
+  struct tm* timeinfo = localtime(&utcMidnight);
+  long secondsIntoDay = timeinfo->tm_hour * 3600L + timeinfo->tm_min * 60L + timeinfo->tm_sec;
+  int32_t localDay = PottyStats::getLocalDay(utcMidnight);
+  return utcMidnight - secondsIntoDay - (time_t)(localDay - day) * 86400;
+}
+
+uint32_t History::getOldestPeriod(HistoryTier tier, uint32_t currentPeriod) {
+  uint32_t capacity = getCapacity(tier);
+  return currentPeriod >= capacity ? currentPeriod - capacity + 1 : 1;
+}
+
+HistoryTier History::selectTier(time_t from) {
+  HistoryEvent oldest;
+  if (readEvent(0, &oldest) && (uint32_t)from >= oldest.timestamp) {
+    return TIER_RAW;
+  }
+
+  time_t now = time(nullptr);
+  if (getPeriod(TIER_HOURLY, from) >= getOldestPeriod(TIER_HOURLY, getPeriod(TIER_HOURLY, now))) {
+    return TIER_HOURLY;
+  }
+  if (getPeriod(TIER_DAILY, from) >= getOldestPeriod(TIER_DAILY, getPeriod(TIER_DAILY, now))) {
+    return TIER_DAILY;
+  }
+  return TIER_WEEKLY;
+}
+
+bool History::readPeriod(HistoryTier tier, uint32_t period, RollupRecord* record) {
+  if (!ready || tier == TIER_RAW || period == 0) {
+    return false;
+  }
+
+  bool found = readSlot(tier, period % getCapacity(tier), record, sizeof(RollupRecord)) &&
+               record->period == period;
+  if (!found) {
+    memset(record, 0, sizeof(RollupRecord));
+    record->period = period;
+  }
+
+  // The current hour only lives in RAM until it is rolled up
+  if (pending.period != 0 && getPeriod(tier, getPeriodStart(TIER_HOURLY, pending.period)) == period) {
+    mergeRecord(record, pending);
+    found = true;
+  }
+  return found;
+}
+
+int History::getEventCount() {
+  uint32_t held = nextSequence - 1;
+  return held < HISTORY_RAW_EVENTS ? (int)held : HISTORY_RAW_EVENTS;
+}
+
+bool History::readEvent(int index, HistoryEvent* event) {
+  int count = getEventCount();
+  if (index < 0 || index >= count) {
+    return false;
+  }
+  return readEventBySequence(nextSequence - count + index, event);
+}
+
+bool History::readEventBySequence(uint32_t sequence, HistoryEvent* event) {
+  if (!ready || sequence == 0 || sequence >= nextSequence) {
+    return false;
+  }
+  return readSlot(TIER_RAW, sequence % HISTORY_RAW_EVENTS, event, sizeof(HistoryEvent)) &&
+         event->sequence == sequence;
+}
+
+String History::getTrendSummary() {
+  if (!ready) {
+    return "History not available";
+  }
+  time_t now = time(nullptr);
+  if (now < 1000000000) {
+    return "Time not synced";
+  }
+
+  String summary = "";
+  uint32_t currentWeek = getPeriod(TIER_WEEKLY, now);
+  char buffer[80];
+  char average[12];
+  char longest[12];
+
+  // Last four weeks, then the same week a year ago
+  static const int32_t weeksAgo[] = {0, 1, 2, 3, 52};
+  for (int i = 0; i < 5; i++) {
+    uint32_t week = currentWeek - weeksAgo[i];
+    RollupRecord record;
+    time_t start = getPeriodStart(TIER_WEEKLY, week);
+    struct tm* timeinfo = localtime(&start);
+
+    if (weeksAgo[i] == 0) {
+      snprintf(buffer, sizeof(buffer), "This week: ");
+    } else if (weeksAgo[i] == 52) {
+      snprintf(buffer, sizeof(buffer), "Year ago %d/%d: ", timeinfo->tm_mon + 1, timeinfo->tm_mday);
+    } else {
+      snprintf(buffer, sizeof(buffer), "Week of %d/%d: ", timeinfo->tm_mon + 1, timeinfo->tm_mday);
+    }
+    summary += buffer;
+
+    if (!readPeriod(TIER_WEEKLY, week, &record)) {
+      summary += "no data\n";
+      continue;
+    }
+    uint8_t intervals = record.intervals[TIMER_PEE - 1];
+    PottyStats::formatDuration(intervals ? (uint32_t)record.intervalMinutes[TIMER_PEE - 1] * 60 / intervals : 0,
+                               average, sizeof(average));
+    PottyStats::formatDuration((uint32_t)record.longestGap * 60, longest, sizeof(longest));
+    snprintf(buffer, sizeof(buffer), "%u pee, %u poop, avg %s, longest %s\n",
+             record.counts[TIMER_PEE], record.counts[TIMER_POOP], intervals ? average : "--", longest);
+    summary += buffer;
+  }
+
+  summary.trim();
+  return summary;
+}
+
+bool History::readSlot(HistoryTier tier, uint32_t slot, void* buffer, size_t size) {
+  File& file = files[tier];
+  if (!file) {
+    return false;
+  }
+  return file.seek(slot * getRecordSize(tier), SeekSet) && file.read((uint8_t*)buffer, size) == (int)size;
+}
+
+bool History::writeSlot(HistoryTier tier, uint32_t slot, const void* buffer, size_t size) {
+  File& file = files[tier];
+  if (!file) {
+    return false;
+  }
+  bool ok = file.seek(slot * getRecordSize(tier), SeekSet) && file.write((const uint8_t*)buffer, size) == size;
+
+  // An open file is only committed on flush or close - do it now so a reset keeps the record
+  file.flush();
+  return ok;
+}
+
+void History::saveState() {
+  HistoryState state = {HISTORY_STATE_MAGIC, rolledSequence};
+  File file = LittleFS.open(HISTORY_STATE_PATH, "w");
+  if (file) {
+    file.write((const uint8_t*)&state, sizeof(state));
+    file.close();
+  }
+}
+
+const char* History::getPath(HistoryTier tier) {
+  switch (tier) {
+    case TIER_RAW:
+      return "/history/raw.bin";
+    case TIER_HOURLY:
+      return "/history/hourly.bin";
+    case TIER_DAILY:
+      return "/history/daily.bin";
+    default:
+      return "/history/weekly.bin";
+  }
+}
+
+uint32_t History::getCapacity(HistoryTier tier) {
+  switch (tier) {
+    case TIER_RAW:
+      return HISTORY_RAW_EVENTS;
+    case TIER_HOURLY:
+      return HISTORY_HOURS;
+    case TIER_DAILY:
+      return HISTORY_DAYS;
+    default:
+      return HISTORY_WEEKS;
+  }
+}
+
+size_t History::getRecordSize(HistoryTier tier) {
+  return tier == TIER_RAW ? sizeof(HistoryEvent) : sizeof(RollupRecord);
+}
+
+void History::mergeRecord(RollupRecord* into, const RollupRecord& from) {
+  for (int i = 0; i < 3; i++) {
+    into->counts[i] = (uint8_t)min(255, into->counts[i] + from.counts[i]);
+  }
+  for (int i = 0; i < 2; i++) {
+    into->intervals[i] = (uint8_t)min(255, into->intervals[i] + from.intervals[i]);
+    into->intervalMinutes[i] = (uint16_t)min(65535L, (long)into->intervalMinutes[i] + from.intervalMinutes[i]);
+  }
+  if (from.longestGap > into->longestGap) {
+    into->longestGap = from.longestGap;
+  }
+}
@@ -0,0 +1,118 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <time.h>
+#include "config.h"
+#include "TimerManager.h"
+
+// Long-term history in fixed-size circular tiers on LittleFS:
+//   raw     - most recent events, slot = sequence % HISTORY_RAW_EVENTS
+//   hourly  - slot = hour number % HISTORY_HOURS
+//   daily   - slot = local day number % HISTORY_DAYS
+//   weekly  - slot = local week number (Monday) % HISTORY_WEEKS
+// Rollup slots carry their period number, so a slot holding an older period
+// simply reads as empty and no head/tail bookkeeping is written to flash.
+enum HistoryTier {
+  TIER_RAW = 0,
+  TIER_HOURLY = 1,
+  TIER_DAILY = 2,
+  TIER_WEEKLY = 3
+};
+
+// Raw timer event
+struct __attribute__((packed)) HistoryEvent {
+  uint32_t sequence;       // Increments with every event (0 = empty slot)
+  uint32_t timestamp;      // New timer start, Unix epoch
+  uint32_t previous;       // Previous timer start (0 if unknown)
+  uint8_t timer;           // Timer enum value
+  uint8_t reserved[3];
+};
+
+// Aggregate for one hour, day or week
+struct __attribute__((packed)) RollupRecord {
+  uint32_t period;              // Hour/day/week number this slot holds (0 = empty)
+  uint8_t counts[3];            // Events per timer (saturating)
+  uint8_t intervals[2];         // Pee/poop intervals that ended in this period
+  uint8_t reserved;
+  uint16_t intervalMinutes[2];  // Sum of those intervals (saturating)
+  uint16_t longestGap;          // Longest pee interval that ended in this period (minutes)
+};
+
+static_assert(sizeof(HistoryEvent) == 16, "HistoryEvent layout changed");
+static_assert(sizeof(RollupRecord) == 16, "RollupRecord layout changed");
+
+class History {
+public:
+  History();
+
+  // Mount LittleFS, create tier files and replay events not rolled up yet
+  bool begin();
+
+  // Record a timer change (call from the TimerManager change callback)
+  void record(Timer timer, time_t previous, time_t current);
+
+  // Roll the finished hour into the hourly, daily and weekly tiers (call every loop iteration)
+  void update();
+
+  // Check if history storage is available
+  bool isReady();
+
+  // Period number of a timestamp in a rollup tier
+  static uint32_t getPeriod(HistoryTier tier, time_t timestamp);
+
+  // Start of a rollup period as Unix epoch (local midnight for days and weeks)
+  static time_t getPeriodStart(HistoryTier tier, uint32_t period);
+
+  // Oldest period a rollup tier can still hold for the given current period
+  static uint32_t getOldestPeriod(HistoryTier tier, uint32_t currentPeriod);
+
+  // Finest rollup tier that still covers a timestamp
+  HistoryTier selectTier(time_t from);
+
+  // Read one rollup period (includes the hour not rolled up yet); false if no data
+  bool readPeriod(HistoryTier tier, uint32_t period, RollupRecord* record);
+
+  // Number of raw events held, and event by age (0 = oldest held)
+  int getEventCount();
+  bool readEvent(int index, HistoryEvent* event);
+
+  // Read a raw event by sequence number (false once it has been overwritten)
+  bool readEventBySequence(uint32_t sequence, HistoryEvent* event);
+
+  // Multi-line weekly trend for the history command
+  String getTrendSummary();
+
+private:
+  bool ready;
+  uint32_t nextSequence;        // Sequence for the next raw event
+  uint32_t rolledSequence;      // Last raw event included in the rollup tiers
+  RollupRecord pending;         // Current hour, rolled up at the hour boundary
+  uint32_t pendingSequence;     // Last raw event included in pending
+  unsigned long lastCheck;
+  File files[TIER_WEEKLY + 1];  // Tier files stay open - opening one walks the directory every time
+
+  // Add an event to the pending hour, or patch older periods directly (late corrections)
+  void accumulate(const HistoryEvent& event);
+
+  // Write the pending hour into all rollup tiers and remember how far we got
+  void rollPending();
+
+  // Merge a one-hour record into the slot of the matching period in a tier
+  void mergeIntoTier(HistoryTier tier, const RollupRecord& hour, time_t timestamp);
+
+  // Slot I/O (size may span consecutive slots)
+  bool readSlot(HistoryTier tier, uint32_t slot, void* buffer, size_t size);
+  bool writeSlot(HistoryTier tier, uint32_t slot, const void* buffer, size_t size);
+
+  // Persist rolledSequence
+  void saveState();
+
+  static const char* getPath(HistoryTier tier);
+  static uint32_t getCapacity(HistoryTier tier);
+  static size_t getRecordSize(HistoryTier tier);
+  static void mergeRecord(RollupRecord* into, const RollupRecord& from);
+};
+
+#endif
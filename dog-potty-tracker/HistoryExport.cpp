@@ -0,0 +1,297 @@
+#include "HistoryExport.h"
+#include "EventLog.h"
+
+// Chunk framing around the row data in buffer:
+//   [size in hex + CRLF, right-aligned in CHUNK_PREFIX_SIZE][rows][JSON trailer][CRLF][optional final "0" chunk]
+#define CHUNK_PREFIX_SIZE 6
+#define CHUNK_SUFFIX_SIZE 10  // "]}\n" + CRLF + "0\r\n\r\n"
+#define EXPORT_LINE_SIZE 144
+
+// Longest row either format can produce (JSON rollup with every field at its maximum)
+static_assert(sizeof(",\n{\"start\":4294967295,\"local\":\"2106-02-07 06:00\",\"pee\":255,\"poop\":255,"
+                     "\"outside\":255,\"peeAvg\":65535,\"poopAvg\":65535,\"longestGap\":65535}") <= EXPORT_LINE_SIZE,
+              "EXPORT_LINE_SIZE is too small for a rollup row");
+
+static const char* const TIER_NAMES[] = {"raw", "hourly", "daily", "weekly"};
+
+HistoryExport::HistoryExport() :
+  history(nullptr),
+  active(false),
+  headerSent(false),
+  finished(false),
+  tier(TIER_RAW),
+  format(EXPORT_CSV),
+  from(0),
+  to(0),
+  position(1),
+  end(0),
+  rows(0),
+  lastProgress(0),
+  sendOffset(0),
+  sendLength(0)
+{
+}
+
+bool HistoryExport::isBusy() {
+  return active;
+}
+
+void HistoryExport::start(WiFiClient& newClient, History* newHistory, HistoryTier newTier,
+                          ExportFormat newFormat, time_t newFrom, time_t newTo) {
+  if (active) {
+    newClient.stop();
+    return;
+  }
+
+  client = newClient;
+  history = newHistory;
+  tier = newTier;
+  format = newFormat;
+  from = newFrom;
+  to = newTo;
+  rows = 0;
+  headerSent = false;
+  finished = false;
+  active = true;
+  lastProgress = millis();
+
+  // Work out the cursor range once - records added later are not part of this export
+  if (tier == TIER_RAW) {
+    HistoryEvent oldest;
+    int count = history->getEventCount();
+    if (count > 0 && history->readEvent(0, &oldest)) {
+      position = oldest.sequence;
+      end = oldest.sequence + count - 1;
+    } else {
+      position = 1;
+      end = 0;
+    }
+  } else {
+    uint32_t oldest = History::getOldestPeriod(tier, History::getPeriod(tier, time(nullptr)));
+    position = max(History::getPeriod(tier, from), oldest);
+    end = History::getPeriod(tier, to);
+  }
+
+  // Response headers go out first, then chunks are framed here rather than by the web server
+  char date[12];
+  struct tm timeinfo;
+  localtime_r(&from, &timeinfo);
+  strftime(date, sizeof(date), "%Y-%m-%d", &timeinfo);
+  int length = snprintf(buffer, sizeof(buffer),
+                        "HTTP/1.1 200 OK\r\n"
+                        "Content-Type: %s\r\n"
+                        "Content-Disposition: attachment; filename=\"potty-%s-%s.%s\"\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "Access-Control-Allow-Origin: *\r\n"
+                        "Connection: close\r\n\r\n",
+                        format == EXPORT_JSON ? "application/json" : "text/csv",
+                        TIER_NAMES[tier], date, format == EXPORT_JSON ? "json" : "csv");
+  sendOffset = 0;
+  sendLength = min((size_t)length, sizeof(buffer) - 1);
+
+  DEBUG_PRINT("HistoryExport: Started ");
+  DEBUG_PRINT(TIER_NAMES[tier]);
+  DEBUG_PRINT(" export, ");
+  DEBUG_PRINT(end >= position ? end - position + 1 : 0);
+  DEBUG_PRINTLN(" records to scan");
+}
+
+void HistoryExport::update() {
+  if (!active) {
+    return;
+  }
+
+  if (!client.connected()) {
+    finish("disconnected");
+    return;
+  }
+
+  // Finish the chunk in flight before reading more from flash
+  if (sendOffset < sendLength) {
+    drain();
+    return;
+  }
+
+  if (finished) {
+    finish("complete");
+    return;
+  }
+
+  buildChunk();
+  drain();
+}
+
+void HistoryExport::buildChunk() {
+  char* data = buffer + CHUNK_PREFIX_SIZE;
+  size_t capacity = sizeof(buffer) - CHUNK_PREFIX_SIZE - CHUNK_SUFFIX_SIZE;
+  size_t length = 0;
+  char line[EXPORT_LINE_SIZE];
+
+  // Column header or JSON opening on the first chunk
+  if (!headerSent) {
+    int written;
+    if (format == EXPORT_JSON) {
+      written = snprintf(data, capacity, "{\"tier\":\"%s\",\"from\":%lu,\"to\":%lu,\"rows\":[",
+                         TIER_NAMES[tier], (unsigned long)from, (unsigned long)to);
+    } else if (tier == TIER_RAW) {
+      written = snprintf(data, capacity, "timestamp,local_time,timer,interval_min\n");
+    } else {
+      written = snprintf(data, capacity,
+                         "period_start,local_time,pee,poop,outside,pee_avg_min,poop_avg_min,longest_pee_gap_min\n");
+    }
+    length = min((size_t)written, capacity);
+    headerSent = true;
+  }
+
+  // A bounded number of flash reads per call keeps the main loop responsive
+  for (int reads = 0; reads < HISTORY_EXPORT_READS_PER_LOOP && position <= end &&
+                      capacity - length >= EXPORT_LINE_SIZE; reads++) {
+    size_t lineLength = 0;
+    if (tier == TIER_RAW) {
+      HistoryEvent event;
+      if (history->readEventBySequence(position, &event)) {
+        lineLength = formatEvent(event, line, sizeof(line));
+      }
+    } else {
+      RollupRecord record;
+      if (history->readPeriod(tier, position, &record)) {
+        lineLength = formatRollup(record, line, sizeof(line));
+      }
+    }
+    position++;
+
+    if (lineLength > 0) {
+      memcpy(data + length, line, lineLength);
+      length += lineLength;
+      rows++;
+    }
+  }
+
+  if (position > end) {
+    if (format == EXPORT_JSON) {
+      memcpy(data + length, "]}\n", 3);
+      length += 3;
+    }
+    finished = true;
+  }
+
+  sendLength = 0;
+  sendOffset = 0;
+  lastProgress = millis();  // Stall timer starts when data is waiting
+  if (length > 0) {
+    // Size prefix goes right in front of the data so nothing has to move
+    char prefix[CHUNK_PREFIX_SIZE + 1];
+    int prefixLength = snprintf(prefix, sizeof(prefix), "%X\r\n", (unsigned int)length);
+    sendOffset = CHUNK_PREFIX_SIZE - prefixLength;
+    memcpy(buffer + sendOffset, prefix, prefixLength);
+    memcpy(data + length, "\r\n", 2);
+    sendLength = CHUNK_PREFIX_SIZE + length + 2;
+  }
+  if (finished) {
+    memcpy(buffer + sendLength, "0\r\n\r\n", 5);
+    sendLength += 5;
+  }
+}
+
+size_t HistoryExport::formatEvent(const HistoryEvent& event, char* line, size_t size) {
+  if ((time_t)event.timestamp < from || (time_t)event.timestamp > to) {
+    return 0;
+  }
+
+  char local[20];
+  time_t timestamp = event.timestamp;
+  struct tm timeinfo;
+  localtime_r(&timestamp, &timeinfo);
+  strftime(local, sizeof(local), "%Y-%m-%d %H:%M", &timeinfo);
+
+  // Interval since the previous start of the same timer, empty/null when unknown
+  char interval[12] = "";
+  if (event.previous != 0 && event.timestamp > event.previous) {
+    snprintf(interval, sizeof(interval), "%lu", (unsigned long)(event.timestamp - event.previous) / 60);
+  }
+
+  int length;
+  if (format == EXPORT_JSON) {
+    length = snprintf(line, size, "%s{\"ts\":%lu,\"local\":\"%s\",\"timer\":\"%s\",\"interval\":%s}",
+                      rows > 0 ? ",\n" : "\n", (unsigned long)event.timestamp, local,
+                      EventLog::getTimerName(event.timer), interval[0] ? interval : "null");
+  } else {
+    length = snprintf(line, size, "%lu,%s,%s,%s\n", (unsigned long)event.timestamp, local,
+                      EventLog::getTimerName(event.timer), interval);
+  }
+  // A cut-off row would break the file - leave it out instead (cannot happen with EXPORT_LINE_SIZE)
+  if (length < 0 || (size_t)length >= size) {
+    return 0;
+  }
+  return (size_t)length;
+}
+
+size_t HistoryExport::formatRollup(const RollupRecord& record, char* line, size_t size) {
+  char local[20];
+  time_t start = History::getPeriodStart(tier, record.period);
+  struct tm timeinfo;
+  localtime_r(&start, &timeinfo);
+  strftime(local, sizeof(local), tier == TIER_HOURLY ? "%Y-%m-%d %H:00" : "%Y-%m-%d", &timeinfo);
+
+  // Average interval per timer, empty/null when no interval ended in this period
+  char average[2][8];
+  for (int i = 0; i < 2; i++) {
+    if (record.intervals[i] > 0) {
+      snprintf(average[i], sizeof(average[i]), "%u", record.intervalMinutes[i] / record.intervals[i]);
+    } else {
+      strcpy(average[i], format == EXPORT_JSON ? "null" : "");
+    }
+  }
+
+  int length;
+  if (format == EXPORT_JSON) {
+    length = snprintf(line, size,
+                      "%s{\"start\":%lu,\"local\":\"%s\",\"pee\":%u,\"poop\":%u,\"outside\":%u,"
+                      "\"peeAvg\":%s,\"poopAvg\":%s,\"longestGap\":%u}",
+                      rows > 0 ? ",\n" : "\n", (unsigned long)start, local,
+                      record.counts[TIMER_PEE], record.counts[TIMER_POOP], record.counts[TIMER_OUTSIDE],
+                      average[0], average[1], record.longestGap);
+  } else {
+    length = snprintf(line, size, "%lu,%s,%u,%u,%u,%s,%s,%u\n", (unsigned long)start, local,
+                      record.counts[TIMER_PEE], record.counts[TIMER_POOP], record.counts[TIMER_OUTSIDE],
+                      average[0], average[1], record.longestGap);
+  }
+  if (length < 0 || (size_t)length >= size) {
+    return 0;
+  }
+  return (size_t)length;
+}
+
+void HistoryExport::drain() {
+  if (sendOffset >= sendLength) {
+    return;
+  }
+
+  // Never write more than the TCP buffer can take right now (write would block)
+  size_t space = (size_t)client.availableForWrite();
+  size_t length = min(space, sendLength - sendOffset);
+  if (length > 0) {
+    size_t written = client.write((const uint8_t*)buffer + sendOffset, length);
+    if (written > 0) {
+      sendOffset += written;
+      lastProgress = millis();
+      return;
+    }
+  }
+
+  if (millis() - lastProgress >= HISTORY_EXPORT_TIMEOUT) {
+    finish("stalled");
+  }
+}
+
+void HistoryExport::finish(const char* reason) {
+  client.stop();
+  active = false;
+  sendOffset = 0;
+  sendLength = 0;
+  DEBUG_PRINT("HistoryExport: ");
+  DEBUG_PRINT(reason);
+  DEBUG_PRINT(" after ");
+  DEBUG_PRINT(rows);
+  DEBUG_PRINTLN(" rows");
+}
@@ -0,0 +1,65 @@
+#ifndef HISTORY_EXPORT_H
+#define HISTORY_EXPORT_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include "config.h"
+#include "History.h"
+
+enum ExportFormat {
+  EXPORT_CSV = 0,
+  EXPORT_JSON = 1
+};
+
+// Streams history from flash to one HTTP client as a background task.
+// Memory use is one fixed chunk buffer regardless of the range exported;
+// each loop iteration reads at most HISTORY_EXPORT_READS_PER_LOOP records
+// and only writes what the socket accepts without blocking.
+class HistoryExport {
+public:
+  HistoryExport();
+
+  // Check if an export is running (only one at a time)
+  bool isBusy();
+
+  // Take over an HTTP connection and start streaming (response headers are sent here)
+  void start(WiFiClient& client, History* history, HistoryTier tier, ExportFormat format,
+             time_t from, time_t to);
+
+  // Send the next piece of the export (call every loop iteration)
+  void update();
+
+private:
+  WiFiClient client;
+  History* history;
+  bool active;
+  bool headerSent;           // Column header / JSON opening written
+  bool finished;             // Final chunk is in the buffer
+  HistoryTier tier;
+  ExportFormat format;
+  time_t from;
+  time_t to;
+  uint32_t position;         // Next raw sequence or rollup period
+  uint32_t end;              // Last raw sequence or rollup period
+  unsigned long rows;
+  unsigned long lastProgress;
+
+  char buffer[HISTORY_EXPORT_BUFFER_SIZE];
+  size_t sendOffset;         // Next byte of buffer to write
+  size_t sendLength;         // Bytes of buffer to write
+
+  // Fill the buffer with the next chunk of rows (or the final chunk)
+  void buildChunk();
+
+  // Format one record into line, returns length (0 = skip)
+  size_t formatEvent(const HistoryEvent& event, char* line, size_t size);
+  size_t formatRollup(const RollupRecord& record, char* line, size_t size);
+
+  // Write as much of the buffer as the socket accepts
+  void drain();
+
+  // Close the connection and free the task
+  void finish(const char* reason);
+};
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef HTTP_REQUEST_WRITER_H
+#define HTTP_REQUEST_WRITER_H
+
+// Outgoing HTTP/1.1 GET requests written straight into a client's send buffer.
+// The request line is streamed piece by piece - path segments as-is, query values
+// percent-encoded on the fly - through one small fixed buffer, so no URL String
+// is built and nothing is allocated per request or per character. Fixed parts
+// (method, path segments, parameter names) are read from flash (PSTR) - only
+// tokens and values live in RAM.
+// Plain C++ with no Arduino dependencies so it can be benchmarked on a Linux host
+// (see tools/http-bench). Output is any type with
+// size_t write(const uint8_t* data, size_t length), e.g. WiFiClientSecure.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "FlashStrings.h"
+
+#ifndef HTTP_WRITER_BUFFER_SIZE
+#define HTTP_WRITER_BUFFER_SIZE 64      // Bytes handed to the client per write
+#endif
+
+template <typename Output>
+class HttpRequestWriter {
+public:
+  explicit HttpRequestWriter(Output& output) :
+    output(output),
+    length(0),
+    written(0),
+    hasQuery(false),
+    failed(false),
+    hasRange(false),
+    rangeStart(0)
+  {
+  }
+
+  // Start the request line, e.g. begin(PSTR("GET"), PSTR("/bot"))
+  void begin(PGM_P method, PGM_P path) {
+    appendFlash(method);
+    put(' ');
+    appendFlash(path);
+  }
+
+  // Append to the path as-is (tokens)
+  void addPath(const char* path) {
+    append(path, strlen(path));
+  }
+
+  // Append a fixed path segment from flash
+  void addPath_P(PGM_P path) {
+    appendFlash(path);
+  }
+
+  // Append a query parameter (name in flash), value percent-encoded (spaces become '+')
+  void addQuery(PGM_P name, const char* value) {
+    put(hasQuery ? '&' : '?');
+    hasQuery = true;
+    appendFlash(name);
+    put('=');
+    appendEncoded(value);
+  }
+
+  void addQuery(PGM_P name, unsigned long value) {
+    put(hasQuery ? '&' : '?');
+    hasQuery = true;
+    appendFlash(name);
+    put('=');
+    appendNumber(value);
+  }
+
+  // Ask for the resource from a byte offset on (Range header, written by end())
+  void setRange(unsigned long start) {
+    hasRange = true;
+    rangeStart = start;
+  }
+
+  // Finish the request line and headers and hand the rest to the client
+  // Returns false if the client did not accept every byte
+  bool end(const char* host, bool keepAlive) {
+    appendFlash(PSTR(" HTTP/1.1\r\nHost: "));
+    append(host, strlen(host));
+    if (hasRange) {
+      appendFlash(PSTR("\r\nRange: bytes="));
+      appendNumber(rangeStart);
+      put('-');
+    }
+    appendFlash(keepAlive ? PSTR("\r\nConnection: keep-alive\r\n\r\n") : PSTR("\r\nConnection: close\r\n\r\n"));
+    flush();
+    return !failed;
+  }
+
+  // Bytes accepted by the client so far
+  size_t getWritten() const {
+    return written;
+  }
+
+private:
+  Output& output;
+  char buffer[HTTP_WRITER_BUFFER_SIZE];
+  size_t length;
+  size_t written;
+  bool hasQuery;
+  bool failed;
+  bool hasRange;
+  unsigned long rangeStart;
+
+  void put(char c) {
+    if (length == sizeof(buffer)) {
+      flush();
+    }
+    buffer[length++] = c;
+  }
+
+  void append(const char* text, size_t remaining) {
+    while (remaining > 0) {
+      if (length == sizeof(buffer)) {
+        flush();
+      }
+      size_t count = sizeof(buffer) - length;
+      if (count > remaining) {
+        count = remaining;
+      }
+      memcpy(buffer + length, text, count);
+      length += count;
+      text += count;
+      remaining -= count;
+    }
+  }
+
+  void appendFlash(PGM_P text) {
+    size_t remaining = strlen_P(text);
+    while (remaining > 0) {
+      if (length == sizeof(buffer)) {
+        flush();
+      }
+      size_t count = sizeof(buffer) - length;
+      if (count > remaining) {
+        count = remaining;
+      }
+      memcpy_P(buffer + length, text, count);
+      length += count;
+      text += count;
+      remaining -= count;
+    }
+  }
+
+  void appendNumber(unsigned long value) {
+    char digits[11];
+    int position = sizeof(digits) - 1;
+    digits[position] = '\0';
+    do {
+      digits[--position] = '0' + value % 10;
+      value /= 10;
+    } while (value > 0);
+    append(digits + position, sizeof(digits) - 1 - position);
+  }
+
+  void appendEncoded(const char* text) {
+    static const char hex[] PROGMEM = "0123456789ABCDEF";
+    for (; *text != '\0'; text++) {
+      uint8_t c = (uint8_t)*text;
+      if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+          c == '-' || c == '.' || c == '_' || c == '~') {
+        put((char)c);
+      } else if (c == ' ') {
+        put('+');
+      } else {
+        put('%');
+        put(pgm_read_byte(&hex[c >> 4]));
+        put(pgm_read_byte(&hex[c & 0x0F]));
+      }
+    }
+  }
+
+  void flush() {
+    if (length == 0 || failed) {
+      length = 0;
+      return;
+    }
+    size_t accepted = output.write((const uint8_t*)buffer, length);
+    if (accepted != length) {
+      failed = true;
+    }
+    written += accepted;
+    length = 0;
+  }
+};
+
+#endif
@@ -1,6 +1,19 @@
 #include "LEDController.h"
-
-LEDController::LEDController() : nightMode(false) {
+#include <core_esp8266_waveform.h>
+
+LEDController::LEDController() :
+  nightMode(false),
+  activeLed(LED_GREEN_STATUS),
+  effect(EFFECT_OFF),
+  onMs(0),
+  offMs(0),
+  patternStart(0),
+  level(255),
+  fadeFrom(255),
+  fadeTarget(255),
+  fadeStart(0),
+  ticking(false)
+{
 }
 
 void LEDController::begin() {
@@ -9,6 +22,10 @@ void LEDController::begin() {
   pinMode(PIN_LED_YELLOW, OUTPUT);
   pinMode(PIN_LED_RED, OUTPUT);
 
+  // Brightness values are 0-255 throughout
+  analogWriteRange(255);
+  analogWriteFreq(LED_PWM_FREQ);
+
   // Turn all LEDs off initially
   setLED(LED_GREEN_STATUS, LOW);
   setLED(LED_YELLOW_STATUS, LOW);
@@ -18,42 +35,161 @@ void LEDController::begin() {
 }
 
 void LEDController::update(TimerManager* timerManager) {
-  if (nightMode) {
-    // All LEDs off during night mode
-    setLED(LED_GREEN_STATUS, LOW);
-    setLED(LED_YELLOW_STATUS, LOW);
-    setLED(LED_RED_STATUS, LOW);
-    return;
+  switch (getAlertLevel(timerManager)) {
+    case ALERT_RED: {
+      // Strobe, faster the longer the alert is ignored
+      unsigned int period = getStrobePeriod(timerManager);
+      setPattern(LED_RED_STATUS, EFFECT_BLINK, LED_STROBE_FLASH_MS, period - LED_STROBE_FLASH_MS);
+      break;
+    }
+    case ALERT_YELLOW:
+      setPattern(LED_YELLOW_STATUS, EFFECT_BLINK, LED_BLINK_MS, LED_BLINK_MS);
+      break;
+    default:
+      // GREEN (all good)
+      setPattern(LED_GREEN_STATUS, POWER_SAVE_MODE == 2 ? EFFECT_SOLID : EFFECT_BREATHE, 0, 0);
+      break;
   }
+}
 
-  evaluateStatus(timerManager);
+unsigned int LEDController::getStrobePeriod(TimerManager* timerManager) {
+  extern unsigned int activeRedThreshold;
+
+  unsigned long peeMinutes = timerManager->getElapsed(TIMER_PEE) / 60;
+  unsigned long over = peeMinutes > activeRedThreshold ? peeMinutes - activeRedThreshold : 0;
+  if (over >= LED_STROBE_RAMP_MINUTES) {
+    return LED_STROBE_FAST_MS;
+  }
+  return LED_STROBE_SLOW_MS - (LED_STROBE_SLOW_MS - LED_STROBE_FAST_MS) * over / LED_STROBE_RAMP_MINUTES;
 }
 
-void LEDController::evaluateStatus(TimerManager* timerManager) {
+AlertLevel LEDController::getAlertLevel(TimerManager* timerManager) {
   // Get elapsed time in minutes for pee timer only
   unsigned long peeMinutes = timerManager->getElapsed(TIMER_PEE) / 60;
 
-  // Get runtime thresholds from main sketch
-  extern unsigned int yellowThreshold;
-  extern unsigned int redThreshold;
+  // Get thresholds in force from main sketch (static or predicted)
+  extern unsigned int activeYellowThreshold;
+  extern unsigned int activeRedThreshold;
 
   // Check RED condition first (highest priority)
-  if (peeMinutes > redThreshold) {
-    setLED(LED_RED_STATUS, HIGH);
-    setLED(LED_YELLOW_STATUS, LOW);
-    setLED(LED_GREEN_STATUS, LOW);
+  if (peeMinutes > activeRedThreshold) {
+    return ALERT_RED;
   }
-  // Check YELLOW condition
-  else if (peeMinutes > yellowThreshold) {
-    setLED(LED_RED_STATUS, LOW);
-    setLED(LED_YELLOW_STATUS, HIGH);
-    setLED(LED_GREEN_STATUS, LOW);
+  if (peeMinutes > activeYellowThreshold) {
+    return ALERT_YELLOW;
   }
-  // Default: GREEN (all good)
-  else {
-    setLED(LED_RED_STATUS, LOW);
-    setLED(LED_YELLOW_STATUS, LOW);
-    setLED(LED_GREEN_STATUS, HIGH);
+  return ALERT_GREEN;
+}
+
+const char* LEDController::getAlertName(AlertLevel level) {
+  switch (level) {
+    case ALERT_YELLOW:
+      return "yellow";
+    case ALERT_RED:
+      return "red";
+    default:
+      return "green";
+  }
+}
+
+void LEDController::setPattern(LED led, LedEffect newEffect, uint16_t newOnMs, uint16_t newOffMs) {
+  if (led == activeLed && newEffect == effect && newOnMs == onMs && newOffMs == offMs) {
+    return;
+  }
+
+  if (led != activeLed) {
+    setLED(activeLed, LOW);
+  }
+  activeLed = led;
+  effect = newEffect;
+  onMs = newOnMs;
+  offMs = newOffMs;
+  patternStart = millis();
+  apply();
+}
+
+void LEDController::apply() {
+  uint8_t pin = getPin(activeLed);
+
+  if (needsTicker()) {
+    startTicker();
+    tick();
+    return;
+  }
+
+  // Everything else holds by itself once set
+  stopTicker();
+  if (effect == EFFECT_OFF || level == 0) {
+    digitalWrite(pin, LOW);
+  } else if (effect == EFFECT_SOLID) {
+    analogWrite(pin, level);
+  } else {
+    // Full-brightness blinking is timed by the waveform generator
+    startWaveform(pin, onMs * 1000UL, offMs * 1000UL, 0);
+  }
+}
+
+bool LEDController::needsTicker() {
+  if (level != fadeTarget) {
+    return true;
+  }
+  // Breathing, or blinking dimmed (the waveform generator only does full on/off)
+  return level > 0 && (effect == EFFECT_BREATHE || (effect == EFFECT_BLINK && level < 255));
+}
+
+void LEDController::startTicker() {
+  if (!ticking) {
+    ticker.attach_ms(LED_TICK_MS, onTick, this);
+    ticking = true;
+  }
+}
+
+void LEDController::stopTicker() {
+  if (ticking) {
+    ticker.detach();
+    ticking = false;
+  }
+}
+
+void LEDController::onTick(LEDController* controller) {
+  controller->tick();
+}
+
+void LEDController::tick() {
+  unsigned long now = millis();
+
+  if (level != fadeTarget) {
+    unsigned long elapsed = now - fadeStart;
+    if (elapsed >= LED_NIGHT_FADE_MS) {
+      level = fadeTarget;
+    } else {
+      level = fadeFrom + ((int)fadeTarget - (int)fadeFrom) * (long)elapsed / LED_NIGHT_FADE_MS;
+    }
+  }
+
+  analogWrite(getPin(activeLed), patternBrightness(now - patternStart) * level / 255);
+
+  // Fade finished - a pattern that holds by itself no longer needs the Ticker
+  if (!needsTicker()) {
+    apply();
+  }
+}
+
+uint8_t LEDController::patternBrightness(unsigned long elapsed) {
+  switch (effect) {
+    case EFFECT_BREATHE: {
+      // Triangle wave squared (rough gamma correction), never quite dark
+      unsigned long phase = elapsed % LED_BREATHE_PERIOD;
+      unsigned long half = LED_BREATHE_PERIOD / 2;
+      unsigned long ramp = (phase < half ? phase : LED_BREATHE_PERIOD - phase) * 255 / half;
+      return LED_BREATHE_MIN + (255 - LED_BREATHE_MIN) * ramp * ramp / (255 * 255);
+    }
+    case EFFECT_BLINK:
+      return elapsed % (onMs + offMs) < onMs ? 255 : 0;
+    case EFFECT_SOLID:
+      return 255;
+    default:
+      return 0;
   }
 }
 
@@ -76,22 +212,19 @@ uint8_t LEDController::getPin(LED led) {
 }
 
 void LEDController::setNightMode(bool enabled) {
-  // Only log if state is actually changing
-  if (nightMode != enabled) {
-    nightMode = enabled;
-    if (enabled) {
-      // Turn all LEDs off when entering night mode
-      setLED(LED_GREEN_STATUS, LOW);
-      setLED(LED_YELLOW_STATUS, LOW);
-      setLED(LED_RED_STATUS, LOW);
-      DEBUG_PRINTLN("LEDController: Night mode ON");
-    } else {
-      // Exiting night mode - LEDs will be restored on next update() call
-      DEBUG_PRINTLN("LEDController: Night mode OFF");
-    }
-  } else {
-    nightMode = enabled;
+  // Only act if state is actually changing
+  if (nightMode == enabled) {
+    return;
   }
+  nightMode = enabled;
+
+  // Fade from wherever the brightness is now
+  fadeFrom = level;
+  fadeTarget = enabled ? LED_NIGHT_BRIGHTNESS : 255;
+  fadeStart = millis();
+  apply();
+
+  DEBUG_PRINTLN(enabled ? "LEDController: Night mode ON" : "LEDController: Night mode OFF");
 }
 
 void LEDController::test() {
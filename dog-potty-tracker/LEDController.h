@@ -2,6 +2,7 @@
 #define LED_CONTROLLER_H
 
 #include <Arduino.h>
+#include <Ticker.h>
 #include "config.h"
 #include "TimerManager.h"
 
@@ -11,6 +12,21 @@ enum LED {
   LED_RED_STATUS = 2
 };
 
+// Alert level derived from the pee timer and the runtime thresholds
+enum AlertLevel {
+  ALERT_GREEN = 0,
+  ALERT_YELLOW = 1,
+  ALERT_RED = 2
+};
+
+// What the active LED does (one LED is lit at a time)
+enum LedEffect {
+  EFFECT_OFF = 0,
+  EFFECT_BREATHE = 1,   // Slow fade up and down (green)
+  EFFECT_BLINK = 2,     // On/off, also the red strobe
+  EFFECT_SOLID = 3      // Steady (green with light sleep - breathing would keep the CPU awake)
+};
+
 class LEDController {
 public:
   LEDController();
@@ -18,24 +34,67 @@ public:
   // Initialize LED pins
   void begin();
 
-  // Update LED status based on timer values
+  // Pick the pattern for the current alert level. Only touches the pins when the
+  // pattern changes - the effects run on the waveform generator or a Ticker.
   void update(TimerManager* timerManager);
 
-  // Set night mode (all LEDs off)
+  // Set night mode (LEDs fade to LED_NIGHT_BRIGHTNESS)
   void setNightMode(bool enabled);
 
   // Test all LEDs (startup sequence)
   void test();
 
+  // Get current alert level (same rules as the LEDs)
+  static AlertLevel getAlertLevel(TimerManager* timerManager);
+
+  // Get lowercase name of an alert level ("green", "yellow", "red")
+  static const char* getAlertName(AlertLevel level);
+
+  // Red flash period: LED_STROBE_SLOW_MS at the threshold, down to LED_STROBE_FAST_MS
+  // LED_STROBE_RAMP_MINUTES later (ms)
+  static unsigned int getStrobePeriod(TimerManager* timerManager);
+
 private:
   bool nightMode;
 
+  // Pattern being shown
+  LED activeLed;
+  LedEffect effect;
+  uint16_t onMs;
+  uint16_t offMs;
+  unsigned long patternStart;
+
+  // Brightness limit (0-255), faded over LED_NIGHT_FADE_MS when night mode changes
+  uint8_t level;
+  uint8_t fadeFrom;
+  uint8_t fadeTarget;
+  unsigned long fadeStart;
+
+  // Steps breathing, fades and dimmed blinking every LED_TICK_MS (SDK timer, not loop())
+  Ticker ticker;
+  bool ticking;
+
+  // Show a pattern (no-op if it is already showing)
+  void setPattern(LED led, LedEffect newEffect, uint16_t newOnMs, uint16_t newOffMs);
+
+  // Hand the pattern to the cheapest output that can show it: a plain pin level,
+  // the waveform generator (blinking at full brightness) or the Ticker
+  void apply();
+
+  // Brightness has to be recomputed while the pattern runs
+  bool needsTicker();
+
+  void startTicker();
+  void stopTicker();
+  static void onTick(LEDController* controller);
+  void tick();
+
+  // Brightness of the pattern at a time since it started (0-255)
+  uint8_t patternBrightness(unsigned long elapsed);
+
   // Set individual LED state
   void setLED(LED led, bool state);
 
-  // Evaluate timer status and set LEDs
-  void evaluateStatus(TimerManager* timerManager);
-
   // Get GPIO pin for LED
   uint8_t getPin(LED led);
 };
@@ -0,0 +1,108 @@
+#ifndef LARGE_FONT_H
+#define LARGE_FONT_H
+
+// Large digits for the single-timer view, copied straight into the SSD1306 buffer.
+// Glyphs are stored in flash already packed in display page order (LargeFontData.h,
+// generated by tools/large-font), so drawing a character is one byte store per
+// column and page instead of a scaled 5x7 glyph drawn pixel by pixel.
+// Plain C++ with no Arduino dependencies so it can be benchmarked on a Linux host
+// (see tools/display-bench).
+
+#include <stdint.h>
+#include <string.h>
+
+#include "FlashStrings.h"
+#include "LargeFontData.h"
+
+#define LARGE_FONT_SPACING 2   // Blank columns after each glyph
+#define LARGE_FONT_SPACE 6     // Width of ' '
+
+class LargeFont {
+public:
+  // Width in pixels of text drawn with draw() (characters without a glyph are skipped)
+  static int measure(const char* text) {
+    int width = 0;
+    for (; *text != '\0'; text++) {
+      int glyph = findGlyph(*text);
+      if (glyph >= 0) {
+        width += pgm_read_byte(&LARGE_FONT_WIDTHS[glyph]) + LARGE_FONT_SPACING;
+      } else if (*text == ' ') {
+        width += LARGE_FONT_SPACE;
+      }
+    }
+    return width > 0 ? width - LARGE_FONT_SPACING : 0;
+  }
+
+  // Draw text into an SSD1306 buffer (width x height pixels, one byte = 8 rows of a column)
+  // at column x, from display page `page` down. Glyph columns overwrite the buffer; the
+  // gaps between glyphs are left as they are (draw onto a cleared buffer).
+  // rotated = display turned 180 degrees (Adafruit_SSD1306::setRotation(2))
+  // Returns the column after the text
+  static int draw(uint8_t* buffer, int width, int height, int x, int page, const char* text, bool rotated) {
+    int pages = height / 8;
+    for (; *text != '\0'; text++) {
+      int glyph = findGlyph(*text);
+      if (glyph < 0) {
+        if (*text == ' ') {
+          x += LARGE_FONT_SPACE;
+        }
+        continue;
+      }
+
+      int glyphWidth = pgm_read_byte(&LARGE_FONT_WIDTHS[glyph]);
+      const uint8_t* bitmap = LARGE_FONT_BITMAPS + pgm_read_word(&LARGE_FONT_OFFSETS[glyph]);
+      int columns = glyphWidth;
+      if (x + columns > width) {
+        columns = width - x;
+      }
+
+      for (int p = 0; p < LARGE_FONT_PAGES && page + p < pages; p++) {
+        const uint8_t* source = bitmap + p * glyphWidth;
+        if (rotated) {
+          // Mirrored column order, bottom page first, bit order reversed
+          uint8_t* target = buffer + (pages - 1 - page - p) * width + (width - 1 - x);
+          for (int c = 0; c < columns; c++) {
+            *target-- = reverseBits(pgm_read_byte(source + c));
+          }
+        } else {
+          uint8_t* target = buffer + (page + p) * width + x;
+          for (int c = 0; c < columns; c++) {
+            *target++ = pgm_read_byte(source + c);
+          }
+        }
+      }
+
+      x += glyphWidth + LARGE_FONT_SPACING;
+      if (x >= width) {
+        break;
+      }
+    }
+    return x;
+  }
+
+  // Index of a byte in the buffer for display column x and page (for copying page-aligned areas)
+  static int bufferIndex(int width, int height, int x, int page, bool rotated) {
+    if (rotated) {
+      return (height / 8 - 1 - page) * width + (width - 1 - x);
+    }
+    return page * width + x;
+  }
+
+private:
+  static int findGlyph(char c) {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    }
+    const char* found = strchr(LARGE_FONT_CHARS + 10, c);
+    return (found != nullptr && c != '\0') ? (int)(found - LARGE_FONT_CHARS) : -1;
+  }
+
+  static uint8_t reverseBits(uint8_t value) {
+    static const uint8_t nibbles[16] = {
+      0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+    };
+    return (nibbles[value & 0x0F] << 4) | nibbles[value >> 4];
+  }
+};
+
+#endif
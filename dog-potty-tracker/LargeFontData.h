@@ -0,0 +1,354 @@
+#ifndef LARGE_FONT_DATA_H
+#define LARGE_FONT_DATA_H
+
+// Generated by tools/large-font/make_large_font.py - do not edit
+// Glyph bytes are page by page (top page first), one byte per column, LSB = top row
+
+#define LARGE_FONT_HEIGHT 24
+#define LARGE_FONT_PAGES 3
+#define LARGE_FONT_CHARS "0123456789hm"
+
+static const uint8_t LARGE_FONT_BITMAPS[] PROGMEM = {
+  // '0'
+  //   ......##......
+  //   ....######....
+  //   ...########...
+  //   ..##########..
+  //   .############.
+  //   .####....####.
+  //   .####....####.
+  //   #####....#####
+  //   #####....#####
+  //   #####....#####
+  //   #####....#####
+  //   ####.....#####
+  //   ####.....#####
+  //   ####.....#####
+  //   #####....#####
+  //   #####....#####
+  //   #####....#####
+  //   .####....####.
+  //   .####....####.
+  //   .#####..#####.
+  //   ..##########..
+  //   ..##########..
+  //   ...########...
+  //   ....######....
+  0x80, 0xF0, 0xF8, 0xFC, 0xFE, 0x1E, 0x1F, 0x1F, 0x1E, 0xFE, 0xFC, 0xF8, 0xF0, 0x80, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xC7, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x0F, 0x3F, 0x7F,
+  0xFF, 0xF8, 0xF0, 0xF0, 0xF8, 0xFF, 0x7F, 0x3F, 0x0F, 0x01,
+  // '1'
+  //   ..............
+  //   ...######.....
+  //   .########.....
+  //   .########.....
+  //   .########.....
+  //   .###.####.....
+  //   .....####.....
+  //   .....####.....
+  //   .....####.....
+  //   .....####.....
+  //   .....####.....
+  //   .....####.....
+  //   .....####.....
+  //   .....####.....
+  //   .....####.....
+  //   .....####.....
+  //   .....####.....
+  //   .....####.....
+  //   .....####.....
+  //   .############.
+  //   .############.
+  //   .############.
+  //   .############.
+  //   ..###########.
+  0x00, 0x3C, 0x3C, 0x3E, 0x1E, 0xFE, 0xFE, 0xFE, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x78, 0xF8, 0xF8,
+  0xF8, 0xFF, 0xFF, 0xFF, 0xFF, 0xF8, 0xF8, 0xF8, 0xF8, 0x00,
+  // '2'
+  //   .....###......
+  //   ..########....
+  //   .###########..
+  //   .###########..
+  //   .############.
+  //   .##.....#####.
+  //   ........#####.
+  //   .........####.
+  //   .........####.
+  //   ........#####.
+  //   ........####..
+  //   .......#####..
+  //   ......#####...
+  //   ......#####...
+  //   .....#####....
+  //   ....#####.....
+  //   ...#####......
+  //   ..#####.......
+  //   .#####........
+  //   .############.
+  //   .############.
+  //   .############.
+  //   .############.
+  //   .############.
+  0x00, 0x3C, 0x3E, 0x1E, 0x1E, 0x1F, 0x1F, 0x1F, 0x7E, 0xFE, 0xFC, 0xFC, 0xF0, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0xC0, 0xF0, 0xF8, 0xFE, 0x7F, 0x3F, 0x0F, 0x03, 0x00, 0x00, 0xFC, 0xFE, 0xFF,
+  0xFF, 0xFF, 0xFB, 0xF9, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0x00,
+  // '3'
+  //   .....###......
+  //   ..#########...
+  //   .###########..
+  //   .############.
+  //   .############.
+  //   ........#####.
+  //   ........#####.
+  //   .........####.
+  //   ........#####.
+  //   .......#####..
+  //   ....#######...
+  //   ....#######...
+  //   ....########..
+  //   ....#########.
+  //   ........#####.
+  //   .........####.
+  //   .........####.
+  //   .........####.
+  //   .........####.
+  //   .##....######.
+  //   .############.
+  //   .###########..
+  //   .##########...
+  //   ..#######.....
+  0x00, 0x1C, 0x1E, 0x1E, 0x1E, 0x1F, 0x1F, 0x1F, 0x7E, 0xFE, 0xFE, 0xFC, 0xF8, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x3C, 0x3C, 0x3C, 0x3E, 0x7F, 0xFF, 0xFF, 0xF3, 0xE1, 0x00, 0x00, 0x78, 0xF8, 0xF0,
+  0xF0, 0xF0, 0xF0, 0xF8, 0xF8, 0x7F, 0x7F, 0x3F, 0x1F, 0x00,
+  // '4'
+  //   ..............
+  //   ......######..
+  //   ......######..
+  //   .....#######..
+  //   .....#######..
+  //   ....########..
+  //   ....########..
+  //   ...#########..
+  //   ...###.#####..
+  //   ..####.#####..
+  //   ..###..#####..
+  //   .####..#####..
+  //   .###...#####..
+  //   ####...#####..
+  //   ###....#####..
+  //   ##############
+  //   ##############
+  //   ##############
+  //   ##############
+  //   .......#####..
+  //   .......#####..
+  //   .......#####..
+  //   .......#####..
+  //   ........###...
+  0x00, 0x00, 0x00, 0x80, 0xE0, 0xF8, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0x00, 0x00, 0xE0, 0xF8,
+  0xFE, 0xBF, 0x8F, 0x83, 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x80, 0x07, 0x07, 0x07, 0x07,
+  0x07, 0x07, 0x07, 0x7F, 0xFF, 0xFF, 0xFF, 0x7F, 0x07, 0x07,
+  // '5'
+  //   ..............
+  //   .###########..
+  //   .###########..
+  //   .###########..
+  //   .###########..
+  //   .####.........
+  //   .####.........
+  //   .####.........
+  //   .########.....
+  //   .##########...
+  //   .###########..
+  //   .###########..
+  //   .####.#######.
+  //   ........#####.
+  //   .........####.
+  //   .........####.
+  //   .........####.
+  //   .........####.
+  //   .#......#####.
+  //   .###...######.
+  //   .###########..
+  //   .###########..
+  //   .##########...
+  //   ...######.....
+  0x00, 0xFE, 0xFE, 0xFE, 0xFE, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x00, 0x00, 0x00, 0x1F,
+  0x1F, 0x1F, 0x1F, 0x0F, 0x1F, 0x1F, 0x3F, 0xFE, 0xFE, 0xFC, 0xF0, 0x00, 0x00, 0x7C, 0x78, 0xF8,
+  0xF0, 0xF0, 0xF0, 0xF8, 0xFC, 0x7F, 0x7F, 0x3F, 0x0F, 0x00,
+  // '6'
+  //   .......##.....
+  //   ....########..
+  //   ...##########.
+  //   ..###########.
+  //   ..######.####.
+  //   .#####........
+  //   .####.........
+  //   .####.........
+  //   .####.........
+  //   ###########...
+  //   ############..
+  //   #############.
+  //   #######.#####.
+  //   ######...####.
+  //   #####....#####
+  //   #####....#####
+  //   .####....#####
+  //   .####....#####
+  //   .####....####.
+  //   .#####...####.
+  //   ..###########.
+  //   ..##########..
+  //   ...########...
+  //   .....#####....
+  0x00, 0xE0, 0xF8, 0xFC, 0xFE, 0x3E, 0x1E, 0x1F, 0x0F, 0x1E, 0x1E, 0x1E, 0x1C, 0x00, 0xFE, 0xFF,
+  0xFF, 0xFF, 0xFF, 0x3E, 0x1E, 0x0E, 0x1E, 0xFE, 0xFE, 0xFC, 0xF8, 0xC0, 0x00, 0x0F, 0x3F, 0x7F,
+  0x7F, 0xF8, 0xF0, 0xF0, 0xF0, 0xFF, 0x7F, 0x3F, 0x1F, 0x03,
+  // '7'
+  //   ..............
+  //   .############.
+  //   .############.
+  //   .############.
+  //   .############.
+  //   ........#####.
+  //   ........#####.
+  //   ........####..
+  //   ........####..
+  //   .......#####..
+  //   .......####...
+  //   .......####...
+  //   ......#####...
+  //   ......####....
+  //   ......####....
+  //   .....#####....
+  //   .....####.....
+  //   .....####.....
+  //   ....#####.....
+  //   ....####......
+  //   ....####......
+  //   ...#####......
+  //   ...####.......
+  //   ...###........
+  0x00, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0xFE, 0xFE, 0xFE, 0xFE, 0x7E, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x80, 0xF0, 0xFE, 0xFF, 0xFF, 0x1F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0,
+  0xFC, 0xFF, 0x7F, 0x3F, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00,
+  // '8'
+  //   ......##......
+  //   ...########...
+  //   ..##########..
+  //   .############.
+  //   .#####..#####.
+  //   .####....####.
+  //   .####....####.
+  //   .####....####.
+  //   .####....####.
+  //   .#####..#####.
+  //   ..##########..
+  //   ...########...
+  //   ..##########..
+  //   .############.
+  //   .####....####.
+  //   #####....####.
+  //   #####....#####
+  //   #####....#####
+  //   #####....#####
+  //   .####....####.
+  //   .############.
+  //   .############.
+  //   ..##########..
+  //   ....######....
+  0x00, 0xF8, 0xFC, 0xFE, 0xFE, 0x1E, 0x0F, 0x0F, 0x1E, 0xFE, 0xFE, 0xFC, 0xF8, 0x00, 0x80, 0xE3,
+  0xF7, 0xFF, 0xFF, 0x3E, 0x3C, 0x3C, 0x3E, 0xFF, 0xFF, 0xF7, 0xE3, 0x00, 0x07, 0x3F, 0x7F, 0x7F,
+  0xFF, 0xF0, 0xF0, 0xF0, 0xF0, 0xFF, 0x7F, 0x7F, 0x3F, 0x07,
+  // '9'
+  //   ......##......
+  //   ...#######....
+  //   ..#########...
+  //   .###########..
+  //   .#####..#####.
+  //   .####....####.
+  //   #####....####.
+  //   #####....####.
+  //   #####....#####
+  //   #####....#####
+  //   #####....#####
+  //   .####...######
+  //   .#############
+  //   ..############
+  //   ..############
+  //   ....####.#####
+  //   .........####.
+  //   .........####.
+  //   ........#####.
+  //   .##....#####..
+  //   .###########..
+  //   .##########...
+  //   .#########....
+  //   ...######.....
+  0xC0, 0xF8, 0xFC, 0xFE, 0xFE, 0x1E, 0x0F, 0x0F, 0x1E, 0xFE, 0xFC, 0xF8, 0xF0, 0x00, 0x07, 0x1F,
+  0x7F, 0x7F, 0xFF, 0xF0, 0xF0, 0xF0, 0x78, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x78, 0x78, 0xF0,
+  0xF0, 0xF0, 0xF0, 0xF8, 0xFC, 0x7F, 0x3F, 0x1F, 0x07, 0x00,
+  // 'h'
+  //   ####.........
+  //   ####.........
+  //   ####.........
+  //   ####.........
+  //   ####.........
+  //   ####.........
+  //   ####...###...
+  //   ####.#######.
+  //   ############.
+  //   #############
+  //   ######..#####
+  //   #####...#####
+  //   #####....####
+  //   ####.....####
+  //   ####.....####
+  //   ####.....####
+  //   ####.....####
+  //   ####.....####
+  //   ####.....####
+  //   ####.....####
+  //   ####.....####
+  //   ####.....####
+  //   ####.....####
+  //   ####.....####
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x80, 0x80, 0xC0, 0xC0, 0xC0, 0x80, 0x80, 0x00, 0xFF, 0xFF, 0xFF,
+  0xFF, 0x1F, 0x07, 0x03, 0x03, 0x0F, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+  // 'm'
+  //   ....................
+  //   ....................
+  //   ....................
+  //   ....................
+  //   ....................
+  //   ....................
+  //   ####..###.....###...
+  //   ####.######..######.
+  //   ###########.#######.
+  //   ####################
+  //   ######.#######.#####
+  //   #####...#####...####
+  //   ####....####....####
+  //   ####....####....####
+  //   ####....####....####
+  //   ####....####....####
+  //   ####....####....####
+  //   ####....####....####
+  //   ####....####....####
+  //   ####....####....####
+  //   ####....####....####
+  //   ####....####....####
+  //   ####....####....####
+  //   ####....####....####
+  0xC0, 0xC0, 0xC0, 0xC0, 0x00, 0x80, 0xC0, 0xC0, 0xC0, 0x80, 0x80, 0x00, 0x00, 0x80, 0xC0, 0xC0,
+  0xC0, 0x80, 0x80, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0x07, 0x03, 0x07, 0xFF, 0xFF, 0xFF, 0xFE,
+  0x0F, 0x07, 0x03, 0x07, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const uint8_t LARGE_FONT_WIDTHS[] PROGMEM = {14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 13, 20};
+static const uint16_t LARGE_FONT_OFFSETS[] PROGMEM = {0, 42, 84, 126, 168, 210, 252, 294, 336, 378, 420, 459};
+
+#endif
@@ -0,0 +1,236 @@
+#include "MqttManager.h"
+#include "EventLog.h"
+
+#if MQTT_ENABLED
+
+static const char* TIMER_TOPICS[] = {"state/outside", "state/pee", "state/poop"};
+
+MqttManager::MqttManager() :
+  client(wifiClient),
+  host(nullptr),
+  user(nullptr),
+  password(nullptr),
+  lastConnectAttempt(0),
+  commandCallback(nullptr),
+  outboxHead(0),
+  outboxCount(0),
+  stateDirty(true),
+  lastAlertLevel(-1)
+{
+  clientId[0] = '\0';
+  topicBase[0] = '\0';
+}
+
+void MqttManager::begin(const char* host, const char* user, const char* password) {
+  this->host = host;
+  this->user = user;
+  this->password = password;
+
+  // Stable client ID so the broker keeps our session (and queued QoS 1 commands)
+  snprintf(clientId, sizeof(clientId), "dpt-%06x", (unsigned int)ESP.getChipId());
+  snprintf(topicBase, sizeof(topicBase), "%s/%s", MQTT_TOPIC_PREFIX, clientId);
+
+  client.setServer(host, MQTT_PORT);
+  client.setKeepAlive(MQTT_KEEPALIVE);
+  client.setBufferSize(MQTT_BUFFER_SIZE);
+  client.setCallback([this](char* topic, uint8_t* payload, unsigned int length) {
+    handleMessage(topic, payload, length);
+  });
+
+  DEBUG_PRINT("MqttManager: Broker ");
+  DEBUG_PRINT(host);
+  DEBUG_PRINT(", topics under ");
+  DEBUG_PRINTLN(topicBase);
+}
+
+void MqttManager::update(TimerManager* timerManager) {
+  if (host == nullptr || strlen(host) == 0 || WiFi.status() != WL_CONNECTED) {
+    return;
+  }
+
+  if (!client.connected()) {
+    if (millis() - lastConnectAttempt < MQTT_RECONNECT_INTERVAL && lastConnectAttempt != 0) {
+      return;
+    }
+    lastConnectAttempt = millis();
+    if (!connect()) {
+      return;
+    }
+  }
+
+  // Process incoming packets (commands) and keepalive
+  client.loop();
+
+  // Alert level moved (threshold crossed or pee timer reset)
+  int alertLevel = LEDController::getAlertLevel(timerManager);
+  if (alertLevel != lastAlertLevel) {
+    stateDirty = true;
+  }
+
+  if (stateDirty && publishState(timerManager)) {
+    stateDirty = false;
+    lastAlertLevel = alertLevel;
+  }
+
+  flushOutbox();
+}
+
+bool MqttManager::isConnected() {
+  return client.connected();
+}
+
+void MqttManager::publishTimerChange(Timer timer, time_t timestamp) {
+  // Drop the oldest event if the broker has been away for a long time
+  if (outboxCount == MQTT_OUTBOX_SIZE) {
+    outboxHead = (outboxHead + 1) % MQTT_OUTBOX_SIZE;
+    outboxCount--;
+    DEBUG_PRINTLN("MqttManager: Outbox full - dropped oldest event");
+  }
+
+  MqttOutboxEntry& entry = outbox[(outboxHead + outboxCount) % MQTT_OUTBOX_SIZE];
+  memset(&entry, 0, sizeof(entry));
+  entry.timestamp = (uint32_t)timestamp;
+  entry.timer = (uint8_t)timer;
+  outboxCount++;
+
+  // Retained timestamps are rebuilt from TimerManager, so they are never lost
+  stateDirty = true;
+}
+
+void MqttManager::setCommandCallback(MqttCommandCallback callback) {
+  commandCallback = callback;
+}
+
+int MqttManager::getOutbox(MqttOutboxEntry* entries) {
+  for (int i = 0; i < outboxCount; i++) {
+    entries[i] = outbox[(outboxHead + i) % MQTT_OUTBOX_SIZE];
+  }
+  return outboxCount;
+}
+
+void MqttManager::restoreOutbox(const MqttOutboxEntry* entries, int count) {
+  outboxHead = 0;
+  outboxCount = 0;
+  for (int i = 0; i < count && i < MQTT_OUTBOX_SIZE; i++) {
+    if (entries[i].timer < 3) {
+      outbox[outboxCount++] = entries[i];
+    }
+  }
+  if (outboxCount > 0) {
+    DEBUG_PRINT(F("MqttManager: Restored "));
+    DEBUG_PRINT(outboxCount);
+    DEBUG_PRINTLN(F(" unpublished event(s)"));
+  }
+}
+
+bool MqttManager::connect() {
+  char willTopic[64];
+  buildTopic(willTopic, sizeof(willTopic), "online");
+
+  DEBUG_PRINT("MqttManager: Connecting as ");
+  DEBUG_PRINTLN(clientId);
+
+  // cleanSession = false: broker redelivers QoS 1 commands sent while we were offline
+  bool ok = client.connect(clientId,
+                           strlen(user) > 0 ? user : nullptr,
+                           strlen(password) > 0 ? password : nullptr,
+                           willTopic, 1, true, "0", false);
+  if (!ok) {
+    DEBUG_PRINT("MqttManager: Connect failed (state ");
+    DEBUG_PRINT(client.state());
+    DEBUG_PRINTLN(")");
+    return false;
+  }
+
+  client.publish(willTopic, "1", true);
+
+  char cmdTopic[64];
+  buildTopic(cmdTopic, sizeof(cmdTopic), "cmd");
+  client.subscribe(cmdTopic, 1);
+
+  // Broker may have restarted without persistence - publish retained state again
+  stateDirty = true;
+
+  DEBUG_PRINTLN("MqttManager: Connected");
+  return true;
+}
+
+bool MqttManager::publishState(TimerManager* timerManager) {
+  char topic[64];
+  char payload[24];
+
+  for (int i = 0; i < 3; i++) {
+    buildTopic(topic, sizeof(topic), TIMER_TOPICS[i]);
+    snprintf(payload, sizeof(payload), "%lu", (unsigned long)timerManager->getTimestamp((Timer)i));
+    if (!client.publish(topic, payload, true)) {
+      return false;
+    }
+  }
+
+  buildTopic(topic, sizeof(topic), "alert");
+  return client.publish(topic, LEDController::getAlertName(LEDController::getAlertLevel(timerManager)), true);
+}
+
+void MqttManager::flushOutbox() {
+  char topic[64];
+  char payload[48];
+  buildTopic(topic, sizeof(topic), "events");
+
+  while (outboxCount > 0) {
+    MqttOutboxEntry& entry = outbox[outboxHead];
+    snprintf(payload, sizeof(payload), "{\"timer\":\"%s\",\"ts\":%lu}",
+             EventLog::getTimerName(entry.timer), (unsigned long)entry.timestamp);
+
+    // Keep the event for the next attempt if the socket refused it
+    if (!client.publish(topic, payload, false)) {
+      return;
+    }
+
+    outboxHead = (outboxHead + 1) % MQTT_OUTBOX_SIZE;
+    outboxCount--;
+  }
+}
+
+void MqttManager::handleMessage(char* topic, uint8_t* payload, unsigned int length) {
+  if (commandCallback == nullptr) {
+    return;
+  }
+
+  char resultTopic[64];
+  buildTopic(resultTopic, sizeof(resultTopic), "cmd/result");
+
+  // Refuse rather than cut off - a truncated command could still match something else
+  char command[MQTT_COMMAND_SIZE];
+  if (length >= sizeof(command)) {
+    DEBUG_PRINTLN(F("MqttManager: Command too long - refused"));
+    client.publish(resultTopic, "Command too long", false);
+    return;
+  }
+  memcpy(command, payload, length);
+  command[length] = '\0';
+
+  DEBUG_PRINT("MqttManager: Received command: ");
+  DEBUG_PRINTLN(command);
+
+  // Unlike Telegram, MQTT can reply cheaply over the open connection
+  String response;
+  commandCallback(String(command), response);
+
+  // PubSubClient drops a packet larger than its buffer (fixed header 5 + topic length 2 + topic)
+  size_t maxReply = MQTT_BUFFER_SIZE - 7 - strlen(resultTopic);
+  if (response.length() > maxReply) {
+    DEBUG_PRINT(F("MqttManager: Reply truncated from "));
+    DEBUG_PRINT(response.length());
+    DEBUG_PRINTLN(F(" bytes"));
+    response.remove(maxReply);
+  }
+  if (!client.publish(resultTopic, response.c_str(), false)) {
+    DEBUG_PRINTLN(F("MqttManager: Reply could not be published"));
+  }
+}
+
+void MqttManager::buildTopic(char* buffer, size_t size, const char* suffix) {
+  snprintf(buffer, size, "%s/%s", topicBase, suffix);
+}
+
+#endif  // MQTT_ENABLED
@@ -0,0 +1,89 @@
+#ifndef MQTT_MANAGER_H
+#define MQTT_MANAGER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Timer event waiting to be published (also kept in the RTC hot state, so no padding)
+struct __attribute__((packed)) MqttOutboxEntry {
+  uint32_t timestamp;
+  uint8_t timer;
+  uint8_t reserved[3];
+};
+
+// Only compiled when enabled, so the PubSubClient library is optional
+#if MQTT_ENABLED
+
+#include <ESP8266WiFi.h>
+#include <PubSubClient.h>
+#include "TimerManager.h"
+#include "LEDController.h"
+
+// Callback type for executing commands received over MQTT
+// Returns true if the command was recognized, response holds the reply text
+typedef bool (*MqttCommandCallback)(String command, String& response);
+
+class MqttManager {
+public:
+  MqttManager();
+
+  // Configure broker (connection happens in update() once WiFi is up)
+  void begin(const char* host, const char* user, const char* password);
+
+  // Keep connection alive, flush outbox, publish alert changes (call every loop iteration)
+  void update(TimerManager* timerManager);
+
+  // Check if connected to the broker
+  bool isConnected();
+
+  // Queue a timer change (retained state + event)
+  void publishTimerChange(Timer timer, time_t timestamp);
+
+  // Set callback for commands received on the cmd topic
+  void setCommandCallback(MqttCommandCallback callback);
+
+  // Copy unpublished events, oldest first, for the RTC hot state (returns the count)
+  int getOutbox(MqttOutboxEntry* entries);
+
+  // Queue events saved before a warm reset again
+  void restoreOutbox(const MqttOutboxEntry* entries, int count);
+
+private:
+  WiFiClient wifiClient;
+  PubSubClient client;
+  const char* host;
+  const char* user;
+  const char* password;
+  char clientId[16];
+  char topicBase[48];
+  unsigned long lastConnectAttempt;
+  MqttCommandCallback commandCallback;
+
+  // Events not yet handed to the broker (oldest first)
+  MqttOutboxEntry outbox[MQTT_OUTBOX_SIZE];
+  int outboxHead;
+  int outboxCount;
+
+  // Retained state that still has to be (re)published
+  bool stateDirty;
+  int lastAlertLevel;
+
+  // Connect to broker, subscribe and mark retained state for republishing
+  bool connect();
+
+  // Publish retained timer timestamps and alert level
+  bool publishState(TimerManager* timerManager);
+
+  // Publish queued events, stops at the first failure
+  void flushOutbox();
+
+  // Handle an incoming message on the cmd topic
+  void handleMessage(char* topic, uint8_t* payload, unsigned int length);
+
+  // Build "<prefix>/<id>/<suffix>" into buffer
+  void buildTopic(char* buffer, size_t size, const char* suffix);
+};
+
+#endif  // MQTT_ENABLED
+
+#endif
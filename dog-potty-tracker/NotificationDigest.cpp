@@ -0,0 +1,278 @@
+#include "NotificationDigest.h"
+
+static const char* const PRESS_VERBS[] = {"went outside", "peed", "pooped"};
+
+NotificationDigest::NotificationDigest() :
+  dogName(""),
+  sendCallback(nullptr),
+  nextRecipient(0),
+  windowStart(0),
+  lastAdd(0)
+{
+  memset(&state, 0, sizeof(state));
+  for (int i = 0; i < TELEGRAM_MAX_RECIPIENTS; i++) {
+    recipients[i].enabled = false;
+    recipients[i].tokens = NOTIFY_BUDGET_MESSAGES;
+    recipients[i].failures = 0;
+    recipients[i].lastRefill = 0;
+    recipients[i].retryAt = 0;
+  }
+}
+
+void NotificationDigest::begin(const char* dogName, NotifySendCallback callback) {
+  this->dogName = dogName;
+  sendCallback = callback;
+}
+
+void NotificationDigest::setRecipientEnabled(uint8_t recipient, bool enabled) {
+  if (recipient < TELEGRAM_MAX_RECIPIENTS) {
+    recipients[recipient].enabled = enabled;
+  }
+}
+
+void NotificationDigest::add(Timer timer, time_t timestamp) {
+  // First press after the last window closed opens a new one
+  if (state.newestSequence == state.sealedSequence) {
+    windowStart = millis();
+  }
+  lastAdd = millis();
+
+  state.newestSequence++;
+  uint32_t slot = state.newestSequence % NOTIFY_EVENT_BUFFER;
+  state.timestamps[slot] = (uint32_t)timestamp;
+  state.timers[slot] = (uint8_t)timer;
+
+  DEBUG_PRINT("NotificationDigest: Collected ");
+  DEBUG_PRINT(PRESS_VERBS[timer]);
+  DEBUG_PRINT(" (");
+  DEBUG_PRINT(state.newestSequence - state.sealedSequence);
+  DEBUG_PRINTLN(" in window)");
+}
+
+int NotificationDigest::update() {
+  sealWindow();
+  if (sendCallback == nullptr) {
+    return 0;
+  }
+
+  // One send per call - each one is a blocking HTTPS request
+  for (int k = 0; k < TELEGRAM_MAX_RECIPIENTS; k++) {
+    uint8_t i = (nextRecipient + k) % TELEGRAM_MAX_RECIPIENTS;
+    Recipient& recipient = recipients[i];
+
+    if (!recipient.enabled) {
+      state.delivered[i] = state.sealedSequence;
+      continue;
+    }
+    if (state.delivered[i] >= state.sealedSequence) {
+      continue;
+    }
+    if (recipient.retryAt != 0 && (long)(millis() - recipient.retryAt) < 0) {
+      continue;
+    }
+
+    // Out of budget - presses stay queued and merge into the next digest
+    refillBudget(recipient);
+    if (recipient.tokens == 0) {
+      continue;
+    }
+
+    char message[NOTIFY_MESSAGE_SIZE];
+    formatDigest(state.delivered[i], state.sealedSequence, message, sizeof(message));
+    nextRecipient = (i + 1) % TELEGRAM_MAX_RECIPIENTS;
+
+    DEBUG_PRINT(F("NotificationDigest: Sending to user "));
+    DEBUG_PRINT(i + 1);
+    DEBUG_PRINT(F(": "));
+    DEBUG_PRINTLN(message);
+
+    int status = sendCallback(i, message);
+    if (status >= 400 && status < 500 && status != 429) {
+      // Refused for good (bad token, chat gone, bot blocked) - retrying would never succeed
+      // and would hold this recipient's presses forever, so stop sending to it
+      recipient.enabled = false;
+      state.delivered[i] = state.sealedSequence;
+      DEBUG_PRINT(F("NotificationDigest: HTTP "));
+      DEBUG_PRINT(status);
+      DEBUG_PRINT(F(" - user "));
+      DEBUG_PRINT(i + 1);
+      DEBUG_PRINTLN(F(" disabled until restart"));
+      return 0;
+    }
+    if (!(status >= 200 && status < 300)) {
+      // Not delivered (no connection, timeout, 429 or 5xx) - keep the presses and back off,
+      // doubling per consecutive failure
+      recipient.failures = min(recipient.failures + 1, 16);
+      unsigned long backoff = min((unsigned long)NOTIFY_RETRY_INTERVAL << (recipient.failures - 1),
+                                  (unsigned long)NOTIFY_RETRY_MAX);
+      recipient.retryAt = millis() + backoff;
+      if (recipient.retryAt == 0) recipient.retryAt = 1;
+      DEBUG_PRINT(F("NotificationDigest: Send failed, retrying in "));
+      DEBUG_PRINT(backoff / 1000);
+      DEBUG_PRINTLN(F("s"));
+      return 0;
+    }
+
+    recipient.tokens--;
+    recipient.failures = 0;
+    recipient.retryAt = 0;
+    state.delivered[i] = state.sealedSequence;
+
+    int upToDate = 0;
+    for (int j = 0; j < TELEGRAM_MAX_RECIPIENTS; j++) {
+      if (recipients[j].enabled && state.delivered[j] >= state.sealedSequence) {
+        upToDate++;
+      }
+    }
+    return upToDate;
+  }
+
+  return 0;
+}
+
+void NotificationDigest::discard() {
+  state.sealedSequence = state.newestSequence;
+  for (int i = 0; i < TELEGRAM_MAX_RECIPIENTS; i++) {
+    state.delivered[i] = state.newestSequence;
+  }
+}
+
+bool NotificationDigest::hasPending() {
+  for (int i = 0; i < TELEGRAM_MAX_RECIPIENTS; i++) {
+    if (recipients[i].enabled && state.delivered[i] < state.newestSequence) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void NotificationDigest::getSnapshot(NotifySnapshot* snapshot, uint32_t* windowRemaining) {
+  memcpy(snapshot, &state, sizeof(NotifySnapshot));
+
+  *windowRemaining = 0;
+  if (state.newestSequence != state.sealedSequence) {
+    unsigned long now = millis();
+    long untilQuiet = (long)NOTIFY_DIGEST_WINDOW - (long)(now - lastAdd);
+    long untilMaxWait = (long)NOTIFY_DIGEST_MAX_WAIT - (long)(now - windowStart);
+    long remaining = min(untilQuiet, untilMaxWait);
+    // Rounded up to whole seconds so the snapshot only changes once a second
+    *windowRemaining = remaining > 0 ? ((remaining + 999) / 1000) * 1000 : 0;
+  }
+}
+
+void NotificationDigest::restoreSnapshot(const NotifySnapshot& snapshot, uint32_t windowRemaining) {
+  memcpy(&state, &snapshot, sizeof(NotifySnapshot));
+
+  // Reopen the window so it closes after the remaining time
+  if (state.newestSequence != state.sealedSequence) {
+    lastAdd = millis() - NOTIFY_DIGEST_WINDOW + min(windowRemaining, (uint32_t)NOTIFY_DIGEST_WINDOW);
+    windowStart = millis();
+  }
+
+  uint32_t oldestDelivered = state.newestSequence;
+  for (int i = 0; i < TELEGRAM_MAX_RECIPIENTS; i++) {
+    oldestDelivered = min(oldestDelivered, state.delivered[i]);
+  }
+  DEBUG_PRINT("NotificationDigest: Restored ");
+  DEBUG_PRINT(state.newestSequence - oldestDelivered);
+  DEBUG_PRINTLN(" undelivered presses");
+}
+
+void NotificationDigest::sealWindow() {
+  if (state.newestSequence == state.sealedSequence) {
+    return;
+  }
+  unsigned long now = millis();
+  if (now - lastAdd >= NOTIFY_DIGEST_WINDOW || now - windowStart >= NOTIFY_DIGEST_MAX_WAIT) {
+    state.sealedSequence = state.newestSequence;
+  }
+}
+
+void NotificationDigest::refillBudget(Recipient& recipient) {
+  const unsigned long interval = NOTIFY_BUDGET_PERIOD / NOTIFY_BUDGET_MESSAGES;
+  unsigned long now = millis();
+
+  if (recipient.tokens >= NOTIFY_BUDGET_MESSAGES) {
+    recipient.lastRefill = now;
+    return;
+  }
+
+  unsigned long earned = (now - recipient.lastRefill) / interval;
+  if (earned > 0) {
+    recipient.tokens = min((unsigned long)NOTIFY_BUDGET_MESSAGES, recipient.tokens + earned);
+    recipient.lastRefill += earned * interval;
+  }
+}
+
+void NotificationDigest::formatDigest(uint32_t from, uint32_t to, char* buffer, size_t size) {
+  // Presses that fell out of the ring before this recipient got them are only counted
+  uint32_t first = max(from + 1, getOldestSequence());
+  uint32_t lost = first - (from + 1);
+
+  uint8_t counts[3] = {0, 0, 0};
+  uint8_t order[3];
+  uint8_t kinds = 0;
+  uint32_t firstTime = 0;
+  uint32_t lastTime = 0;
+
+  for (uint32_t sequence = first; sequence <= to; sequence++) {
+    uint32_t slot = sequence % NOTIFY_EVENT_BUFFER;
+    uint8_t timer = state.timers[slot];
+    if (timer > TIMER_POOP) {
+      continue;
+    }
+    if (counts[timer] == 0) {
+      order[kinds++] = timer;
+    }
+    if (counts[timer] < 255) {
+      counts[timer]++;
+    }
+    uint32_t timestamp = state.timestamps[slot];
+    if (firstTime == 0 || timestamp < firstTime) firstTime = timestamp;
+    if (timestamp > lastTime) lastTime = timestamp;
+  }
+
+  // Everything fell out of the ring - only the count is left
+  if (kinds == 0) {
+    snprintf(buffer, size, "%s: %lu button presses", dogName, (unsigned long)lost);
+    return;
+  }
+
+  // "Rover went outside, peed (2x) and pooped"
+  int length = snprintf(buffer, size, "%s", dogName);
+  for (int i = 0; i < kinds && length < (int)size; i++) {
+    const char* separator = i == 0 ? " " : (i == kinds - 1 ? " and " : ", ");
+    length += snprintf(buffer + length, size - length, "%s%s", separator, PRESS_VERBS[order[i]]);
+    if (counts[order[i]] > 1 && length < (int)size) {
+      length += snprintf(buffer + length, size - length, " (%ux)", counts[order[i]]);
+    }
+  }
+
+  // " at 3:12 PM" or " between 3:05 PM and 3:12 PM" (only with synced time)
+  if (firstTime >= 1000000000 && length < (int)size) {
+    char times[2][10];
+    uint32_t values[2] = {firstTime, lastTime};
+    for (int i = 0; i < 2; i++) {
+      time_t value = values[i];
+      struct tm* timeinfo = localtime(&value);
+      int hour = timeinfo->tm_hour % 12;
+      snprintf(times[i], sizeof(times[i]), "%d:%02d %s",
+               hour == 0 ? 12 : hour, timeinfo->tm_min, timeinfo->tm_hour >= 12 ? "PM" : "AM");
+    }
+    if (strcmp(times[0], times[1]) == 0) {
+      length += snprintf(buffer + length, size - length, " at %s", times[0]);
+    } else {
+      length += snprintf(buffer + length, size - length, " between %s and %s", times[0], times[1]);
+    }
+  } else if (length < (int)size) {
+    length += snprintf(buffer + length, size - length, "!");
+  }
+
+  if (lost > 0 && length < (int)size) {
+    snprintf(buffer + length, size - length, " (+%lu earlier)", (unsigned long)lost);
+  }
+}
+
+uint32_t NotificationDigest::getOldestSequence() {
+  return state.newestSequence >= NOTIFY_EVENT_BUFFER ? state.newestSequence - NOTIFY_EVENT_BUFFER + 1 : 1;
+}
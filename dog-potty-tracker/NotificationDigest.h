@@ -0,0 +1,87 @@
+#ifndef NOTIFICATION_DIGEST_H
+#define NOTIFICATION_DIGEST_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "config.h"
+#include "TimerManager.h"
+
+#define NOTIFY_MESSAGE_SIZE 128
+
+// Callback type for delivering a digest to one recipient (RecipientRegistry index)
+// Returns the HTTP status (2xx = accepted) or a negative error when nothing was sent
+typedef int (*NotifySendCallback)(uint8_t recipient, const char* message);
+
+// Undelivered presses and delivery progress, kept in RTC memory across warm resets
+// (4-byte aligned; timers[] packs into whole blocks)
+struct NotifySnapshot {
+  uint32_t newestSequence;                      // Sequence of the newest press (0 = none yet)
+  uint32_t sealedSequence;                      // Newest press whose collection window has closed
+  uint32_t delivered[TELEGRAM_MAX_RECIPIENTS];  // Newest press each recipient has received
+  uint32_t timestamps[NOTIFY_EVENT_BUFFER];     // Slot = sequence % NOTIFY_EVENT_BUFFER
+  uint8_t timers[(NOTIFY_EVENT_BUFFER + 3) & ~3];
+};
+
+// Collects button presses into one message per recipient instead of one per press.
+// Presses go into a small ring shared by all recipients; each recipient has its own
+// cursor, send budget and retry backoff, so a slow or failing recipient neither
+// loses presses (they merge into its next digest) nor delays the others.
+class NotificationDigest {
+public:
+  NotificationDigest();
+
+  // Set dog name (used in messages) and delivery callback
+  void begin(const char* dogName, NotifySendCallback callback);
+
+  // Enable a recipient (disabled recipients never hold presses back)
+  // A recipient Telegram refuses for good (4xx other than 429) is disabled until restart
+  void setRecipientEnabled(uint8_t recipient, bool enabled);
+
+  // Add a button press to the digest being collected
+  void add(Timer timer, time_t timestamp);
+
+  // Send at most one digest (call every loop iteration)
+  // Returns number of recipients that are fully up to date after a delivery, 0 if nothing was sent
+  int update();
+
+  // Drop everything not delivered yet (another tracker is sending)
+  void discard();
+
+  // Check if any press is waiting for delivery
+  bool hasPending();
+
+  // Save and restore state across a warm reset (window is the time left to collect, ms)
+  void getSnapshot(NotifySnapshot* snapshot, uint32_t* windowRemaining);
+  void restoreSnapshot(const NotifySnapshot& snapshot, uint32_t windowRemaining);
+
+private:
+  struct Recipient {
+    bool enabled;
+    uint8_t tokens;              // Messages left in the budget
+    uint8_t failures;            // Consecutive failed sends
+    unsigned long lastRefill;
+    unsigned long retryAt;       // No send before this (0 = now)
+  };
+
+  const char* dogName;
+  NotifySendCallback sendCallback;
+  NotifySnapshot state;
+  Recipient recipients[TELEGRAM_MAX_RECIPIENTS];
+  uint8_t nextRecipient;         // Round-robin start for fairness
+  unsigned long windowStart;     // First press of the open window
+  unsigned long lastAdd;         // Newest press of the open window
+
+  // Close the collection window once presses have stopped (or waited long enough)
+  void sealWindow();
+
+  // Refill the recipient's budget for the time passed
+  void refillBudget(Recipient& recipient);
+
+  // Build the message for presses after `from` up to `to`
+  void formatDigest(uint32_t from, uint32_t to, char* buffer, size_t size);
+
+  // Oldest press still held in the ring
+  uint32_t getOldestSequence();
+};
+
+#endif
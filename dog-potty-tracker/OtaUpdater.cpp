@@ -0,0 +1,363 @@
+#include "OtaUpdater.h"
+#include <Updater.h>
+#include "WiFiManager.h"
+#include "HttpRequestWriter.h"
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+OtaUpdater::OtaUpdater() :
+  state(OTA_IDLE),
+  port(80),
+  total(0),
+  received(0),
+  skip(0),
+  lastByte(0),
+  attempts(0),
+  connections(0),
+  retryAt(0),
+  lastData(0),
+  startedAt(0)
+{
+  host[0] = '\0';
+  path[0] = '\0';
+  error[0] = '\0';
+}
+
+bool OtaUpdater::start(const char* url, const char* sha256, String& message) {
+  if (isBusy()) {
+    message = F("An update is already running");
+    return false;
+  }
+  if (!parseUrl(url)) {
+    message = F("Use: update http://<host>[:<port>]/<file> <sha256>");
+    return false;
+  }
+  if (strlen(sha256) != 64) {
+    message = F("The SHA-256 must be 64 hex digits");
+    return false;
+  }
+  for (int i = 0; i < 32; i++) {
+    int high = hexValue(sha256[i * 2]);
+    int low = hexValue(sha256[i * 2 + 1]);
+    if (high < 0 || low < 0) {
+      message = F("The SHA-256 must be 64 hex digits");
+      return false;
+    }
+    expectedHash[i] = (uint8_t)(high << 4 | low);
+  }
+
+  br_sha256_init(&sha);
+  total = 0;
+  received = 0;
+  skip = 0;
+  attempts = 0;
+  connections = 0;
+  error[0] = '\0';
+  startedAt = millis();
+  state = OTA_REQUEST;
+
+  DEBUG_PRINT(F("OTA: updating from "));
+  DEBUG_PRINT(host);
+  DEBUG_PRINT(':');
+  DEBUG_PRINT(port);
+  DEBUG_PRINTLN(path);
+  return true;
+}
+
+bool OtaUpdater::parseUrl(const char* url) {
+  if (strncasecmp_P(url, PSTR("http://"), 7) != 0) {
+    return false;
+  }
+  const char* hostStart = url + 7;
+  const char* slash = strchr(hostStart, '/');
+  if (slash == nullptr || slash == hostStart || strlen(slash) >= OTA_PATH_SIZE) {
+    return false;
+  }
+
+  const char* colon = (const char*)memchr(hostStart, ':', slash - hostStart);
+  const char* hostEnd = colon != nullptr ? colon : slash;
+  if (hostEnd == hostStart || (size_t)(hostEnd - hostStart) >= OTA_HOST_SIZE) {
+    return false;
+  }
+  long portNumber = colon != nullptr ? atol(colon + 1) : 80;
+  if (portNumber <= 0 || portNumber > 65535) {
+    return false;
+  }
+
+  memcpy(host, hostStart, hostEnd - hostStart);
+  host[hostEnd - hostStart] = '\0';
+  port = (uint16_t)portNumber;
+  strcpy(path, slash);
+  return true;
+}
+
+bool OtaUpdater::update(bool connected) {
+  switch (state) {
+    case OTA_REQUEST:
+      if (connected) {
+        sendRequest();
+      }
+      break;
+    case OTA_HEADERS:
+      readHeaders();
+      break;
+    case OTA_BODY:
+      readBody();
+      break;
+    case OTA_RETRY:
+      if ((long)(millis() - retryAt) >= 0) {
+        state = OTA_REQUEST;
+      }
+      break;
+    default:
+      break;
+  }
+  return state == OTA_INSTALLED;
+}
+
+void OtaUpdater::sendRequest() {
+  connections++;
+  client.setTimeout(2000);  // Only read once the response has started arriving
+  if (!client.connect(host, port)) {
+    connectionLost();
+    return;
+  }
+
+  HttpRequestWriter<WiFiClient> request(client);
+  request.begin(PSTR("GET"), PSTR(""));
+  request.addPath(path);
+  if (received > 0) {
+    // Resume after the last byte handed to the Updater
+    request.setRange(received);
+  }
+  if (!request.end(host, false)) {
+    connectionLost();
+    return;
+  }
+
+  lastData = millis();
+  state = OTA_HEADERS;
+}
+
+void OtaUpdater::readHeaders() {
+  if (client.available() == 0) {
+    if (!client.connected() || millis() - lastData > OTA_TIMEOUT) {
+      connectionLost();
+    }
+    return;
+  }
+
+  // The header block is small - read it in one go once it starts arriving
+  char line[128];
+  if (!WiFiManager::readLine(client, line, sizeof(line))) {
+    connectionLost();
+    return;
+  }
+  const char* code = strchr(line, ' ');
+  int status = flashStartsWith(line, PSTR("HTTP/")) && code != nullptr ? atoi(code + 1) : 0;
+
+  long length = -1;
+  long rangeStart = -1;
+  long rangeTotal = -1;
+  bool chunked = false;
+  while (true) {
+    if (!WiFiManager::readLine(client, line, sizeof(line))) {
+      connectionLost();
+      return;
+    }
+    if (line[0] == '\0') {
+      break;
+    }
+    if (strncasecmp_P(line, PSTR("Content-Length:"), 15) == 0) {
+      length = atol(line + 15);
+    } else if (strncasecmp_P(line, PSTR("Content-Range:"), 14) == 0) {
+      // "Content-Range: bytes 1024-302143/302144"
+      const char* unit = strstr_P(line + 14, PSTR("bytes "));
+      const char* slash = strchr(line, '/');
+      if (unit != nullptr && slash != nullptr) {
+        rangeStart = atol(unit + 6);
+        rangeTotal = atol(slash + 1);
+      }
+    } else if (strncasecmp_P(line, PSTR("Transfer-Encoding:"), 18) == 0) {
+      chunked = strstr_P(line + 18, PSTR("chunked")) != nullptr;
+    }
+  }
+
+  long size;
+  if (status == 200) {
+    // Whole file: the first request, or a server without Range support (drop what is already written)
+    size = length;
+    skip = received;
+  } else if (status == 206 && rangeStart == (long)received) {
+    size = rangeTotal;
+  } else if (status == 206) {
+    fail(PSTR("Server resumed at the wrong offset"));
+    return;
+  } else {
+    fail(PSTR("Server replied with HTTP %ld"), status);
+    return;
+  }
+  if (chunked || size <= 0) {
+    fail(PSTR("Server did not send the image size"));
+    return;
+  }
+
+  if (total == 0) {
+    Update.clearError();
+    if (!Update.begin(size)) {
+      fail(PSTR("Image of %ld bytes does not fit"), size);
+      return;
+    }
+    total = size;
+    DEBUG_PRINT(F("OTA: image is "));
+    DEBUG_PRINT(total);
+    DEBUG_PRINTLN(F(" bytes"));
+  } else if ((size_t)size != total) {
+    fail(PSTR("Image changed on the server"));
+    return;
+  }
+
+  state = OTA_BODY;
+}
+
+void OtaUpdater::readBody() {
+  int available = client.available();
+  if (available <= 0) {
+    if (!client.connected() || millis() - lastData > OTA_TIMEOUT) {
+      connectionLost();
+    }
+    return;
+  }
+
+  uint8_t buffer[OTA_CHUNK_SIZE];
+  int count = client.read(buffer, min(available, OTA_CHUNK_SIZE));
+  if (count <= 0) {
+    return;
+  }
+  lastData = millis();
+  attempts = 0;
+
+  uint8_t* data = buffer;
+  if (skip > 0) {
+    size_t dropped = min((size_t)count, skip);
+    skip -= dropped;
+    data += dropped;
+    count -= dropped;
+  }
+  size_t length = min((size_t)count, total - received);
+  if (length > 0 && !writeImage(data, length)) {
+    return;
+  }
+
+  if (received == total) {
+    client.stop();
+    finish();
+  }
+}
+
+bool OtaUpdater::writeImage(uint8_t* data, size_t length) {
+  br_sha256_update(&sha, data, length);
+
+  // The Updater can only be abandoned while the image is incomplete, so the final byte
+  // waits for the hash check
+  size_t flashLength = length;
+  if (received + length == total) {
+    lastByte = data[length - 1];
+    flashLength--;
+  }
+  if (flashLength > 0 && Update.write(data, flashLength) != flashLength) {
+    fail(PSTR("Flash write failed (Updater error %ld)"), Update.getError());
+    return false;
+  }
+
+  received += length;
+  return true;
+}
+
+bool OtaUpdater::finish() {
+  uint8_t hash[32];
+  br_sha256_out(&sha, hash);
+  if (memcmp(hash, expectedHash, sizeof(hash)) != 0) {
+    fail(PSTR("SHA-256 mismatch"));
+    return false;
+  }
+
+  // Commit: the bootloader copies (and unpacks) the new image on the next boot
+  if (Update.write(&lastByte, 1) != 1 || !Update.end()) {
+    fail(PSTR("Image rejected (Updater error %ld)"), Update.getError());
+    return false;
+  }
+
+  state = OTA_INSTALLED;
+  DEBUG_PRINT(F("OTA: installed "));
+  DEBUG_PRINT(total);
+  DEBUG_PRINT(F(" bytes in "));
+  DEBUG_PRINT((millis() - startedAt) / 1000);
+  DEBUG_PRINT(F(" s over "));
+  DEBUG_PRINT(connections);
+  DEBUG_PRINTLN(F(" connection(s)"));
+  return true;
+}
+
+void OtaUpdater::connectionLost() {
+  client.stop();
+  if (++attempts > OTA_MAX_ATTEMPTS) {
+    fail(PSTR("Server unreachable"));
+    return;
+  }
+
+  state = OTA_RETRY;
+  retryAt = millis() + OTA_RETRY_INTERVAL;
+  DEBUG_PRINT(F("OTA: connection lost at "));
+  DEBUG_PRINT(received);
+  DEBUG_PRINT(F(" of "));
+  DEBUG_PRINT(total);
+  DEBUG_PRINTLN(F(" bytes, resuming"));
+}
+
+void OtaUpdater::fail(PGM_P reason, long value) {
+  client.stop();
+
+  // Abandon the partial image (end() without the last byte resets the Updater)
+  if (Update.isRunning() && !Update.isFinished()) {
+    Update.end();
+  }
+
+  snprintf_P(error, sizeof(error), reason, value);
+  state = OTA_FAILED;
+  DEBUG_PRINT(F("OTA: failed - "));
+  DEBUG_PRINTLN(error);
+}
+
+bool OtaUpdater::isBusy() {
+  return state != OTA_IDLE && state != OTA_FAILED;
+}
+
+uint8_t OtaUpdater::getProgress() {
+  if (total == 0) {
+    return 0;
+  }
+  return (uint8_t)((uint64_t)received * 100 / total);
+}
+
+String OtaUpdater::getStatus() {
+  char buffer[96];
+  switch (state) {
+    case OTA_IDLE:
+      return String(F("No update running"));
+    case OTA_INSTALLED:
+      return String(F("Update installed, rebooting"));
+    case OTA_FAILED:
+      snprintf_P(buffer, sizeof(buffer), PSTR("Update failed: %s"), error);
+      return String(buffer);
+    default:
+      snprintf_P(buffer, sizeof(buffer), PSTR("Updating: %u%% (%lu of %lu bytes, %u connection(s))"),
+                 getProgress(), (unsigned long)received, (unsigned long)total, connections);
+      return String(buffer);
+  }
+}
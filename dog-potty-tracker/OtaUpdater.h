@@ -0,0 +1,92 @@
+#ifndef OTA_UPDATER_H
+#define OTA_UPDATER_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <bearssl/bearssl_hash.h>
+#include "config.h"
+
+#define OTA_HOST_SIZE 64
+#define OTA_PATH_SIZE 128
+#define OTA_ERROR_SIZE 48
+
+enum OtaState {
+  OTA_IDLE,
+  OTA_REQUEST,      // Connect and send the (range) request
+  OTA_HEADERS,      // Waiting for the response headers
+  OTA_BODY,         // Streaming the image into flash
+  OTA_RETRY,        // Connection lost - resume after OTA_RETRY_INTERVAL
+  OTA_INSTALLED,    // Verified and committed, waiting for the reboot
+  OTA_FAILED
+};
+
+// Firmware updates pulled over plain HTTP from a server on the LAN (tools/ota-server).
+// The image - raw or gzip-compressed, which the bootloader unpacks while copying it
+// into place - is streamed into the update partition a chunk per loop iteration, so
+// the tracker keeps running during the download. A dropped connection is resumed
+// with a Range request from the last byte handed to the Updater. The SHA-256 of the
+// downloaded file is checked before the image is committed; on a mismatch the
+// Updater is abandoned and the running firmware stays in place.
+class OtaUpdater {
+public:
+  OtaUpdater();
+
+  // Start an update from url ("http://host[:port]/path") with the expected SHA-256 (hex)
+  // Returns false (with the reason in message) if the arguments are unusable or one is running
+  bool start(const char* url, const char* sha256, String& message);
+
+  // Advance the download (call every loop iteration)
+  // Returns true when the new image is installed - save state and reboot
+  bool update(bool connected);
+
+  // Check if an update is downloading (the loop should not idle)
+  bool isBusy();
+
+  // Downloaded share of the image (0-100)
+  uint8_t getProgress();
+
+  // State, progress and the last error for the update command
+  String getStatus();
+
+private:
+  OtaState state;
+  WiFiClient client;
+  char host[OTA_HOST_SIZE];
+  uint16_t port;
+  char path[OTA_PATH_SIZE];
+  uint8_t expectedHash[32];
+  br_sha256_context sha;
+
+  size_t total;         // Image size (0 until the first response)
+  size_t received;      // Bytes hashed and handed to the Updater
+  size_t skip;          // Bytes to drop from a response that ignored the Range header
+  uint8_t lastByte;     // Held back until the hash is checked
+
+  uint8_t attempts;     // Connections in a row that brought no data
+  uint16_t connections;
+  unsigned long retryAt;
+  unsigned long lastData;
+  unsigned long startedAt;
+  char error[OTA_ERROR_SIZE];
+
+  // Split url into host, port and path
+  bool parseUrl(const char* url);
+
+  void sendRequest();
+  void readHeaders();
+  void readBody();
+
+  // Hash and write a piece of the image; the last byte is only written once the hash matches
+  bool writeImage(uint8_t* data, size_t length);
+
+  // Check the hash and commit the image
+  bool finish();
+
+  // Connection dropped - resume later unless too many attempts failed
+  void connectionLost();
+
+  // Abandon the update and the partial image (reason may contain one %ld for value)
+  void fail(PGM_P reason, long value = 0);
+};
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef PEE_PREDICTOR_H
+#define PEE_PREDICTOR_H
+
+// Next-pee predictor (fixed-point, no floating point)
+// Plain C++ with no Arduino dependencies so it can be replayed against recorded
+// event logs on a Linux host (see tools/predictor-sim). The sketch supplies the
+// local hour of day and persists PredictorData through Storage.
+//
+// Model: the interval after a pee is an EWMA for the 2-hour block of the day the
+// pee happened in, shrunk towards the all-day EWMA while that block has few
+// samples. A learned offset is added when the dog went outside since the last pee
+// without peeing. Spread is an EWMA of the absolute prediction error.
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef PREDICT_EWMA_SHIFT
+#define PREDICT_EWMA_SHIFT 3            // Weight of the newest interval = 1/2^shift
+#endif
+#ifndef PREDICT_MIN_INTERVAL
+#define PREDICT_MIN_INTERVAL 1200       // Seconds; shorter intervals are not learned
+#endif
+#ifndef PREDICT_MAX_INTERVAL
+#define PREDICT_MAX_INTERVAL 43200      // Seconds; longer intervals (missed logging) are not learned
+#endif
+#ifndef PREDICT_OUTSIDE_GAP
+#define PREDICT_OUTSIDE_GAP 600         // Outside this long before a pee counts as "went out, no pee"
+#endif
+
+#define PREDICT_MAGIC 0x50524401        // "PRD" + layout version
+#define PREDICT_BUCKETS 12              // 2-hour blocks of the day
+#define PREDICT_FRACTION_BITS 4         // Q4 fixed point (1/16 s)
+#define PREDICT_SHRINK 4                // Block samples needed to weigh as much as the all-day EWMA
+#define PREDICT_FULL_CONFIDENCE 16      // Samples needed before confidence can reach 100%
+
+// Learned model state (little-endian, persisted as-is)
+struct __attribute__((packed)) PredictorData {
+  uint32_t magic;
+  int32_t bucketInterval[PREDICT_BUCKETS];   // Q4 seconds
+  int32_t bucketError[PREDICT_BUCKETS];      // Q4 seconds, mean absolute error
+  uint16_t bucketCount[PREDICT_BUCKETS];
+  int32_t globalInterval;                    // Q4 seconds
+  int32_t globalError;                       // Q4 seconds
+  uint16_t globalCount;
+  int32_t missedOffset;                      // Q4 seconds added after outside-without-pee
+  uint16_t missedCount;
+  uint32_t lastPee;                          // Unix epoch of the last pee seen
+  uint32_t firstOutside;                     // Unix epoch of the first outside event after it
+  uint32_t crc;                              // Filled in by Storage (MUST be last)
+};
+
+// Prediction for the interval following a pee
+struct PeePrediction {
+  uint32_t interval;      // Expected seconds from the last pee to the next one
+  uint32_t spread;        // Typical error in seconds
+  uint8_t confidence;     // 0-100
+};
+
+class PeePredictor {
+public:
+  PeePredictor() : dirty(false) {
+    reset();
+    dirty = false;
+  }
+
+  // Forget everything learned
+  void reset() {
+    memset(&data, 0, sizeof(data));
+    data.magic = PREDICT_MAGIC;
+    dirty = true;
+  }
+
+  // Record an outside event (no pee implied); only the first trip after a pee matters
+  void recordOutside(uint32_t timestamp) {
+    if (timestamp > data.lastPee && data.firstOutside <= data.lastPee) {
+      data.firstOutside = timestamp;
+      dirty = true;
+    }
+  }
+
+  // Learn from a completed interval; hour is the local hour of the previous pee
+  void recordPee(uint32_t previous, uint32_t current, uint8_t hour) {
+    if (current <= previous) return;  // Correction of an earlier event
+    bool missed = wentOutWithoutPee(previous, current);
+    if (current > data.lastPee) {
+      data.lastPee = current;
+      dirty = true;
+    }
+    if (previous == 0) return;
+    uint32_t seconds = current - previous;
+    if (seconds < PREDICT_MIN_INTERVAL || seconds > PREDICT_MAX_INTERVAL) return;
+
+    int32_t actual = (int32_t)seconds << PREDICT_FRACTION_BITS;
+    int bucket = (hour % 24) * PREDICT_BUCKETS / 24;
+
+    // Error of what would have been predicted at the time (before learning)
+    if (data.globalCount > 0) {
+      int32_t base = baseInterval(bucket);
+      int32_t predicted = base + (missed && data.missedCount >= 2 ? data.missedOffset : 0);
+      int32_t error = absolute(actual - predicted);
+      if (data.bucketCount[bucket] > 0) {
+        data.bucketError[bucket] = ewma(data.bucketError[bucket], error, data.bucketCount[bucket]);
+      }
+      data.globalError = ewma(data.globalError, error, data.globalCount - 1);  // First error initialises it
+
+      // Outside-without-pee offset learns from the residual of the base model only
+      if (missed) {
+        data.missedOffset = ewma(data.missedOffset, actual - base, data.missedCount);
+        if (data.missedCount < 0xFFFF) data.missedCount++;
+      }
+    }
+
+    // Intervals that followed a missed outing are not typical - keep them out of the base
+    if (!missed || data.globalCount == 0) {
+      if (data.bucketCount[bucket] == 0) data.bucketError[bucket] = data.globalError;
+      data.bucketInterval[bucket] = ewma(data.bucketInterval[bucket], actual, data.bucketCount[bucket]);
+      data.globalInterval = ewma(data.globalInterval, actual, data.globalCount);
+      if (data.bucketCount[bucket] < 0xFFFF) data.bucketCount[bucket]++;
+      if (data.globalCount < 0xFFFF) data.globalCount++;
+    }
+    dirty = true;
+  }
+
+  // Predict the next pee for the current state; returns false until anything was learned
+  bool predict(uint32_t lastPee, uint8_t hour, uint32_t now, PeePrediction* prediction) const {
+    if (data.globalCount == 0 || lastPee == 0) return false;
+
+    int bucket = (hour % 24) * PREDICT_BUCKETS / 24;
+    int32_t interval = baseInterval(bucket);
+    if (wentOutWithoutPee(lastPee, now) && data.missedCount >= 2) {
+      interval += data.missedOffset;
+    }
+    int32_t minimum = (int32_t)PREDICT_MIN_INTERVAL << PREDICT_FRACTION_BITS;
+    if (interval < minimum) interval = minimum;
+
+    // Error blends the same way as the interval
+    int32_t spread = blend(data.bucketError[bucket], data.globalError, data.bucketCount[bucket]);
+
+    // Confidence: sample size times relative error (100% = no error, 16+ samples)
+    uint32_t samples = data.globalCount < PREDICT_FULL_CONFIDENCE ? data.globalCount : PREDICT_FULL_CONFIDENCE;
+    int32_t relative = interval > 0 ? (int32_t)(((int64_t)spread * 100) / interval) : 100;
+    if (relative > 100) relative = 100;
+    prediction->interval = (uint32_t)interval >> PREDICT_FRACTION_BITS;
+    prediction->spread = (uint32_t)spread >> PREDICT_FRACTION_BITS;
+    prediction->confidence = (uint8_t)((100 - relative) * samples / PREDICT_FULL_CONFIDENCE);
+    return true;
+  }
+
+  uint16_t getSampleCount() const {
+    return data.globalCount;
+  }
+
+  bool isDirty() const {
+    return dirty;
+  }
+
+  void clearDirty() {
+    dirty = false;
+  }
+
+  // Raw data for persistence (Storage validates magic and CRC)
+  PredictorData* getData() {
+    return &data;
+  }
+
+  void restore(const PredictorData* saved) {
+    memcpy(&data, saved, sizeof(PredictorData));
+    dirty = false;
+  }
+
+private:
+  PredictorData data;
+  bool dirty;
+
+  bool wentOutWithoutPee(uint32_t lastPee, uint32_t now) const {
+    return data.firstOutside > lastPee && now >= data.firstOutside + PREDICT_OUTSIDE_GAP;
+  }
+
+  int32_t baseInterval(int bucket) const {
+    return blend(data.bucketInterval[bucket], data.globalInterval, data.bucketCount[bucket]);
+  }
+
+  // Shrink a block value towards the all-day value while the block has few samples
+  static int32_t blend(int32_t local, int32_t global, uint16_t count) {
+    uint32_t weight = count < 16 ? count : 16;
+    return (int32_t)(((int64_t)local * weight + (int64_t)global * PREDICT_SHRINK) / (weight + PREDICT_SHRINK));
+  }
+
+  // Exponentially weighted average; the first sample initialises it
+  static int32_t ewma(int32_t average, int32_t sample, uint16_t count) {
+    if (count == 0) {
+      return sample;
+    }
+    return average + (sample - average) / (1 << PREDICT_EWMA_SHIFT);
+  }
+
+  static int32_t absolute(int32_t value) {
+    return value < 0 ? -value : value;
+  }
+};
+
+#endif
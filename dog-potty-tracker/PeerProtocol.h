@@ -0,0 +1,169 @@
+#ifndef PEER_PROTOCOL_H
+#define PEER_PROTOCOL_H
+
+// Peer-to-peer timer sync protocol (UDP multicast between trackers)
+// Plain C++ with no Arduino dependencies so it can be simulated on a Linux host
+// (see tools/peer-sim). Device side networking lives in PeerSync.
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef PEER_MAX_NODES
+#define PEER_MAX_NODES 8          // Other trackers remembered for election
+#endif
+#ifndef PEER_NODE_TIMEOUT
+#define PEER_NODE_TIMEOUT 35000   // Node considered gone after this long without packets (ms)
+#endif
+
+#define PEER_MAGIC 0x5044         // "DP"
+#define PEER_VERSION 1
+#define PEER_NO_TIMER 0xFF
+
+enum PeerPacketType {
+  PEER_TIMER_UPDATE = 1,          // A timer just changed on the sender
+  PEER_HEARTBEAT = 2              // Periodic full state (recovers lost updates, keeps election alive)
+};
+
+// Wire format (little-endian, 38 bytes). Timer order matches PersistentData.
+struct __attribute__((packed)) PeerPacket {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t type;                   // PeerPacketType
+  uint32_t nodeId;                // Sender chip ID
+  uint32_t sequence;              // Per-sender, increments with every packet
+  uint8_t timer;                  // Timer that changed, PEER_NO_TIMER for heartbeats
+  uint8_t reserved;
+  uint32_t timestamps[3];         // Timer start times (outside, pee, poop), Unix epoch
+  uint32_t changedAt[3];          // When each timer was last written, Unix epoch (LWW key)
+};
+
+// Another tracker seen on the network
+struct PeerNode {
+  uint32_t nodeId;                // 0 = free slot
+  uint32_t lastSequence;
+  uint32_t lastSeen;              // Local milliseconds
+};
+
+// Replicated timer state with last-writer-wins merge and lowest-ID leader election
+class PeerState {
+public:
+  PeerState() : nodeId(0), sequence(0) {
+    memset(timestamps, 0, sizeof(timestamps));
+    memset(changedAt, 0, sizeof(changedAt));
+    memset(nodes, 0, sizeof(nodes));
+  }
+
+  void begin(uint32_t id) {
+    nodeId = id;
+  }
+
+  uint32_t getNodeId() const {
+    return nodeId;
+  }
+
+  // Record a local change (button press, command or restored value)
+  void setLocal(uint8_t timer, uint32_t timestamp, uint32_t writeTime) {
+    if (timer >= 3) return;
+    timestamps[timer] = timestamp;
+    changedAt[timer] = writeTime;
+  }
+
+  uint32_t getTimestamp(uint8_t timer) const {
+    return timer < 3 ? timestamps[timer] : 0;
+  }
+
+  // Fill a packet with the current state
+  void buildPacket(PeerPacket* packet, uint8_t type, uint8_t timer) {
+    packet->magic = PEER_MAGIC;
+    packet->version = PEER_VERSION;
+    packet->type = type;
+    packet->nodeId = nodeId;
+    packet->sequence = ++sequence;
+    packet->timer = timer;
+    packet->reserved = 0;
+    for (int i = 0; i < 3; i++) {
+      packet->timestamps[i] = timestamps[i];
+      packet->changedAt[i] = changedAt[i];
+    }
+  }
+
+  // Merge a received packet, returns bitmask of timers adopted (bit 0 = outside)
+  uint8_t merge(const uint8_t* data, size_t length, uint32_t nowMs) {
+    if (length != sizeof(PeerPacket)) return 0;
+
+    PeerPacket packet;
+    memcpy(&packet, data, sizeof(packet));
+    if (packet.magic != PEER_MAGIC || packet.version != PEER_VERSION) return 0;
+    if (packet.nodeId == nodeId) return 0;  // Our own multicast echo
+
+    // Drop duplicates and reordered packets (sequence restarts are accepted after a timeout)
+    PeerNode* node = findNode(packet.nodeId, nowMs);
+    bool known = node->lastSeen != 0 && (nowMs - node->lastSeen) < PEER_NODE_TIMEOUT;
+    if (known && (int32_t)(packet.sequence - node->lastSequence) <= 0) return 0;
+    node->lastSequence = packet.sequence;
+    node->lastSeen = nowMs != 0 ? nowMs : 1;
+
+    // Last writer wins per timer; equal write times go to the higher node ID
+    uint8_t adopted = 0;
+    for (int i = 0; i < 3; i++) {
+      bool newer = packet.changedAt[i] > changedAt[i] ||
+                   (packet.changedAt[i] == changedAt[i] && packet.nodeId > nodeId &&
+                    packet.timestamps[i] != timestamps[i]);
+      if (newer && packet.changedAt[i] != 0) {
+        timestamps[i] = packet.timestamps[i];
+        changedAt[i] = packet.changedAt[i];
+        adopted |= (1 << i);
+      }
+    }
+    return adopted;
+  }
+
+  // Leader = lowest node ID among this node and peers heard recently
+  bool isLeader(uint32_t nowMs) const {
+    for (int i = 0; i < PEER_MAX_NODES; i++) {
+      if (isAlive(nodes[i], nowMs) && nodes[i].nodeId < nodeId) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Get number of peers heard recently
+  int getPeerCount(uint32_t nowMs) const {
+    int count = 0;
+    for (int i = 0; i < PEER_MAX_NODES; i++) {
+      if (isAlive(nodes[i], nowMs)) count++;
+    }
+    return count;
+  }
+
+private:
+  uint32_t nodeId;
+  uint32_t sequence;
+  uint32_t timestamps[3];
+  uint32_t changedAt[3];
+  PeerNode nodes[PEER_MAX_NODES];
+
+  static bool isAlive(const PeerNode& node, uint32_t nowMs) {
+    return node.nodeId != 0 && node.lastSeen != 0 && (nowMs - node.lastSeen) < PEER_NODE_TIMEOUT;
+  }
+
+  // Find node entry; a new node takes a dead slot, or the least recently seen one
+  PeerNode* findNode(uint32_t id, uint32_t nowMs) {
+    PeerNode* slot = nullptr;
+    for (int i = 0; i < PEER_MAX_NODES; i++) {
+      if (nodes[i].nodeId == id) return &nodes[i];
+      if (slot != nullptr && !isAlive(*slot, nowMs)) continue;
+      if (slot == nullptr || !isAlive(nodes[i], nowMs) ||
+          (nowMs - nodes[i].lastSeen) > (nowMs - slot->lastSeen)) {
+        slot = &nodes[i];
+      }
+    }
+    slot->nodeId = id;
+    slot->lastSequence = 0;
+    slot->lastSeen = 0;
+    return slot;
+  }
+};
+
+#endif
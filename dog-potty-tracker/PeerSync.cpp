@@ -0,0 +1,132 @@
+#include "PeerSync.h"
+
+PeerSync::PeerSync() :
+  started(false),
+  applyingRemote(false),
+  lastHeartbeat(0),
+  repeatAt(0),
+  repeatTimer(PEER_NO_TIMER)
+{
+}
+
+void PeerSync::begin(TimerManager* timerManager) {
+  state.begin(ESP.getChipId());
+
+  // Restored timers: the write time is unknown, so use the timer value itself
+  for (int i = 0; i < 3; i++) {
+    uint32_t timestamp = (uint32_t)timerManager->getTimestamp((Timer)i);
+    state.setLocal(i, timestamp, timestamp);
+  }
+
+  DEBUG_PRINT("PeerSync: Node ID ");
+  DEBUG_PRINTLN(state.getNodeId());
+}
+
+void PeerSync::start() {
+  IPAddress group(PEER_MULTICAST_GROUP);
+  if (udp.beginMulticast(WiFi.localIP(), group, PEER_PORT)) {
+    started = true;
+    lastHeartbeat = 0;  // Announce ourselves right away
+    DEBUG_PRINTLN("PeerSync: Joined multicast group");
+  } else {
+    DEBUG_PRINTLN("PeerSync: Failed to join multicast group");
+  }
+}
+
+uint8_t PeerSync::update(TimerManager* timerManager) {
+  if (WiFi.status() != WL_CONNECTED) {
+    // Rejoin after reconnect (IP address may have changed)
+    if (started) {
+      udp.stop();
+      started = false;
+    }
+    return 0;
+  }
+
+  if (!started) {
+    start();
+    if (!started) {
+      return 0;
+    }
+  }
+
+  uint8_t changed = 0;
+
+  // Drain all queued datagrams
+  uint8_t buffer[sizeof(PeerPacket)];
+  int packetSize;
+  while ((packetSize = udp.parsePacket()) > 0) {
+    int length = udp.read(buffer, sizeof(buffer));
+    if (packetSize != (int)sizeof(PeerPacket) || length != (int)sizeof(PeerPacket)) {
+      continue;  // Not ours or truncated
+    }
+
+    uint8_t adopted = state.merge(buffer, length, millis());
+    if (adopted == 0) {
+      continue;
+    }
+
+    // Apply without echoing the change back to the network
+    applyingRemote = true;
+    for (int i = 0; i < 3; i++) {
+      if (adopted & (1 << i)) {
+        timerManager->setTimestamp((Timer)i, (time_t)state.getTimestamp(i));
+        DEBUG_PRINT("PeerSync: Timer ");
+        DEBUG_PRINT(i);
+        DEBUG_PRINTLN(" updated by peer");
+      }
+    }
+    applyingRemote = false;
+    changed |= adopted;
+  }
+
+  // Second copy of the last update (multicast over WiFi is lossy)
+  if (repeatAt != 0 && (long)(millis() - repeatAt) >= 0) {
+    repeatAt = 0;
+    send(PEER_TIMER_UPDATE, repeatTimer);
+  }
+
+  // Time must be valid before our state means anything to the others
+  if (timerManager->isTimeSynced() && millis() - lastHeartbeat >= PEER_HEARTBEAT_INTERVAL) {
+    lastHeartbeat = millis();
+    send(PEER_HEARTBEAT, PEER_NO_TIMER);
+  }
+
+  return changed;
+}
+
+void PeerSync::onLocalChange(Timer timer, time_t timestamp) {
+  if (applyingRemote) {
+    return;
+  }
+
+  time_t now = time(nullptr);
+  state.setLocal((uint8_t)timer, (uint32_t)timestamp, (uint32_t)now);
+
+  if (!started || now < 1000000000) {
+    return;  // Will go out with the next heartbeat
+  }
+
+  send(PEER_TIMER_UPDATE, (uint8_t)timer);
+  repeatTimer = (uint8_t)timer;
+  repeatAt = millis() + PEER_UPDATE_REPEAT_DELAY;
+  if (repeatAt == 0) repeatAt = 1;
+}
+
+bool PeerSync::isLeader() {
+  return state.isLeader(millis());
+}
+
+int PeerSync::getPeerCount() {
+  return state.getPeerCount(millis());
+}
+
+void PeerSync::send(uint8_t type, uint8_t timer) {
+  PeerPacket packet;
+  state.buildPacket(&packet, type, timer);
+
+  IPAddress group(PEER_MULTICAST_GROUP);
+  udp.beginPacketMulticast(group, PEER_PORT, WiFi.localIP());
+  udp.write((const uint8_t*)&packet, sizeof(packet));
+  udp.endPacket();
+}
@@ -0,0 +1,47 @@
+#ifndef PEER_SYNC_H
+#define PEER_SYNC_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include "config.h"
+#include "PeerProtocol.h"
+#include "TimerManager.h"
+
+class PeerSync {
+public:
+  PeerSync();
+
+  // Initialize with restored timer state (networking starts once WiFi is up)
+  void begin(TimerManager* timerManager);
+
+  // Receive peer updates, send heartbeats and repeats (call every loop iteration)
+  // Returns bitmask of timers changed by peers (bit 0 = outside)
+  uint8_t update(TimerManager* timerManager);
+
+  // Broadcast a local timer change (ignored while applying a peer update)
+  void onLocalChange(Timer timer, time_t timestamp);
+
+  // Check if this node should send alerts (always true when sync is disabled or alone)
+  bool isLeader();
+
+  // Get number of other trackers currently online
+  int getPeerCount();
+
+private:
+  WiFiUDP udp;
+  PeerState state;
+  bool started;
+  bool applyingRemote;
+  unsigned long lastHeartbeat;
+  unsigned long repeatAt;        // Pending repeat of the last update (0 = none)
+  uint8_t repeatTimer;
+
+  // Join multicast group on the current interface
+  void start();
+
+  // Send current state as a packet
+  void send(uint8_t type, uint8_t timer);
+};
+
+#endif
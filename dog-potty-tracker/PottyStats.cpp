@@ -0,0 +1,225 @@
+#include "PottyStats.h"
+#include <math.h>
+
+PottyStats::PottyStats() :
+  dirty(false)
+{
+  reset();
+  dirty = false;
+}
+
+void PottyStats::record(Timer timer, time_t previous, time_t current) {
+  if (timer > TIMER_POOP || current < 1000000000) {
+    return;  // Invalid timer or time not synced
+  }
+
+  // Moving a timer backwards is a correction of the last event, not a new one
+  bool hasPrevious = previous >= 1000000000;
+  if (hasPrevious && current <= previous) {
+    return;
+  }
+
+  // A second press right after the first is the same event
+  uint32_t interval = hasPrevious ? (uint32_t)(current - previous) : 0;
+  if (hasPrevious && interval < STATS_MIN_INTERVAL) {
+    return;
+  }
+
+  // Interval statistics (Welford for mean/variance, shift-based EWMA)
+  if (hasPrevious && interval <= STATS_MAX_INTERVAL) {
+    IntervalStats& stats = data.intervals[timer];
+    stats.count++;
+    float delta = (float)interval - stats.mean;
+    stats.mean += delta / stats.count;
+    stats.m2 += delta * ((float)interval - stats.mean);
+
+    if (stats.count == 1) {
+      stats.ewma = interval;
+      stats.minimum = interval;
+      stats.maximum = interval;
+    } else {
+      stats.ewma = (uint32_t)((int32_t)stats.ewma + (((int32_t)interval - (int32_t)stats.ewma) >> STATS_EWMA_SHIFT));
+      if (interval < stats.minimum) stats.minimum = interval;
+      if (interval > stats.maximum) stats.maximum = interval;
+    }
+  }
+
+  // Hour of day histogram
+  struct tm* timeinfo = localtime(&current);
+  if (data.hourCounts[timer][timeinfo->tm_hour] < 0xFFFF) {
+    data.hourCounts[timer][timeinfo->tm_hour]++;
+  }
+
+  // Daily counts (events set in the past count towards their own day)
+  int32_t day = getLocalDay(current);
+  if (day > data.currentDay) {
+    rollDays(day);
+  }
+  int32_t daysAgo = data.currentDay - day;
+  if (daysAgo >= 0 && daysAgo < STATS_DAYS && data.dailyCounts[daysAgo][timer] < 0xFF) {
+    data.dailyCounts[daysAgo][timer]++;
+  }
+
+  dirty = true;
+
+  DEBUG_PRINT("Stats: timer ");
+  DEBUG_PRINT(timer);
+  DEBUG_PRINT(" interval ");
+  DEBUG_PRINT(interval);
+  DEBUG_PRINT("s, mean ");
+  DEBUG_PRINT(getMean(timer));
+  DEBUG_PRINT("s, ewma ");
+  DEBUG_PRINT(getEwma(timer));
+  DEBUG_PRINTLN("s");
+}
+
+void PottyStats::reset() {
+  memset(&data, 0, sizeof(data));
+  data.magic = STATS_MAGIC;
+  dirty = true;
+}
+
+uint32_t PottyStats::getIntervalCount(Timer timer) {
+  return data.intervals[timer].count;
+}
+
+uint32_t PottyStats::getMean(Timer timer) {
+  return (uint32_t)(data.intervals[timer].mean + 0.5f);
+}
+
+uint32_t PottyStats::getStdDev(Timer timer) {
+  const IntervalStats& stats = data.intervals[timer];
+  if (stats.count < 2) {
+    return 0;
+  }
+  return (uint32_t)(sqrtf(stats.m2 / (stats.count - 1)) + 0.5f);
+}
+
+uint32_t PottyStats::getEwma(Timer timer) {
+  return data.intervals[timer].ewma;
+}
+
+uint32_t PottyStats::getMin(Timer timer) {
+  return data.intervals[timer].minimum;
+}
+
+uint32_t PottyStats::getMax(Timer timer) {
+  return data.intervals[timer].maximum;
+}
+
+uint16_t PottyStats::getHourCount(Timer timer, int hour) {
+  if (hour < 0 || hour > 23) {
+    return 0;
+  }
+  return data.hourCounts[timer][hour];
+}
+
+int PottyStats::getPeakHour(Timer timer) {
+  int peak = -1;
+  uint16_t best = 0;
+  for (int hour = 0; hour < 24; hour++) {
+    if (data.hourCounts[timer][hour] > best) {
+      best = data.hourCounts[timer][hour];
+      peak = hour;
+    }
+  }
+  return peak;
+}
+
+uint8_t PottyStats::getDailyCount(Timer timer, int daysAgo) {
+  // The window only moves on events, so account for days without any
+  time_t now = time(nullptr);
+  int32_t offset = now >= 1000000000 ? getLocalDay(now) - data.currentDay : 0;
+  int index = daysAgo - offset;
+  if (index < 0 || index >= STATS_DAYS) {
+    return 0;
+  }
+  return data.dailyCounts[index][timer];
+}
+
+String PottyStats::getSummary() {
+  char mean[12];
+  char spread[12];
+  char ewma[12];
+  String summary = "";
+
+  static const Timer timers[] = {TIMER_PEE, TIMER_POOP};
+  static const char* names[] = {"Pee", "Poop"};
+
+  for (int i = 0; i < 2; i++) {
+    Timer timer = timers[i];
+    summary += names[i];
+    if (getIntervalCount(timer) == 0) {
+      summary += ": no intervals yet\n";
+      continue;
+    }
+    formatDuration(getMean(timer), mean, sizeof(mean));
+    formatDuration(getStdDev(timer), spread, sizeof(spread));
+    formatDuration(getEwma(timer), ewma, sizeof(ewma));
+    summary += ": avg " + String(mean) + " (+/-" + spread + "), recent " + ewma;
+    summary += ", n=" + String(getIntervalCount(timer));
+    int peak = getPeakHour(timer);
+    if (peak >= 0) {
+      summary += ", peak " + String(peak) + ":00";
+    }
+    summary += "\n";
+  }
+
+  summary += "Today: " + String(getDailyCount(TIMER_PEE, 0)) + " pee, " +
+             String(getDailyCount(TIMER_POOP, 0)) + " poop, " +
+             String(getDailyCount(TIMER_OUTSIDE, 0)) + " outside\n";
+  summary += "Yesterday: " + String(getDailyCount(TIMER_PEE, 1)) + " pee, " +
+             String(getDailyCount(TIMER_POOP, 1)) + " poop, " +
+             String(getDailyCount(TIMER_OUTSIDE, 1)) + " outside";
+  return summary;
+}
+
+bool PottyStats::isDirty() {
+  return dirty;
+}
+
+void PottyStats::clearDirty() {
+  dirty = false;
+}
+
+StatsData* PottyStats::getData() {
+  return &data;
+}
+
+void PottyStats::restore(const StatsData* saved) {
+  memcpy(&data, saved, sizeof(StatsData));
+  dirty = false;
+}
+
+void PottyStats::formatDuration(uint32_t seconds, char* buffer, size_t size) {
+  uint32_t minutes = (seconds + 30) / 60;
+  if (minutes >= 60) {
+    snprintf(buffer, size, "%luh%02lum", (unsigned long)(minutes / 60), (unsigned long)(minutes % 60));
+  } else {
+    snprintf(buffer, size, "%lum", (unsigned long)minutes);
+  }
+}
+
+void PottyStats::rollDays(int32_t day) {
+  int32_t shift = day - data.currentDay;
+  if (data.currentDay == 0 || shift >= STATS_DAYS) {
+    memset(data.dailyCounts, 0, sizeof(data.dailyCounts));
+  } else if (shift > 0) {
+    memmove(data.dailyCounts[shift], data.dailyCounts[0], sizeof(data.dailyCounts[0]) * (STATS_DAYS - shift));
+    memset(data.dailyCounts[0], 0, sizeof(data.dailyCounts[0]) * shift);
+  }
+  data.currentDay = day;
+}
+
+int32_t PottyStats::getLocalDay(time_t timestamp) {
+  // Days since 1970-01-01 for the local calendar date (civil-from-days inverse)
+  struct tm* timeinfo = localtime(&timestamp);
+  int32_t year = timeinfo->tm_year + 1900;
+  int32_t month = timeinfo->tm_mon + 1;
+  year -= month <= 2;
+  int32_t era = (year >= 0 ? year : year - 399) / 400;
+  int32_t yearOfEra = year - era * 400;
+  int32_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + timeinfo->tm_mday - 1;
+  int32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}
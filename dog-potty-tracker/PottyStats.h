@@ -0,0 +1,83 @@
+#ifndef POTTY_STATS_H
+#define POTTY_STATS_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "config.h"
+#include "TimerManager.h"
+
+// Running statistics for the gaps between consecutive events of one timer
+struct __attribute__((packed)) IntervalStats {
+  uint32_t count;       // Intervals recorded
+  float mean;           // Seconds (Welford running mean)
+  float m2;             // Sum of squared deviations from the mean (Welford)
+  uint32_t ewma;        // Seconds, exponentially weighted (recent routine)
+  uint32_t minimum;     // Seconds
+  uint32_t maximum;     // Seconds
+};
+
+// Fixed-size statistics block persisted in EEPROM (STATS_EEPROM_ADDRESS)
+struct __attribute__((packed)) StatsData {
+  uint32_t magic;                        // STATS_MAGIC when valid
+  IntervalStats intervals[3];            // Indexed by Timer
+  uint16_t hourCounts[3][24];            // Events per local hour of day, indexed by Timer
+  uint8_t dailyCounts[STATS_DAYS][3];    // Events per day, [0] = currentDay
+  int32_t currentDay;                    // Local day number (days since 1970-01-01)
+  uint32_t crc;                          // CRC32 of all preceding bytes (MUST be last)
+};
+
+static_assert(STATS_EEPROM_ADDRESS + sizeof(StatsData) <= EEPROM_SIZE, "StatsData does not fit in EEPROM");
+
+class PottyStats {
+public:
+  PottyStats();
+
+  // Record a timer change (call from the TimerManager change callback)
+  void record(Timer timer, time_t previous, time_t current);
+
+  // Clear all statistics
+  void reset();
+
+  // Interval statistics in seconds (0 if nothing recorded)
+  uint32_t getIntervalCount(Timer timer);
+  uint32_t getMean(Timer timer);
+  uint32_t getStdDev(Timer timer);
+  uint32_t getEwma(Timer timer);
+  uint32_t getMin(Timer timer);
+  uint32_t getMax(Timer timer);
+
+  // Events in a local hour of day (0-23)
+  uint16_t getHourCount(Timer timer, int hour);
+
+  // Hour of day with the most events (-1 if none)
+  int getPeakHour(Timer timer);
+
+  // Events on a day (0 = today, 1 = yesterday, ...)
+  uint8_t getDailyCount(Timer timer, int daysAgo);
+
+  // Multi-line summary for the stats command
+  String getSummary();
+
+  // Check if statistics changed since the last EEPROM commit
+  bool isDirty();
+  void clearDirty();
+
+  // Raw data for persistence (Storage validates magic and CRC)
+  StatsData* getData();
+  void restore(const StatsData* saved);
+
+  // Format seconds as "3h12m" or "45m"
+  static void formatDuration(uint32_t seconds, char* buffer, size_t size);
+
+  // Local day number for a timestamp (days since 1970-01-01 of the local date)
+  static int32_t getLocalDay(time_t timestamp);
+
+private:
+  StatsData data;
+  bool dirty;
+
+  // Move the daily window forward so that [0] is the given day
+  void rollDays(int32_t day);
+};
+
+#endif
@@ -0,0 +1,186 @@
+#include "PowerManager.h"
+#include <ESP8266WiFi.h>
+#include <coredecls.h>
+#include <core_version.h>
+
+// esp_delay(timeout, blocked, interval) (the wake-able idle) was added in core 3.1.0
+#if defined(ARDUINO_ESP8266_MAJOR) && defined(ARDUINO_ESP8266_MINOR) && \
+    (ARDUINO_ESP8266_MAJOR < 3 || (ARDUINO_ESP8266_MAJOR == 3 && ARDUINO_ESP8266_MINOR < 1))
+#error "ESP8266 board package 3.1.0 or newer is required"
+#endif
+
+static const uint8_t BUTTON_PINS[3] = {PIN_BTN_OUTSIDE, PIN_BTN_PEE, PIN_BTN_POOP};
+
+// GPIO pin interrupt types (GPC register, see esp8266_peri.h)
+#define GPIO_INT_RISING 1
+#define GPIO_INT_HIGH_LEVEL 5
+
+volatile bool PowerManager::buttonWoke = false;
+
+// Interrupt type and wake enable of one pin, written directly so it can run in the ISR
+static void IRAM_ATTR setPinInterrupt(uint8_t pin, uint32_t type, bool wake) {
+  uint32_t reg = GPC(pin) & ~((0xF << GPCI) | (1 << GPCWE));
+  GPC(pin) = reg | (type << GPCI) | ((wake ? 1 : 0) << GPCWE);
+}
+
+PowerManager::PowerManager() :
+  awakeSince(0),
+  windowStart(0),
+  awakeMs(0),
+  idleCount(0),
+  buttonWakes(0),
+  lastWindowMs(0),
+  lastAwakeMs(0),
+  lastIdleCount(0),
+  lastButtonWakes(0)
+{
+}
+
+void PowerManager::begin() {
+  if (POWER_SAVE_MODE == 2) {
+    // Automatic light sleep: the SDK stops the CPU and the radio between DTIM beacons
+    // whenever the loop is idle long enough. Unlike forced light sleep it keeps WiFi
+    // associated and the system clock running, so millis() and the timers stay right.
+    WiFi.setSleepMode(WIFI_LIGHT_SLEEP, POWER_LISTEN_INTERVAL);
+  } else if (POWER_SAVE_MODE == 1) {
+    // Modem sleep: the radio is off between beacons, the CPU keeps running
+    WiFi.setSleepMode(WIFI_MODEM_SLEEP, POWER_LISTEN_INTERVAL);
+  }
+
+  if (POWER_SAVE_MODE > 0) {
+    for (int i = 0; i < 3; i++) {
+      attachInterrupt(digitalPinToInterrupt(BUTTON_PINS[i]), onButton, RISING);
+    }
+  }
+
+  awakeSince = millis();
+  windowStart = awakeSince;
+
+  DEBUG_PRINT(F("PowerManager: mode "));
+  DEBUG_PRINTLN(POWER_SAVE_MODE);
+}
+
+void IRAM_ATTR PowerManager::onButton() {
+  // Back to edge interrupts - a level interrupt would fire for as long as the button is held
+  for (int i = 0; i < 3; i++) {
+    setPinInterrupt(BUTTON_PINS[i], GPIO_INT_RISING, false);
+  }
+  buttonWoke = true;
+  esp_schedule();  // Resume loop() now instead of at the end of the idle
+}
+
+void PowerManager::idle(unsigned long timeout) {
+  unsigned long start = millis();
+  awakeMs += start - awakeSince;
+
+  if (POWER_SAVE_MODE == 0) {
+    // Original fixed loop delay
+    delay(10);
+  } else if (timeout == 0) {
+    yield();
+  } else {
+    if (timeout > POWER_MAX_IDLE) {
+      timeout = POWER_MAX_IDLE;
+    }
+    buttonWoke = false;
+    if (POWER_SAVE_MODE == 2) {
+      armWakePins();
+    }
+    esp_delay(timeout, []() { return !buttonWoke; }, timeout);
+    if (POWER_SAVE_MODE == 2) {
+      disarmWakePins();
+    }
+    if (buttonWoke) {
+      buttonWakes++;
+    }
+  }
+
+  unsigned long now = millis();
+  idleCount++;
+  awakeSince = now;
+
+  if (now - windowStart >= POWER_REPORT_INTERVAL) {
+    report(now);
+  }
+}
+
+void PowerManager::armWakePins() {
+  for (int i = 0; i < 3; i++) {
+    // A held button would wake the chip again at once - its release is not a press anyway
+    if (digitalRead(BUTTON_PINS[i]) == LOW) {
+      setPinInterrupt(BUTTON_PINS[i], GPIO_INT_HIGH_LEVEL, true);
+    }
+  }
+}
+
+void PowerManager::disarmWakePins() {
+  noInterrupts();
+  for (int i = 0; i < 3; i++) {
+    setPinInterrupt(BUTTON_PINS[i], GPIO_INT_RISING, false);
+  }
+  interrupts();
+}
+
+void PowerManager::report(unsigned long now) {
+  lastWindowMs = now - windowStart;
+  lastAwakeMs = awakeMs;
+  lastIdleCount = idleCount;
+  lastButtonWakes = buttonWakes;
+
+  DEBUG_PRINT(F("PowerManager: awake "));
+  unsigned int permille = dutyPermille(lastAwakeMs, lastWindowMs);
+  DEBUG_PRINT(permille / 10);
+  DEBUG_PRINT('.');
+  DEBUG_PRINT(permille % 10);
+  DEBUG_PRINT(F("% ("));
+  DEBUG_PRINT(awakePerHour(lastAwakeMs, lastWindowMs));
+  DEBUG_PRINT(F(" ms per hour), "));
+  DEBUG_PRINT(lastIdleCount);
+  DEBUG_PRINT(F(" idles, "));
+  DEBUG_PRINT(lastButtonWakes);
+  DEBUG_PRINTLN(F(" button wakes"));
+
+  windowStart = now;
+  awakeMs = 0;
+  idleCount = 0;
+  buttonWakes = 0;
+}
+
+String PowerManager::getSummary() {
+  // Current window until the first one has been completed
+  unsigned long window = lastWindowMs;
+  unsigned long awake = lastAwakeMs;
+  unsigned long idles = lastIdleCount;
+  unsigned long wakes = lastButtonWakes;
+  if (window == 0) {
+    window = millis() - windowStart;
+    awake = awakeMs + (millis() - awakeSince);
+    idles = idleCount;
+    wakes = buttonWakes;
+  }
+
+  String summary = F("Power save: ");
+  summary += POWER_SAVE_MODE == 2 ? F("light sleep") : POWER_SAVE_MODE == 1 ? F("modem sleep") : F("off");
+
+  unsigned int permille = dutyPermille(awake, window);
+  char buffer[128];
+  snprintf_P(buffer, sizeof(buffer),
+             PSTR("\nAwake %u.%u%% of the time (%lu ms per hour)\nLast %lu min: %lu idles, %lu ended by a button"),
+             permille / 10, permille % 10, awakePerHour(awake, window), window / 60000, idles, wakes);
+  summary += buffer;
+  return summary;
+}
+
+unsigned int PowerManager::dutyPermille(unsigned long awake, unsigned long window) {
+  if (window == 0) {
+    return 1000;
+  }
+  return (unsigned int)((uint64_t)awake * 1000 / window);
+}
+
+unsigned long PowerManager::awakePerHour(unsigned long awake, unsigned long window) {
+  if (window == 0) {
+    return 0;
+  }
+  return (unsigned long)((uint64_t)awake * 3600000UL / window);
+}
@@ -0,0 +1,56 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Replaces the fixed delay at the end of loop() with an idle that lasts until the
+// loop next has work to do (the caller works out that deadline from the display,
+// buttons and network services), so the WiFi modem - and with POWER_SAVE_MODE 2 the
+// CPU - can sleep in between. A button press ends the idle straight away through a
+// pin interrupt, so presses are seen as quickly as with the old 10 ms loop.
+// Awake and idle time are measured for a duty-cycle report (current proxy).
+class PowerManager {
+public:
+  PowerManager();
+
+  // Set the WiFi sleep type and attach the button wake interrupts (after WiFi begin)
+  void begin();
+
+  // Wait at most timeout ms (capped to POWER_MAX_IDLE); returns early on a button press
+  void idle(unsigned long timeout);
+
+  // Duty cycle of the last full report window (or the current one during the first)
+  String getSummary();
+
+private:
+  // Time accounting for the current report window
+  unsigned long awakeSince;     // End of the last idle
+  unsigned long windowStart;
+  unsigned long awakeMs;
+  unsigned long idleCount;
+  unsigned long buttonWakes;
+
+  // Last completed window
+  unsigned long lastWindowMs;
+  unsigned long lastAwakeMs;
+  unsigned long lastIdleCount;
+  unsigned long lastButtonWakes;
+
+  // Set from the button interrupt, ends the idle
+  static volatile bool buttonWoke;
+  static void IRAM_ATTR onButton();
+
+  // Light sleep: wake the chip on a released button going HIGH (level, not edge)
+  void armWakePins();
+  void disarmWakePins();
+
+  // Close the report window and log it
+  void report(unsigned long now);
+
+  // Awake share in tenths of a percent and awake ms per hour of a window
+  static unsigned int dutyPermille(unsigned long awake, unsigned long window);
+  static unsigned long awakePerHour(unsigned long awake, unsigned long window);
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "RecipientRegistry.h"
+
+RecipientRegistry::RecipientRegistry() :
+  recipientCount(0),
+  botCount(0)
+{
+}
+
+void RecipientRegistry::begin(const TelegramRecipient* table, int count) {
+  recipientCount = 0;
+  botCount = 0;
+
+  // Collect distinct bots first so recipients can be grouped by bot below
+  for (int i = 0; i < count; i++) {
+    const TelegramRecipient& entry = table[i];
+    if (entry.botToken == nullptr || entry.botToken[0] == '\0' ||
+        entry.chatId == nullptr || entry.chatId[0] == '\0') {
+      continue;
+    }
+    bool known = false;
+    for (int b = 0; b < botCount; b++) {
+      if (strcmp(bots[b], entry.botToken) == 0) {
+        known = true;
+        break;
+      }
+    }
+    if (!known) {
+      if (botCount == TELEGRAM_MAX_BOTS) {
+        DEBUG_PRINTLN("RecipientRegistry: Too many bots - raise TELEGRAM_MAX_BOTS");
+        continue;
+      }
+      bots[botCount++] = entry.botToken;
+    }
+  }
+
+  // Recipients in bot order (stable within a bot, so indexes follow secrets.h)
+  for (int b = 0; b < botCount; b++) {
+    for (int i = 0; i < count; i++) {
+      const TelegramRecipient& entry = table[i];
+      if (entry.chatId == nullptr || entry.chatId[0] == '\0' ||
+          entry.botToken == nullptr || strcmp(entry.botToken, bots[b]) != 0) {
+        continue;
+      }
+      if (recipientCount == TELEGRAM_MAX_RECIPIENTS) {
+        DEBUG_PRINTLN("RecipientRegistry: Too many recipients - raise TELEGRAM_MAX_RECIPIENTS");
+        break;
+      }
+      recipients[recipientCount] = &entry;
+      recipientBots[recipientCount] = b;
+      recipientCount++;
+    }
+  }
+
+  DEBUG_PRINT("RecipientRegistry: ");
+  DEBUG_PRINT(recipientCount);
+  DEBUG_PRINT(" recipient(s) on ");
+  DEBUG_PRINT(botCount);
+  DEBUG_PRINTLN(" bot(s)");
+}
+
+int RecipientRegistry::getCount() {
+  return recipientCount;
+}
+
+const char* RecipientRegistry::getBotToken(int recipient) {
+  return recipient >= 0 && recipient < recipientCount ? recipients[recipient]->botToken : "";
+}
+
+const char* RecipientRegistry::getChatId(int recipient) {
+  return recipient >= 0 && recipient < recipientCount ? recipients[recipient]->chatId : "";
+}
+
+bool RecipientRegistry::wantsEvent(int recipient, uint8_t event) {
+  return recipient >= 0 && recipient < recipientCount && (recipients[recipient]->events & event) != 0;
+}
+
+int RecipientRegistry::getBotCount() {
+  return botCount;
+}
+
+const char* RecipientRegistry::getBot(int bot) {
+  return bot >= 0 && bot < botCount ? bots[bot] : "";
+}
+
+int RecipientRegistry::getBotIndex(int recipient) {
+  return recipient >= 0 && recipient < recipientCount ? recipientBots[recipient] : -1;
+}
+
+bool RecipientRegistry::isAuthorized(int bot, const char* chatId) {
+  for (int i = 0; i < recipientCount; i++) {
+    if (recipientBots[i] == bot && strcmp(recipients[i]->chatId, chatId) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
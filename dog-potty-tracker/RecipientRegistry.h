@@ -0,0 +1,55 @@
+#ifndef RECIPIENT_REGISTRY_H
+#define RECIPIENT_REGISTRY_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Notifications a recipient subscribes to (TelegramRecipient::events)
+#define NOTIFY_EVENT_STARTUP  0x01  // Tracker came online
+#define NOTIFY_EVENT_YELLOW   0x02  // Yellow LED turned on
+#define NOTIFY_EVENT_RED      0x04  // Red LED turned on
+#define NOTIFY_EVENT_BUTTONS  0x08  // Button press digests
+#define NOTIFY_EVENT_ALL      0x0F
+
+// One person receiving Telegram notifications (table lives in secrets.h)
+struct TelegramRecipient {
+  const char* botToken;
+  const char* chatId;
+  uint8_t events;              // NOTIFY_EVENT_* bits
+};
+
+// Validated recipient table, ordered so recipients sharing a bot are adjacent.
+// Every Telegram send goes to the same host, so walking the table in order keeps
+// one TLS connection busy instead of opening one per recipient.
+class RecipientRegistry {
+public:
+  RecipientRegistry();
+
+  // Load the recipient table (blank entries are skipped, extra entries are ignored)
+  void begin(const TelegramRecipient* table, int count);
+
+  // Number of usable recipients (indexes are 0 to getCount() - 1)
+  int getCount();
+
+  // Recipient details
+  const char* getBotToken(int recipient);
+  const char* getChatId(int recipient);
+  bool wantsEvent(int recipient, uint8_t event);
+
+  // Distinct bots (each one is polled for commands)
+  int getBotCount();
+  const char* getBot(int bot);
+  int getBotIndex(int recipient);
+
+  // Check if a chat may send commands to a bot
+  bool isAuthorized(int bot, const char* chatId);
+
+private:
+  const TelegramRecipient* recipients[TELEGRAM_MAX_RECIPIENTS];
+  uint8_t recipientBots[TELEGRAM_MAX_RECIPIENTS];
+  const char* bots[TELEGRAM_MAX_BOTS];
+  int recipientCount;
+  int botCount;
+};
+
+#endif
@@ -0,0 +1,326 @@
+#include "RuntimeConfig.h"
+#include "RecipientRegistry.h"
+
+static_assert(NOTIFY_SETTING_STARTUP == NOTIFY_EVENT_STARTUP && NOTIFY_SETTING_YELLOW == NOTIFY_EVENT_YELLOW &&
+              NOTIFY_SETTING_RED == NOTIFY_EVENT_RED, "Alert bits of notifyEvents must match NOTIFY_EVENT_*");
+
+#define CONFIG_TYPE_U16 0
+#define CONFIG_TYPE_I8  1
+#define CONFIG_TYPE_U8  2
+
+// Name, position and range of each setting (indexed by ConfigKey)
+struct ConfigKeyInfo {
+  char name[12];
+  uint8_t offset;     // offsetof(ConfigSettings, ...)
+  uint8_t type;       // CONFIG_TYPE_*
+  int16_t minimum;
+  int16_t maximum;
+};
+
+static const ConfigKeyInfo CONFIG_KEYS[CONFIG_KEY_COUNT] PROGMEM = {
+  {"yellow",     offsetof(ConfigSettings, yellowThreshold), CONFIG_TYPE_U16, 1, 1439},
+  {"red",        offsetof(ConfigSettings, redThreshold),    CONFIG_TYPE_U16, 1, 1439},
+  {"nightstart", offsetof(ConfigSettings, nightStartHour),  CONFIG_TYPE_I8, -1, 23},
+  {"nightend",   offsetof(ConfigSettings, nightEndHour),    CONFIG_TYPE_I8, -1, 23},
+  {"quietstart", offsetof(ConfigSettings, quietStartHour),  CONFIG_TYPE_I8, -1, 23},
+  {"quietend",   offsetof(ConfigSettings, quietEndHour),    CONFIG_TYPE_I8, -1, 23},
+  {"notify",     offsetof(ConfigSettings, notifyEvents),    CONFIG_TYPE_U8, 0, NOTIFY_SETTING_ALL},
+  {"predict",    offsetof(ConfigSettings, predict),         CONFIG_TYPE_U8, 0, 1}
+};
+
+// Events switched on by the NOTIFY_ON_* build settings
+static uint8_t defaultNotifyEvents() {
+  return NOTIFY_SETTING_STARTUP |
+         (NOTIFY_ON_YELLOW ? NOTIFY_SETTING_YELLOW : 0) |
+         (NOTIFY_ON_RED ? NOTIFY_SETTING_RED : 0) |
+         (NOTIFY_ON_OUTSIDE ? NOTIFY_SETTING_OUTSIDE : 0) |
+         (NOTIFY_ON_PEE ? NOTIFY_SETTING_PEE : 0) |
+         (NOTIFY_ON_POOP ? NOTIFY_SETTING_POOP : 0);
+}
+
+static ConfigKeyInfo readKey(int key) {
+  ConfigKeyInfo info;
+  memcpy_P(&info, &CONFIG_KEYS[key], sizeof(info));
+  return info;
+}
+
+RuntimeConfig::RuntimeConfig() :
+  dirty(false),
+  revision(0)
+{
+  reset();
+  dirty = false;
+}
+
+void RuntimeConfig::reset() {
+  memset(&data, 0, sizeof(data));
+  data.header.magic = CONFIG_MAGIC;
+  data.header.version = CONFIG_VERSION;
+  data.header.length = sizeof(ConfigSettings);
+
+  data.settings.yellowThreshold = YELLOW_THRESHOLD;
+  data.settings.redThreshold = RED_THRESHOLD;
+  data.settings.nightStartHour = NIGHT_MODE_START_HOUR;
+  data.settings.nightEndHour = NIGHT_MODE_END_HOUR;
+  data.settings.quietStartHour = NOTIFICATION_QUIET_START_HOUR;
+  data.settings.quietEndHour = NOTIFICATION_QUIET_END_HOUR;
+  data.settings.notifyEvents = defaultNotifyEvents();
+  data.settings.predict = PREDICT_ENABLED ? 1 : 0;
+
+  dirty = true;
+  revision++;
+}
+
+int RuntimeConfig::findKey(const char* name) {
+  for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+    if (strcmp_P(name, CONFIG_KEYS[i].name) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool RuntimeConfig::set(int key, long value, String& message) {
+  ConfigKeyInfo info = readKey(key);
+  char buffer[64];
+  if (!checkRange(key, value, message)) {
+    return false;
+  }
+
+  // Validate the whole set before anything in use changes
+  ConfigSettings candidate = data.settings;
+  setValue(&candidate, key, value);
+  if (!apply(candidate, message)) {
+    return false;
+  }
+
+  snprintf_P(buffer, sizeof(buffer), PSTR("%s set to %ld"), info.name, value);
+  message = buffer;
+  DEBUG_PRINT(F("RuntimeConfig: "));
+  DEBUG_PRINTLN(message);
+  return true;
+}
+
+bool RuntimeConfig::setWindow(int startKey, long start, long end, String& message) {
+  if (!checkRange(startKey, start, message) || !checkRange(startKey + 1, end, message)) {
+    return false;
+  }
+
+  // Both hours change together, so a window can be moved or switched on in one step
+  ConfigSettings candidate = data.settings;
+  setValue(&candidate, startKey, start);
+  setValue(&candidate, startKey + 1, end);
+  if (!apply(candidate, message)) {
+    return false;
+  }
+
+  ConfigKeyInfo startInfo = readKey(startKey);
+  ConfigKeyInfo endInfo = readKey(startKey + 1);
+  char buffer[64];
+  snprintf_P(buffer, sizeof(buffer), PSTR("%s set to %ld, %s set to %ld"), startInfo.name, start, endInfo.name, end);
+  message = buffer;
+  DEBUG_PRINT(F("RuntimeConfig: "));
+  DEBUG_PRINTLN(message);
+  return true;
+}
+
+bool RuntimeConfig::checkRange(int key, long value, String& message) {
+  ConfigKeyInfo info = readKey(key);
+  if (value < info.minimum || value > info.maximum) {
+    char buffer[64];
+    snprintf_P(buffer, sizeof(buffer), PSTR("%s must be %d to %d"), info.name, info.minimum, info.maximum);
+    message = buffer;
+    return false;
+  }
+  return true;
+}
+
+bool RuntimeConfig::apply(const ConfigSettings& candidate, String& message) {
+  if (!validate(&candidate, message)) {
+    return false;
+  }
+  data.settings = candidate;
+  dirty = true;
+  revision++;
+  return true;
+}
+
+bool RuntimeConfig::set(const char* assignment, String& message) {
+  char name[sizeof(ConfigKeyInfo::name)];
+  const char* space = strchr(assignment, ' ');
+  if (space == nullptr || (size_t)(space - assignment) >= sizeof(name)) {
+    message = F("Use: set <key> <value> (see config for the keys)");
+    return false;
+  }
+  memcpy(name, assignment, space - assignment);
+  name[space - assignment] = '\0';
+  const char* text = space + 1;
+
+  // "night <start> <end>" / "quiet <start> <end>" (or off) set both hours of a window
+  bool isNight = strcmp_P(name, PSTR("night")) == 0;
+  if (isNight || strcmp_P(name, PSTR("quiet")) == 0) {
+    int startKey = isNight ? CONFIG_NIGHT_START : CONFIG_QUIET_START;
+    if (strcmp_P(text, PSTR("off")) == 0) {
+      return setWindow(startKey, -1, -1, message);
+    }
+    char* end;
+    long start = strtol(text, &end, 10);
+    char* last;
+    long stop = strtol(end, &last, 10);
+    if (end == text || last == end || *last != '\0') {
+      message = F("Use: set night|quiet <start hour> <end hour> (or off)");
+      return false;
+    }
+    return setWindow(startKey, start, stop, message);
+  }
+
+  int key = findKey(name);
+  if (key < 0) {
+    message = F("Unknown setting (see config for the keys)");
+    return false;
+  }
+
+  // on/off for the switches, off (-1) for the hours, otherwise a decimal number
+  bool isSwitch = key == CONFIG_NOTIFY || key == CONFIG_PREDICT;
+  long value;
+  if (isSwitch && strcmp_P(text, PSTR("on")) == 0) {
+    value = key == CONFIG_NOTIFY ? NOTIFY_SETTING_ALL : 1;
+  } else if (strcmp_P(text, PSTR("off")) == 0) {
+    value = isSwitch ? 0 : -1;
+  } else {
+    char* end;
+    value = strtol(text, &end, 10);
+    if (end == text || *end != '\0') {
+      message = F("Value must be a number (or on/off)");
+      return false;
+    }
+  }
+
+  return set(key, value, message);
+}
+
+// An hour window is off (both -1) or has two different hours
+static bool isValidWindow(int8_t start, int8_t end) {
+  if (start == -1 || end == -1) {
+    return start == end;
+  }
+  return start != end;
+}
+
+bool RuntimeConfig::validate(const ConfigSettings* settings, String& message) {
+  if (settings->yellowThreshold >= settings->redThreshold) {
+    message = F("Yellow must be below red");
+    return false;
+  }
+  if (!isValidWindow(settings->nightStartHour, settings->nightEndHour)) {
+    message = F("Night start and end must differ, or both be off (set night off)");
+    return false;
+  }
+  if (!isValidWindow(settings->quietStartHour, settings->quietEndHour)) {
+    message = F("Quiet start and end must differ, or both be off (set quiet off)");
+    return false;
+  }
+  return true;
+}
+
+bool RuntimeConfig::isHourInWindow(int8_t start, int8_t end, int hour) {
+  if (start == -1 || end == -1) {
+    return false;
+  }
+  if (start < end) {
+    return start <= hour && hour < end;
+  }
+  // Window across midnight (e.g. 22 to 7)
+  return hour >= start || hour < end;
+}
+
+long RuntimeConfig::getValue(int key) {
+  ConfigKeyInfo info = readKey(key);
+  const uint8_t* field = (const uint8_t*)&data.settings + info.offset;
+  switch (info.type) {
+    case CONFIG_TYPE_U16: {
+      uint16_t value;
+      memcpy(&value, field, sizeof(value));
+      return value;
+    }
+    case CONFIG_TYPE_I8:
+      return (int8_t)*field;
+    default:
+      return *field;
+  }
+}
+
+void RuntimeConfig::setValue(ConfigSettings* settings, int key, long value) {
+  ConfigKeyInfo info = readKey(key);
+  uint8_t* field = (uint8_t*)settings + info.offset;
+  if (info.type == CONFIG_TYPE_U16) {
+    uint16_t word = (uint16_t)value;
+    memcpy(field, &word, sizeof(word));
+  } else {
+    *field = (uint8_t)value;
+  }
+}
+
+String RuntimeConfig::getSummary() {
+  String summary = F("Settings (set <key> <value>, -1 = off):");
+  char line[32];
+  for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+    ConfigKeyInfo info = readKey(i);
+    snprintf_P(line, sizeof(line), PSTR("\n%s = %ld"), info.name, getValue(i));
+    summary += line;
+  }
+  return summary;
+}
+
+unsigned long RuntimeConfig::getRevision() {
+  return revision;
+}
+
+bool RuntimeConfig::isDirty() {
+  return dirty;
+}
+
+void RuntimeConfig::clearDirty() {
+  dirty = false;
+}
+
+ConfigData* RuntimeConfig::getData() {
+  data.header.magic = CONFIG_MAGIC;
+  data.header.version = CONFIG_VERSION;
+  data.header.length = sizeof(ConfigSettings);
+  return &data;
+}
+
+bool RuntimeConfig::restore(const ConfigHeader* header, const uint8_t* settings) {
+  // Defaults first, then whatever part of the settings the stored version has
+  reset();
+  size_t length = min((size_t)header->length, sizeof(ConfigSettings));
+  memcpy(&data.settings, settings, length);
+
+  // Per-version conversions
+  if (header->version < 2) {
+    // Version 1 had one bit (0x08) for all buttons and the NOTIFY_ON_* switches on top
+    uint8_t old = data.settings.notifyEvents;
+    uint8_t buttons = NOTIFY_SETTING_OUTSIDE | NOTIFY_SETTING_PEE | NOTIFY_SETTING_POOP;
+    data.settings.notifyEvents = (old & (NOTIFY_SETTING_STARTUP | NOTIFY_SETTING_YELLOW | NOTIFY_SETTING_RED) & defaultNotifyEvents()) |
+                                 ((old & 0x08) ? (defaultNotifyEvents() & buttons) : 0);
+  }
+
+  // A value outside its range means the block is not what it claims to be
+  String message;
+  bool valid = validate(&data.settings, message);
+  for (int i = 0; i < CONFIG_KEY_COUNT && valid; i++) {
+    ConfigKeyInfo info = readKey(i);
+    long value = getValue(i);
+    valid = value >= info.minimum && value <= info.maximum;
+  }
+  if (!valid) {
+    reset();
+    dirty = false;
+    return false;
+  }
+
+  // Rewrite an older block in the current layout with the next commit
+  dirty = header->version < CONFIG_VERSION;
+  return true;
+}
@@ -0,0 +1,128 @@
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#define CONFIG_VERSION 2                // Layout version of ConfigSettings (bump when appending fields)
+
+// Bits of notifyEvents - the alerts match NOTIFY_EVENT_*, each button has its own
+#define NOTIFY_SETTING_STARTUP  0x01
+#define NOTIFY_SETTING_YELLOW   0x02
+#define NOTIFY_SETTING_RED      0x04
+#define NOTIFY_SETTING_OUTSIDE  0x08
+#define NOTIFY_SETTING_PEE      0x10
+#define NOTIFY_SETTING_POOP     0x20
+#define NOTIFY_SETTING_ALL      0x3F
+#define NOTIFY_SETTING_BUTTON(timer) (NOTIFY_SETTING_OUTSIDE << (timer))
+
+// Header of the configuration block (CONFIG_EEPROM_ADDRESS), the same in every version
+struct __attribute__((packed)) ConfigHeader {
+  uint32_t magic;       // CONFIG_MAGIC when valid
+  uint8_t version;      // CONFIG_VERSION of the firmware that wrote the block
+  uint8_t length;       // Bytes of settings that follow
+  uint16_t reserved;
+  uint32_t crc;         // CRC32 of the settings (length bytes)
+};
+
+// Tunable settings, copied from EEPROM at boot and range-checked
+// Fields are only ever appended: an older block maps onto the front, newer fields keep their defaults
+struct __attribute__((packed)) ConfigSettings {
+  uint16_t yellowThreshold;   // Minutes since the last pee
+  uint16_t redThreshold;
+  int8_t nightStartHour;      // 0-23, -1 = no night mode
+  int8_t nightEndHour;
+  int8_t quietStartHour;      // 0-23, -1 = no quiet hours
+  int8_t quietEndHour;
+  uint8_t notifyEvents;       // NOTIFY_SETTING_* sent at all (on top of each recipient's own flags)
+  uint8_t predict;            // Predictive alerts (0/1)
+};
+
+struct __attribute__((packed)) ConfigData {
+  ConfigHeader header;
+  ConfigSettings settings;
+};
+
+#define CONFIG_MAX_LENGTH (STATS_EEPROM_ADDRESS - CONFIG_EEPROM_ADDRESS - sizeof(ConfigHeader))
+
+static_assert(sizeof(ConfigSettings) <= CONFIG_MAX_LENGTH, "ConfigSettings overlaps StatsData");
+
+// Settings that can be changed with "set <key> <value>" (indexes into the key table)
+enum ConfigKey {
+  CONFIG_YELLOW,
+  CONFIG_RED,
+  CONFIG_NIGHT_START,
+  CONFIG_NIGHT_END,
+  CONFIG_QUIET_START,
+  CONFIG_QUIET_END,
+  CONFIG_NOTIFY,
+  CONFIG_PREDICT,
+  CONFIG_KEY_COUNT
+};
+
+// Settings that used to be fixed in config.h (or lost on reboot), persisted through Storage.
+// config.h supplies the defaults until a setting is changed. Reads go straight to the
+// settings struct; a change is validated on a copy and only then swapped in and committed.
+class RuntimeConfig {
+public:
+  RuntimeConfig();
+
+  // Current settings (no lookup, use freely in the loop)
+  const ConfigSettings& get() const { return data.settings; }
+
+  // Find a key by name (-1 if unknown)
+  int findKey(const char* name);
+
+  // Change one setting; false (with the reason in message) if out of range or inconsistent
+  bool set(int key, long value, String& message);
+
+  // Set both hours of a window (CONFIG_NIGHT_START or CONFIG_QUIET_START, -1 -1 = off)
+  bool setWindow(int startKey, long start, long end, String& message);
+
+  // Parse "<key> <value>" (numbers, or on/off) and change the setting
+  // "night <start> <end>" and "quiet <start> <end>" (or off) change both hours at once
+  bool set(const char* assignment, String& message);
+
+  // Back to the config.h defaults
+  void reset();
+
+  // All settings as "key=value" lines for the config command
+  String getSummary();
+
+  // True if hour is in start..end-1 (wrapping past midnight when start > end), false if off (-1)
+  static bool isHourInWindow(int8_t start, int8_t end, int hour);
+
+  // Incremented on every change (so cached values can be refreshed)
+  unsigned long getRevision();
+
+  // Check if the settings changed since the last save
+  bool isDirty();
+  void clearDirty();
+
+  // Access block for persistence (Storage fills in the header)
+  ConfigData* getData();
+
+  // Copy a stored block over the defaults and validate it; older versions are migrated forward
+  // Returns false (keeping the defaults) if a value is out of range
+  bool restore(const ConfigHeader* header, const uint8_t* settings);
+
+private:
+  ConfigData data;
+  bool dirty;
+  unsigned long revision;
+
+  // Read or write one setting through the key table
+  long getValue(int key);
+  void setValue(ConfigSettings* settings, int key, long value);
+
+  // Cross-field checks on a candidate (false with the reason in message)
+  bool validate(const ConfigSettings* settings, String& message);
+
+  // Range check of one value (false with the reason in message)
+  bool checkRange(int key, long value, String& message);
+
+  // Validate a candidate and swap it in
+  bool apply(const ConfigSettings& candidate, String& message);
+};
+
+#endif
@@ -1,6 +1,21 @@
 #include "Storage.h"
 
-Storage::Storage() {
+Storage::Storage() :
+  committedValid(false),
+  dirty(false),
+  dirtySince(0),
+  stats(nullptr),
+  predictor(nullptr),
+  config(nullptr),
+  lastVccCheck(0),
+  commitCount(0),
+  skippedCommitCount(0),
+  commitsToday(0),
+  commitDay(-1)
+{
+  memset(&data, 0, sizeof(data));
+  memset(&committedData, 0, sizeof(committedData));
+  memset(&lastHotState, 0, sizeof(lastHotState));
 }
 
 void Storage::begin() {
@@ -8,11 +23,22 @@ void Storage::begin() {
   DEBUG_PRINTLN("Storage initialized");
 }
 
-void Storage::save(TimerManager* timerManager) {
+bool Storage::save(TimerManager* timerManager) {
   // Populate data structure
   data.outsideTimestamp = (uint32_t)timerManager->getTimestamp(TIMER_OUTSIDE);
   data.peeTimestamp = (uint32_t)timerManager->getTimestamp(TIMER_PEE);
   data.poopTimestamp = (uint32_t)timerManager->getTimestamp(TIMER_POOP);
+
+  dirty = false;
+
+  // Skip the flash commit if the timers, stats and model match what is already stored
+  uint8_t dirtyFields = getDirtyFields();
+  if (dirtyFields == 0) {
+    skippedCommitCount++;
+    DEBUG_PRINTLN("Storage: Data unchanged - skipping EEPROM commit");
+    return false;
+  }
+
   data.lastSaveTime = (uint32_t)time(nullptr);
 
   // Calculate checksum
@@ -21,15 +47,47 @@ void Storage::save(TimerManager* timerManager) {
   DEBUG_PRINTLN("Storage: Saving to EEPROM...");
   DEBUG_PRINT("  Structure size: ");
   DEBUG_PRINTLN(sizeof(PersistentData));
+  DEBUG_PRINT("  Dirty fields: 0x");
   #ifdef DEBUG
+    Serial.println(dirtyFields, HEX);
     Serial.print("  Calculated checksum: 0x");
     Serial.println(data.checksum, HEX);
   #endif
 
-  // Write to EEPROM
+  // Write to EEPROM (all changed blocks share one flash commit)
   EEPROM.put(EEPROM_ADDRESS, data);
+  if (dirtyFields & STORAGE_FIELD_STATS) {
+    StatsData* statsData = stats->getData();
+    statsData->crc = calculateCrc32((uint8_t*)statsData, offsetof(StatsData, crc));
+    EEPROM.put(STATS_EEPROM_ADDRESS, *statsData);
+    stats->clearDirty();
+  }
+  if (dirtyFields & STORAGE_FIELD_PREDICT) {
+    PredictorData* model = predictor->getData();
+    model->crc = calculateCrc32((uint8_t*)model, offsetof(PredictorData, crc));
+    EEPROM.put(PREDICT_EEPROM_ADDRESS, *model);
+    predictor->clearDirty();
+  }
+  if (dirtyFields & STORAGE_FIELD_CONFIG) {
+    ConfigData* block = config->getData();
+    block->header.crc = calculateCrc32((uint8_t*)&block->settings, block->header.length);
+    EEPROM.put(CONFIG_EEPROM_ADDRESS, *block);
+    config->clearDirty();
+  }
   EEPROM.commit();
 
+  memcpy(&committedData, &data, sizeof(PersistentData));
+  committedValid = true;
+
+  // Track commits per day (flash wear telemetry)
+  long day = getDayNumber();
+  if (day != commitDay) {
+    commitDay = day;
+    commitsToday = 0;
+  }
+  commitCount++;
+  commitsToday++;
+
   DEBUG_PRINTLN("Storage: Data saved to EEPROM successfully");
   DEBUG_PRINT("  Outside: ");
   DEBUG_PRINTLN(data.outsideTimestamp);
@@ -37,6 +95,74 @@ void Storage::save(TimerManager* timerManager) {
   DEBUG_PRINTLN(data.peeTimestamp);
   DEBUG_PRINT("  Poop: ");
   DEBUG_PRINTLN(data.poopTimestamp);
+  DEBUG_PRINT("  Commits today: ");
+  DEBUG_PRINT(commitsToday);
+  DEBUG_PRINT(" (skipped total: ");
+  DEBUG_PRINT(skippedCommitCount);
+  DEBUG_PRINTLN(")");
+
+  return true;
+}
+
+void Storage::markDirty() {
+  // Start the coalescing window on the first change only, so a burst of
+  // changes (e.g. setall updating three timers) ends up in one commit
+  if (!dirty) {
+    dirty = true;
+    dirtySince = millis();
+  }
+}
+
+void Storage::update(TimerManager* timerManager) {
+  if (!dirty) {
+    return;
+  }
+
+  // Commit once the coalescing window has passed
+  if (millis() - dirtySince >= EEPROM_COALESCE_WINDOW) {
+    save(timerManager);
+    return;
+  }
+
+  #if EEPROM_BROWNOUT_MV > 0
+    // Supply is dropping - commit now rather than lose the pending changes
+    if (millis() - lastVccCheck >= EEPROM_VCC_CHECK_INTERVAL) {
+      lastVccCheck = millis();
+      uint16_t vcc = ESP.getVcc();
+      if (vcc < EEPROM_BROWNOUT_MV) {
+        DEBUG_PRINT("Storage: Low voltage (");
+        DEBUG_PRINT(vcc);
+        DEBUG_PRINTLN(" mV) - flushing now");
+        save(timerManager);
+      }
+    }
+  #endif
+}
+
+void Storage::flush(TimerManager* timerManager) {
+  if (dirty) {
+    save(timerManager);
+  }
+}
+
+bool Storage::isDirty() {
+  return dirty;
+}
+
+unsigned long Storage::getCommitCount() {
+  return commitCount;
+}
+
+unsigned long Storage::getSkippedCommitCount() {
+  return skippedCommitCount;
+}
+
+unsigned long Storage::getCommitsToday() {
+  // Counter belongs to a previous day if no commit happened since midnight
+  if (getDayNumber() != commitDay) {
+    return 0;
+  }
+  return commitsToday;
 }
 
 bool Storage::load(TimerManager* timerManager) {
@@ -71,6 +197,10 @@ bool Storage::load(TimerManager* timerManager) {
     return false;
   }
 
+  // Flash now holds exactly this data (used to skip unchanged commits)
+  memcpy(&committedData, &data, sizeof(PersistentData));
+  committedValid = true;
+
   // Restore timer timestamps
   timerManager->setTimestamp(TIMER_OUTSIDE, (time_t)data.outsideTimestamp);
   timerManager->setTimestamp(TIMER_PEE, (time_t)data.peeTimestamp);
@@ -89,6 +219,18 @@ bool Storage::load(TimerManager* timerManager) {
   return true;
 }
 
+bool Storage::readCommitted() {
+  // EEPROM.begin() already copied the sector to RAM - no flash access here
+  PersistentData stored;
+  EEPROM.get(EEPROM_ADDRESS, stored);
+  if (stored.checksum != calculateChecksum(&stored)) {
+    return false;
+  }
+  memcpy(&committedData, &stored, sizeof(PersistentData));
+  committedValid = true;
+  return true;
+}
+
 bool Storage::isValid() {
   // Read from EEPROM
   EEPROM.get(EEPROM_ADDRESS, data);
@@ -98,6 +240,132 @@ bool Storage::isValid() {
   return data.checksum == expectedChecksum;
 }
 
+void Storage::setStats(PottyStats* stats) {
+  this->stats = stats;
+}
+
+bool Storage::loadStats() {
+  if (stats == nullptr) {
+    return false;
+  }
+
+  StatsData saved;
+  EEPROM.get(STATS_EEPROM_ADDRESS, saved);
+
+  if (saved.magic != STATS_MAGIC) {
+    DEBUG_PRINTLN("Storage: No statistics in EEPROM - starting fresh");
+    return false;
+  }
+
+  uint32_t expectedCrc = calculateCrc32((uint8_t*)&saved, offsetof(StatsData, crc));
+  if (saved.crc != expectedCrc) {
+    DEBUG_PRINTLN("Storage: Statistics CRC mismatch - starting fresh");
+    return false;
+  }
+
+  stats->restore(&saved);
+  DEBUG_PRINTLN("Storage: Statistics loaded from EEPROM");
+  return true;
+}
+
+void Storage::setPredictor(PeePredictor* predictor) {
+  this->predictor = predictor;
+}
+
+bool Storage::loadPredictor() {
+  if (predictor == nullptr) {
+    return false;
+  }
+
+  PredictorData saved;
+  EEPROM.get(PREDICT_EEPROM_ADDRESS, saved);
+
+  if (saved.magic != PREDICT_MAGIC) {
+    DEBUG_PRINTLN("Storage: No predictor model in EEPROM - starting fresh");
+    return false;
+  }
+
+  uint32_t expectedCrc = calculateCrc32((uint8_t*)&saved, offsetof(PredictorData, crc));
+  if (saved.crc != expectedCrc) {
+    DEBUG_PRINTLN("Storage: Predictor model CRC mismatch - starting fresh");
+    return false;
+  }
+
+  predictor->restore(&saved);
+  DEBUG_PRINT("Storage: Predictor model loaded (");
+  DEBUG_PRINT(saved.globalCount);
+  DEBUG_PRINTLN(" intervals)");
+  return true;
+}
+
+void Storage::setConfig(RuntimeConfig* config) {
+  this->config = config;
+}
+
+bool Storage::loadConfig() {
+  if (config == nullptr) {
+    return false;
+  }
+
+  // Check the header and CRC in the EEPROM cache; RuntimeConfig copies and validates the settings
+  const uint8_t* block = EEPROM.getConstDataPtr() + CONFIG_EEPROM_ADDRESS;
+  ConfigHeader header;
+  memcpy(&header, block, sizeof(header));
+
+  if (header.magic != CONFIG_MAGIC || header.length > CONFIG_MAX_LENGTH) {
+    DEBUG_PRINTLN(F("Storage: No settings in EEPROM - using config.h defaults"));
+    return false;
+  }
+
+  const uint8_t* settings = block + sizeof(ConfigHeader);
+  if (header.crc != calculateCrc32(settings, header.length)) {
+    DEBUG_PRINTLN(F("Storage: Settings CRC mismatch - using config.h defaults"));
+    return false;
+  }
+
+  if (!config->restore(&header, settings)) {
+    DEBUG_PRINTLN(F("Storage: Settings out of range - using config.h defaults"));
+    return false;
+  }
+  DEBUG_PRINT(F("Storage: Settings loaded (version "));
+  DEBUG_PRINT(header.version);
+  DEBUG_PRINTLN(F(")"));
+  return true;
+}
+
+uint8_t Storage::getDirtyFields() {
+  // Nothing known about flash contents yet - everything is dirty
+  if (!committedValid) {
+    uint8_t fields = STORAGE_FIELD_OUTSIDE | STORAGE_FIELD_PEE | STORAGE_FIELD_POOP;
+    if (stats != nullptr) fields |= STORAGE_FIELD_STATS;
+    if (predictor != nullptr) fields |= STORAGE_FIELD_PREDICT;
+    // Settings only once changed, so unchanged defaults keep following config.h
+    if (config != nullptr && config->isDirty()) fields |= STORAGE_FIELD_CONFIG;
+    return fields;
+  }
+
+  uint8_t fields = 0;
+  if (data.outsideTimestamp != committedData.outsideTimestamp) fields |= STORAGE_FIELD_OUTSIDE;
+  if (data.peeTimestamp != committedData.peeTimestamp) fields |= STORAGE_FIELD_PEE;
+  if (data.poopTimestamp != committedData.poopTimestamp) fields |= STORAGE_FIELD_POOP;
+  if (stats != nullptr && stats->isDirty()) fields |= STORAGE_FIELD_STATS;
+  if (predictor != nullptr && predictor->isDirty()) fields |= STORAGE_FIELD_PREDICT;
+  if (config != nullptr && config->isDirty()) fields |= STORAGE_FIELD_CONFIG;
+  return fields;
+}
+
+long Storage::getDayNumber() {
+  time_t now = time(nullptr);
+
+  // Fall back to uptime days until time is synced
+  if (now < 1000000000) {
+    return (long)(millis() / 86400000UL);
+  }
+
+  struct tm* timeinfo = localtime(&now);
+  return (long)(timeinfo->tm_year) * 366 + timeinfo->tm_yday;
+}
+
 uint8_t Storage::calculateChecksum(PersistentData* data) {
   uint8_t checksum = 0;
   uint8_t* bytes = (uint8_t*)data;
@@ -112,3 +380,87 @@ uint8_t Storage::calculateChecksum(PersistentData* data) {
 
   return checksum;
 }
+
+void Storage::saveHotState(RtcState* state) {
+  state->magic = RTC_STATE_MAGIC;
+
+  // Called every loop iteration: compare before spending a CRC, and write only real changes.
+  // The digest countdown is left out - it ticks every second, and a stale value after a
+  // reset only sends the pending digest a little later
+  const uint8_t* bytes = (const uint8_t*)state;
+  const uint8_t* last = (const uint8_t*)&lastHotState;
+  size_t afterDelay = offsetof(RtcState, pendingDelay) + sizeof(state->pendingDelay);
+  if (memcmp(bytes, last, offsetof(RtcState, pendingDelay)) == 0 &&
+      memcmp(bytes + afterDelay, last + afterDelay, offsetof(RtcState, crc) - afterDelay) == 0) {
+    return;
+  }
+
+  state->crc = calculateCrc32((uint8_t*)state, offsetof(RtcState, crc));
+
+  if (ESP.rtcUserMemoryWrite(RTC_STATE_OFFSET, (uint32_t*)state, sizeof(RtcState))) {
+    memcpy(&lastHotState, state, sizeof(RtcState));
+  } else {
+    DEBUG_PRINTLN("Storage: RTC memory write failed");
+  }
+}
+
+bool Storage::loadHotState(RtcState* state) {
+  if (!isWarmReset()) {
+    DEBUG_PRINTLN("Storage: Power-up reset - RTC memory not valid");
+    return false;
+  }
+
+  if (!ESP.rtcUserMemoryRead(RTC_STATE_OFFSET, (uint32_t*)state, sizeof(RtcState))) {
+    DEBUG_PRINTLN("Storage: RTC memory read failed");
+    return false;
+  }
+
+  if (state->magic != RTC_STATE_MAGIC) {
+    DEBUG_PRINTLN("Storage: No hot state in RTC memory");
+    return false;
+  }
+
+  uint32_t expectedCrc = calculateCrc32((uint8_t*)state, offsetof(RtcState, crc));
+  if (state->crc != expectedCrc) {
+    DEBUG_PRINTLN("Storage: RTC state CRC mismatch - ignoring");
+    return false;
+  }
+
+  memcpy(&lastHotState, state, sizeof(RtcState));
+
+  // RTC may be ahead of flash (presses not flushed before the reset), so compare the
+  // first flush with the actual flash record instead of rewriting every field
+  readCommitted();
+
+  DEBUG_PRINTLN("Storage: Hot state loaded from RTC memory");
+  DEBUG_PRINT("  Outside: ");
+  DEBUG_PRINTLN(state->outsideTimestamp);
+  DEBUG_PRINT("  Pee: ");
+  DEBUG_PRINTLN(state->peeTimestamp);
+  DEBUG_PRINT("  Poop: ");
+  DEBUG_PRINTLN(state->poopTimestamp);
+
+  return true;
+}
+
+bool Storage::isWarmReset() {
+  // RTC user memory is only cleared by a power-up (REASON_DEFAULT_RST)
+  rst_info* resetInfo = ESP.getResetInfoPtr();
+  DEBUG_PRINT("Storage: Reset reason: ");
+  DEBUG_PRINTLN(resetInfo->reason);
+  return resetInfo->reason != REASON_DEFAULT_RST;
+}
+
+uint32_t Storage::calculateCrc32(const uint8_t* bytes, size_t length) {
+  // Standard CRC-32 (reflected, polynomial 0xEDB88320), bitwise to save flash
+  uint32_t crc = 0xFFFFFFFF;
+
+  for (size_t i = 0; i < length; i++) {
+    crc ^= bytes[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+
+  return ~crc;
+}
@@ -6,6 +6,11 @@
 #include <time.h>
 #include "config.h"
 #include "TimerManager.h"
+#include "PottyStats.h"
+#include "PeePredictor.h"
+#include "RuntimeConfig.h"
+#include "NotificationDigest.h"
+#include "MqttManager.h"
 
 // Data structure for EEPROM storage
 // Use packed attribute to prevent compiler padding
@@ -17,6 +22,48 @@ struct __attribute__((packed)) PersistentData {
   uint8_t checksum;            // Data integrity check (MUST be last byte)
 };
 
+// PersistentData fields tracked by the write-back cache
+#define STORAGE_FIELD_OUTSIDE 0x01
+#define STORAGE_FIELD_PEE     0x02
+#define STORAGE_FIELD_POOP    0x04
+#define STORAGE_FIELD_STATS   0x08  // StatsData block (STATS_EEPROM_ADDRESS)
+#define STORAGE_FIELD_PREDICT 0x10  // PredictorData block (PREDICT_EEPROM_ADDRESS)
+#define STORAGE_FIELD_CONFIG  0x20  // ConfigData block (CONFIG_EEPROM_ADDRESS)
+
+static_assert(EEPROM_ADDRESS + sizeof(PersistentData) <= CONFIG_EEPROM_ADDRESS, "ConfigData overlaps PersistentData");
+static_assert(CONFIG_EEPROM_ADDRESS + sizeof(ConfigData) <= STATS_EEPROM_ADDRESS, "StatsData overlaps ConfigData");
+static_assert(STATS_EEPROM_ADDRESS + sizeof(StatsData) <= PREDICT_EEPROM_ADDRESS, "PredictorData overlaps StatsData");
+static_assert(PREDICT_EEPROM_ADDRESS + sizeof(PredictorData) <= EEPROM_SIZE, "PredictorData does not fit in EEPROM");
+
+// Hot state kept in RTC user memory, restored instantly after a warm reset
+// (watchdog, exception, software restart). Lost on power-up, where EEPROM is used.
+// RTC memory is accessed in 4-byte blocks, so every field is 32-bit aligned.
+struct RtcState {
+  uint32_t magic;                   // RTC_STATE_MAGIC when written by this firmware
+  uint32_t outsideTimestamp;        // Unix epoch time
+  uint32_t peeTimestamp;
+  uint32_t poopTimestamp;
+  uint32_t yellowNotificationAge;   // Seconds since last yellow alert was sent
+  uint32_t redNotificationAge;      // Seconds since last red alert was sent
+  uint32_t updateOffsets[TELEGRAM_MAX_BOTS];  // Telegram update_id offset for each bot
+  uint32_t pendingDelay;            // Milliseconds left before the notification digest is sent
+  uint32_t flags;                   // RTC_FLAG_* bits
+  NotifySnapshot notifications;     // Button presses not delivered to every recipient yet
+  uint32_t mqttEventCount;          // Entries of mqttEvents in use
+  MqttOutboxEntry mqttEvents[MQTT_OUTBOX_SIZE];  // Timer events not yet published to the broker (oldest first)
+  uint32_t crc;                     // CRC32 of all preceding bytes (MUST be last)
+};
+
+// RtcState flag bits
+#define RTC_FLAG_YELLOW_LED_WAS_ON   0x01
+#define RTC_FLAG_RED_LED_WAS_ON      0x02
+#define RTC_FLAG_YELLOW_NOTIFIED     0x04  // yellowNotificationAge is valid
+#define RTC_FLAG_RED_NOTIFIED        0x08  // redNotificationAge is valid
+#define RTC_FLAG_PENDING_MESSAGE     0x10  // notifications holds undelivered presses
+
+static_assert(sizeof(RtcState) % 4 == 0, "RtcState must be a whole number of RTC blocks");
+static_assert(RTC_STATE_OFFSET * 4 + sizeof(RtcState) <= 512, "RtcState does not fit in RTC user memory");
+
 class Storage {
 public:
   Storage();
@@ -24,8 +71,26 @@ public:
   // Initialize EEPROM
   void begin();
 
-  // Save timer data to EEPROM
-  void save(TimerManager* timerManager);
+  // Save timer data to EEPROM immediately (skipped if nothing changed)
+  // Returns true if a flash commit was made
+  bool save(TimerManager* timerManager);
+
+  // Mark timer data as changed; saved once the coalescing window has passed
+  void markDirty();
+
+  // Flush pending changes when due or on low voltage (call every loop iteration)
+  void update(TimerManager* timerManager);
+
+  // Flush pending changes now (call before an intentional reset)
+  void flush(TimerManager* timerManager);
+
+  // Check if there are changes waiting to be committed
+  bool isDirty();
+
+  // Write statistics (for telemetry)
+  unsigned long getCommitCount();
+  unsigned long getSkippedCommitCount();
+  unsigned long getCommitsToday();
 
   // Load timer data from EEPROM
   bool load(TimerManager* timerManager);
@@ -33,11 +98,66 @@ public:
   // Check if EEPROM data is valid
   bool isValid();
 
+  // Attach statistics, committed together with the timers whenever they change
+  void setStats(PottyStats* stats);
+
+  // Load statistics from EEPROM (false if missing or corrupted)
+  bool loadStats();
+
+  // Attach the next-pee predictor, committed together with the timers whenever it learns
+  void setPredictor(PeePredictor* predictor);
+
+  // Load the learned predictor model from EEPROM (false if missing or corrupted)
+  bool loadPredictor();
+
+  // Attach the runtime configuration, committed together with the timers when changed
+  void setConfig(RuntimeConfig* config);
+
+  // Load the configuration block from EEPROM (false if missing, corrupted or out of range - defaults apply)
+  bool loadConfig();
+
+  // Save hot state to RTC memory (skipped if unchanged since last write)
+  void saveHotState(RtcState* state);
+
+  // Load hot state from RTC memory (false after power-up or if corrupted)
+  // The timers then come from RTC, but flush() still compares against what flash holds
+  bool loadHotState(RtcState* state);
+
+  // Check if the last reset kept RTC memory (anything but a power-up)
+  bool isWarmReset();
+
 private:
+  // Note what flash holds without restoring it (false if the record is corrupted)
+  bool readCommitted();
+
   PersistentData data;
+  PersistentData committedData;  // Copy of what is currently in flash
+  bool committedValid;
+  bool dirty;
+  unsigned long dirtySince;
+  PottyStats* stats;
+  PeePredictor* predictor;
+  RuntimeConfig* config;
+  unsigned long lastVccCheck;
+
+  // Write statistics
+  unsigned long commitCount;
+  unsigned long skippedCommitCount;
+  unsigned long commitsToday;
+  long commitDay;
+  RtcState lastHotState;  // Copy of what is currently in RTC memory
 
   // Calculate checksum for data integrity
   uint8_t calculateChecksum(PersistentData* data);
+
+  // Get bitmask of fields that differ from what is in flash (STORAGE_FIELD_*)
+  uint8_t getDirtyFields();
+
+  // Get current day number for the per-day commit counter
+  long getDayNumber();
+
+  // Calculate CRC32 for RTC state integrity
+  uint32_t calculateCrc32(const uint8_t* bytes, size_t length);
 };
 
 #endif
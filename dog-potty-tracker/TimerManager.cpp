@@ -1,6 +1,9 @@
 #include "TimerManager.h"
 
-TimerManager::TimerManager() {
+TimerManager::TimerManager() :
+  revision(0),
+  changeCallback(nullptr)
+{
   // Initialize all timers to current time
   time_t now = time(nullptr);
   outsideStart = now;
@@ -10,6 +13,7 @@ TimerManager::TimerManager() {
 
 void TimerManager::reset(Timer timer) {
   time_t now = time(nullptr);
+  time_t previous = getTimestamp(timer);
   switch (timer) {
     case TIMER_OUTSIDE:
       outsideStart = now;
@@ -21,6 +25,7 @@ void TimerManager::reset(Timer timer) {
       poopStart = now;
       break;
   }
+  notifyChange(timer, previous, now);
 }
 
 void TimerManager::resetOutside() {
@@ -122,6 +127,7 @@ time_t TimerManager::getTimestamp(Timer timer) {
 }
 
 void TimerManager::setTimestamp(Timer timer, time_t timestamp) {
+  time_t previous = getTimestamp(timer);
   switch (timer) {
     case TIMER_OUTSIDE:
       outsideStart = timestamp;
@@ -133,9 +139,25 @@ void TimerManager::setTimestamp(Timer timer, time_t timestamp) {
       poopStart = timestamp;
       break;
   }
+  notifyChange(timer, previous, timestamp);
 }
 
 bool TimerManager::isTimeSynced() {
   time_t now = time(nullptr);
   return now > 1000000000;  // Valid time (after year 2001)
 }
+
+void TimerManager::setChangeCallback(TimerChangeCallback callback) {
+  changeCallback = callback;
+}
+
+unsigned long TimerManager::getRevision() {
+  return revision;
+}
+
+void TimerManager::notifyChange(Timer timer, time_t previous, time_t current) {
+  revision++;
+  if (changeCallback != nullptr) {
+    changeCallback(timer, previous, current);
+  }
+}
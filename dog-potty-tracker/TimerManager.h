@@ -10,6 +10,9 @@ enum Timer {
   TIMER_POOP = 2
 };
 
+// Callback type for timer changes (previous and new start timestamp)
+typedef void (*TimerChangeCallback)(Timer timer, time_t previous, time_t current);
+
 class TimerManager {
 public:
   TimerManager();
@@ -40,10 +43,21 @@ public:
   // Check if time is synced
   bool isTimeSynced();
 
+  // Set callback invoked whenever a timer is reset or set
+  void setChangeCallback(TimerChangeCallback callback);
+
+  // Get revision counter (incremented on every timer change)
+  unsigned long getRevision();
+
 private:
   time_t outsideStart;
   time_t peeStart;
   time_t poopStart;
+  unsigned long revision;
+  TimerChangeCallback changeCallback;
+
+  // Record a change and notify the callback
+  void notifyChange(Timer timer, time_t previous, time_t current);
 
   // Helper function to format elapsed time
   String formatElapsed(unsigned long seconds);
@@ -0,0 +1,208 @@
+#include "VoiceMonkeyQueue.h"
+#include "WiFiManager.h"
+#include "HttpRequestWriter.h"
+
+static const char* const DEVICE_LABELS[VM_DEVICE_COUNT] = {"startup", "yellow", "red"};
+
+VoiceMonkeyQueue::VoiceMonkeyQueue() :
+  token(""),
+  queueHead(0),
+  queueCount(0),
+  failures(0),
+  retryAt(0),
+  awaitingResponse(false),
+  requestSentAt(0),
+  lastUse(0)
+{
+  for (int i = 0; i < VM_DEVICE_COUNT; i++) {
+    devices[i][0] = '\0';
+    lastTriggered[i] = 0;
+  }
+}
+
+void VoiceMonkeyQueue::begin(const char* token, const char* startup, const char* yellow, const char* red) {
+  this->token = token != nullptr ? token : "";
+
+  // Voice Monkey device names are lowercase - convert once instead of per request
+  const char* names[VM_DEVICE_COUNT] = {startup, yellow, red};
+  for (int i = 0; i < VM_DEVICE_COUNT; i++) {
+    size_t length = 0;
+    if (names[i] != nullptr) {
+      for (; names[i][length] != '\0' && length < VOICE_MONKEY_DEVICE_SIZE - 1; length++) {
+        devices[i][length] = tolower(names[i][length]);
+      }
+    }
+    devices[i][length] = '\0';
+  }
+
+  client.setInsecure();  // Skip certificate validation
+  client.setSession(&session);
+  client.setTimeout(2000);  // Only read once the response has started arriving
+}
+
+bool VoiceMonkeyQueue::isConfigured(VoiceMonkeyDevice device) {
+  return token[0] != '\0' && devices[device][0] != '\0';
+}
+
+bool VoiceMonkeyQueue::trigger(VoiceMonkeyDevice device) {
+  if (!isConfigured(device)) {
+    return false;
+  }
+
+  // The same announcement twice in a row adds nothing
+  if (lastTriggered[device] != 0 && millis() - lastTriggered[device] < VOICE_MONKEY_DEDUP_WINDOW) {
+    DEBUG_PRINT("VoiceMonkeyQueue: Suppressed repeat ");
+    DEBUG_PRINT(DEVICE_LABELS[device]);
+    DEBUG_PRINTLN(" trigger");
+    return false;
+  }
+  for (int i = 0; i < queueCount; i++) {
+    if (queue[(queueHead + i) % VOICE_MONKEY_QUEUE_SIZE] == device) {
+      DEBUG_PRINT(F("VoiceMonkeyQueue: Already queued "));
+      DEBUG_PRINTLN(DEVICE_LABELS[device]);
+      return false;
+    }
+  }
+
+  if (queueCount == VOICE_MONKEY_QUEUE_SIZE) {
+    DEBUG_PRINTLN("VoiceMonkeyQueue: Queue full - trigger dropped");
+    return false;
+  }
+
+  queue[(queueHead + queueCount) % VOICE_MONKEY_QUEUE_SIZE] = device;
+  queueCount++;
+  lastTriggered[device] = millis();
+  if (lastTriggered[device] == 0) lastTriggered[device] = 1;
+
+  DEBUG_PRINT("VoiceMonkeyQueue: Queued ");
+  DEBUG_PRINT(DEVICE_LABELS[device]);
+  DEBUG_PRINT(" trigger (device ");
+  DEBUG_PRINT(devices[device]);
+  DEBUG_PRINTLN(")");
+  return true;
+}
+
+bool VoiceMonkeyQueue::update(bool connected) {
+  if (awaitingResponse) {
+    // Response has started arriving - the rest follows within milliseconds
+    if (client.available() > 0) {
+      bool keepAlive;
+      int status = WiFiManager::readResponse(client, nullptr, 0, &keepAlive);
+      awaitingResponse = false;
+      lastUse = millis();
+      if (!keepAlive) {
+        client.stop();
+      }
+
+      if (status >= 200 && status < 300) {
+        DEBUG_PRINT("VoiceMonkeyQueue: Triggered ");
+        DEBUG_PRINTLN(DEVICE_LABELS[queue[queueHead]]);
+        pop();
+        return true;
+      }
+
+      DEBUG_PRINT("VoiceMonkeyQueue: Trigger failed (HTTP ");
+      DEBUG_PRINT(status);
+      DEBUG_PRINTLN(")");
+      if (status >= 400 && status < 500) {
+        // Wrong token or device name - retrying will not help
+        pop();
+      } else {
+        fail();
+      }
+      return false;
+    }
+
+    if (!client.connected() || millis() - requestSentAt >= VOICE_MONKEY_TIMEOUT) {
+      DEBUG_PRINTLN("VoiceMonkeyQueue: No response");
+      client.stop();
+      awaitingResponse = false;
+      fail();
+    }
+    return false;
+  }
+
+  // Free the TLS buffers between bursts (the cached session keeps the next connect cheap)
+  if (client.connected() && millis() - lastUse >= VOICE_MONKEY_KEEPALIVE_IDLE) {
+    DEBUG_PRINTLN("VoiceMonkeyQueue: Closing idle connection");
+    client.stop();
+  }
+
+  if (queueCount == 0 || !connected) {
+    return false;
+  }
+  if (retryAt != 0 && (long)(millis() - retryAt) < 0) {
+    return false;
+  }
+
+  // Wait while another TLS connection (e.g. Telegram) holds the heap a handshake needs
+  if (!client.connected() && ESP.getMaxFreeBlockSize() < VOICE_MONKEY_MIN_HEAP) {
+    return false;
+  }
+
+  if (!sendHead()) {
+    fail();
+  }
+  return false;
+}
+
+bool VoiceMonkeyQueue::hasPending() {
+  return queueCount > 0;
+}
+
+bool VoiceMonkeyQueue::open() {
+  if (client.connected()) {
+    return true;
+  }
+
+  // Blocks, but each step (TCP connect, TLS handshake reads) is bounded by the client timeout
+  if (!client.connect(VOICE_MONKEY_HOST, 443)) {
+    DEBUG_PRINTLN("VoiceMonkeyQueue: Failed to connect");
+    client.stop();
+    return false;
+  }
+  return true;
+}
+
+bool VoiceMonkeyQueue::sendHead() {
+  if (!open()) {
+    return false;
+  }
+
+  // GET /trigger?token=<token>&device=<device>
+  HttpRequestWriter<WiFiClientSecure> request(client);
+  request.begin(PSTR("GET"), PSTR("/trigger"));
+  request.addQuery(PSTR("token"), token);
+  request.addQuery(PSTR("device"), devices[queue[queueHead]]);
+  if (!request.end(VOICE_MONKEY_HOST, true)) {
+    DEBUG_PRINTLN("VoiceMonkeyQueue: Failed to send request");
+    client.stop();
+    return false;
+  }
+
+  awaitingResponse = true;
+  requestSentAt = millis();
+  lastUse = requestSentAt;
+  return true;
+}
+
+void VoiceMonkeyQueue::fail() {
+  failures++;
+  if (failures >= VOICE_MONKEY_MAX_ATTEMPTS) {
+    DEBUG_PRINT("VoiceMonkeyQueue: Giving up on ");
+    DEBUG_PRINT(DEVICE_LABELS[queue[queueHead]]);
+    DEBUG_PRINTLN(" trigger");
+    pop();
+    return;
+  }
+
+  retryAt = millis() + ((unsigned long)VOICE_MONKEY_RETRY_INTERVAL << (failures - 1));
+  if (retryAt == 0) retryAt = 1;
+}
+
+void VoiceMonkeyQueue::pop() {
+  queueHead = (queueHead + 1) % VOICE_MONKEY_QUEUE_SIZE;
+  queueCount--;
+  failures = 0;
+  retryAt = 0;
+}
@@ -0,0 +1,75 @@
+#ifndef VOICE_MONKEY_QUEUE_H
+#define VOICE_MONKEY_QUEUE_H
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+#include "config.h"
+
+#define VOICE_MONKEY_HOST "api-v2.voicemonkey.io"
+
+// Alexa routines triggered through Voice Monkey
+enum VoiceMonkeyDevice {
+  VM_DEVICE_STARTUP,
+  VM_DEVICE_YELLOW,
+  VM_DEVICE_RED,
+  VM_DEVICE_COUNT
+};
+
+// Sends Voice Monkey triggers from the main loop instead of inline with the alerts.
+// One request is in flight at a time: the request is written in one loop iteration and
+// the response is read in a later one once it has arrived, so the loop does not wait for
+// Voice Monkey to answer. Opening a connection does block (each step bounded by the 2 s
+// client timeout), but it is kept alive between triggers and the TLS session is cached,
+// so a reconnect after the idle close skips the full handshake.
+class VoiceMonkeyQueue {
+public:
+  VoiceMonkeyQueue();
+
+  // Set token and device names (names are lowercased here once, empty = not used)
+  void begin(const char* token, const char* startup, const char* yellow, const char* red);
+
+  // Check if a device is configured
+  bool isConfigured(VoiceMonkeyDevice device);
+
+  // Queue a trigger
+  // Returns false if the device is not configured, already queued, recently triggered or the queue is full
+  bool trigger(VoiceMonkeyDevice device);
+
+  // Send the next trigger or collect its response (call every loop iteration)
+  // Returns true when a trigger was accepted by Voice Monkey
+  bool update(bool connected);
+
+  // Check if any trigger is queued or in flight
+  bool hasPending();
+
+private:
+  const char* token;
+  char devices[VM_DEVICE_COUNT][VOICE_MONKEY_DEVICE_SIZE];
+  unsigned long lastTriggered[VM_DEVICE_COUNT];  // When each device was last queued (0 = never)
+
+  uint8_t queue[VOICE_MONKEY_QUEUE_SIZE];
+  uint8_t queueHead;
+  uint8_t queueCount;
+  uint8_t failures;              // Consecutive failures of the trigger at the head
+  unsigned long retryAt;         // No send before this (0 = now)
+
+  WiFiClientSecure client;
+  BearSSL::Session session;      // Resumed on reconnect (abbreviated handshake)
+  bool awaitingResponse;
+  unsigned long requestSentAt;
+  unsigned long lastUse;
+
+  // Connect unless the kept-alive connection is still open
+  bool open();
+
+  // Write the request for the trigger at the head of the queue
+  bool sendHead();
+
+  // Count a failed attempt and schedule the retry (or drop the trigger)
+  void fail();
+
+  // Remove the trigger at the head of the queue
+  void pop();
+};
+
+#endif
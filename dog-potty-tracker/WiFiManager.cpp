@@ -1,4 +1,5 @@
 #include "WiFiManager.h"
+#include <limits.h>
 
 WiFiManager::WiFiManager() :
   timeSynced(false),
@@ -9,21 +10,26 @@ WiFiManager::WiFiManager() :
   lastTelegramCheck(0),
   telegramCheckInterval(30000),  // Check every 30 seconds (replies disabled, low priority)
   replyPending(false),
-  replyPendingSince(0)
+  replyPendingSince(0),
+  telegramLastUse(0)
 {
-  updateOffsets[0] = 0;
-  updateOffsets[1] = 0;
-  updateOffsets[2] = 0;
+  for (int i = 0; i < TELEGRAM_MAX_BOTS; i++) {
+    updateOffsets[i] = 0;
+  }
 }
 
 void WiFiManager::begin(const char* ssid, const char* password) {
   wifiSsid = ssid;
   wifiPassword = password;
 
-  DEBUG_PRINTLN("WiFiManager: Starting connection...");
-  DEBUG_PRINT("SSID: ");
+  DEBUG_PRINTLN(F("WiFiManager: Starting connection..."));
+  DEBUG_PRINT(F("SSID: "));
   DEBUG_PRINTLN(ssid);
 
+  // Shared Telegram connection (reused while requests follow each other closely)
+  telegramClient.setInsecure();  // Skip certificate validation
+  telegramClient.setTimeout(10000);
+
   // Set WiFi mode
   WiFi.mode(WIFI_STA);
 
@@ -37,8 +43,8 @@ void WiFiManager::update() {
   if (WiFi.status() == WL_CONNECTED) {
     // If we just connected
     if (reconnectAttemptCount > 0 || connecting) {
-      DEBUG_PRINTLN("WiFiManager: Connected!");
-      DEBUG_PRINT("IP address: ");
+      DEBUG_PRINTLN(F("WiFiManager: Connected!"));
+      DEBUG_PRINT(F("IP address: "));
       DEBUG_PRINTLN(WiFi.localIP());
 
       reconnectAttemptCount = 0;
@@ -52,9 +58,12 @@ void WiFiManager::update() {
     if (!timeSynced) {
       if (checkTimeSync()) {
         timeSynced = true;
-        DEBUG_PRINTLN("WiFiManager: Time synced!");
+        DEBUG_PRINTLN(F("WiFiManager: Time synced!"));
       }
     }
+
+    // Free the TLS buffers once a burst of Telegram requests is over
+    closeIdleTelegram();
   }
   // Not connected - attempt reconnection
   else {
@@ -66,7 +75,7 @@ void WiFiManager::update() {
 }
 
 void WiFiManager::attemptReconnect() {
-  DEBUG_PRINTLN("WiFiManager: Attempting reconnection...");
+  DEBUG_PRINTLN(F("WiFiManager: Attempting reconnection..."));
 
   WiFi.disconnect();
   WiFi.begin(wifiSsid, wifiPassword);
@@ -80,9 +89,9 @@ void WiFiManager::updateReconnectBackoff() {
   unsigned long backoffTime = min((unsigned long)pow(2, reconnectAttemptCount) * 1000, (unsigned long)WIFI_RECONNECT_MAX_BACKOFF);
   nextReconnectAttempt = millis() + backoffTime;
 
-  DEBUG_PRINT("WiFiManager: Next attempt in ");
+  DEBUG_PRINT(F("WiFiManager: Next attempt in "));
   DEBUG_PRINT(backoffTime / 1000);
-  DEBUG_PRINTLN(" seconds");
+  DEBUG_PRINTLN(F(" seconds"));
 }
 
 bool WiFiManager::isConnected() {
@@ -94,7 +103,7 @@ bool WiFiManager::isTimeSynced() {
 }
 
 void WiFiManager::syncTime() {
-  DEBUG_PRINTLN("WiFiManager: Syncing time with NTP...");
+  DEBUG_PRINTLN(F("WiFiManager: Syncing time with NTP..."));
 
   // First sync time without DST to get accurate current time
   configTime(TIMEZONE_OFFSET * 3600, 0, NTP_SERVER1, NTP_SERVER2);
@@ -109,7 +118,7 @@ void WiFiManager::syncTime() {
   // Now calculate DST offset based on synced time
   int dstOffset = calculateDSTOffset();
 
-  DEBUG_PRINT("WiFiManager: DST offset = ");
+  DEBUG_PRINT(F("WiFiManager: DST offset = "));
   DEBUG_PRINTLN(dstOffset);
 
   // Reconfigure time with correct DST offset
@@ -122,80 +131,194 @@ bool WiFiManager::checkTimeSync() {
   return now > 1000000000;
 }
 
-bool WiFiManager::sendTelegramNotification(const char* botToken, const char* chatID, const char* message) {
+int WiFiManager::sendTelegramNotification(const char* botToken, const char* chatID, const char* message) {
   // Check if we're connected to WiFi
   if (!isConnected()) {
-    DEBUG_PRINTLN("WiFiManager: Cannot send Telegram notification - not connected to WiFi");
-    return false;
+    DEBUG_PRINTLN(F("WiFiManager: Cannot send Telegram notification - not connected to WiFi"));
+    return HTTP_ERROR_CONNECT;
   }
 
   // Check if bot token and chat ID are configured
   if (botToken == nullptr || strlen(botToken) == 0 || chatID == nullptr || strlen(chatID) == 0) {
-    DEBUG_PRINTLN("WiFiManager: Telegram bot token or chat ID not configured");
-    return false;
+    DEBUG_PRINTLN(F("WiFiManager: Telegram bot token or chat ID not configured"));
+    return HTTP_ERROR_CONNECT;
   }
 
-  // Build Telegram API URL
-  String url = "https://api.telegram.org/bot";
-  url += botToken;
-  url += "/sendMessage?chat_id=";
-  url += chatID;
-  url += "&text=";
-  url += urlencode(message);
-
-  DEBUG_PRINTLN("WiFiManager: Sending Telegram notification...");
-  DEBUG_PRINT("WiFiManager: Message length: ");
+  DEBUG_PRINTLN(F("WiFiManager: Sending Telegram notification..."));
+  DEBUG_PRINT(F("WiFiManager: Message length: "));
   DEBUG_PRINTLN(strlen(message));
-  DEBUG_PRINT("WiFiManager: URL length: ");
-  DEBUG_PRINTLN(url.length());
-  DEBUG_PRINT("WiFiManager: Free heap before: ");
-  DEBUG_PRINTLN(ESP.getFreeHeap());
 
-  // Single attempt with long delay to allow SSL stack to recover
-  DEBUG_PRINTLN("WiFiManager: Waiting 5 seconds for SSL stack to clear...");
-  delay(5000);
+  if (!openTelegram()) {
+    return HTTP_ERROR_CONNECT;
+  }
+
+  // GET /bot<token>/sendMessage?chat_id=<id>&text=<message>
+  HttpRequestWriter<WiFiClientSecure> request(telegramClient);
+  request.begin(PSTR("GET"), PSTR("/bot"));
+  request.addPath(botToken);
+  request.addPath_P(PSTR("/sendMessage"));
+  request.addQuery(PSTR("chat_id"), chatID);
+  request.addQuery(PSTR("text"), message);
+
+  // Only a 2xx means Telegram took the message - the caller decides whether an error
+  // is worth retrying (429, 5xx) or permanent (other 4xx, e.g. a blocked bot)
+  int httpResponseCode = finishTelegramRequest(request, nullptr);
+  if (HTTP_IS_SUCCESS(httpResponseCode)) {
+    DEBUG_PRINT(F("WiFiManager: Telegram notification sent successfully (HTTP "));
+    DEBUG_PRINT(httpResponseCode);
+    DEBUG_PRINTLN(F(")"));
+  } else {
+    DEBUG_PRINT(F("WiFiManager: Telegram notification failed (Error: "));
+    DEBUG_PRINT(httpResponseCode);
+    DEBUG_PRINTLN(F(")"));
+  }
+  return httpResponseCode;
+}
 
-  DEBUG_PRINT("WiFiManager: Free heap after delay: ");
+bool WiFiManager::openTelegram() {
+  if (telegramClient.connected()) {
+    DEBUG_PRINTLN(F("WiFiManager: Reusing Telegram connection"));
+    return true;
+  }
+
+  // A new TLS handshake needs most of the heap - give the SSL stack time to recover first
+  DEBUG_PRINT(F("WiFiManager: Free heap before: "));
+  DEBUG_PRINTLN(ESP.getFreeHeap());
+  DEBUG_PRINTLN(F("WiFiManager: Waiting 5 seconds for SSL stack to clear..."));
+  delay(5000);
+  DEBUG_PRINT(F("WiFiManager: Free heap after delay: "));
   DEBUG_PRINTLN(ESP.getFreeHeap());
 
-  for (int attempt = 1; attempt <= 1; attempt++) {  // Only 1 attempt
+  if (!telegramClient.connect(TELEGRAM_HOST, 443)) {
+    DEBUG_PRINTLN(F("WiFiManager: Failed to connect to Telegram"));
+    telegramClient.stop();
+    return false;
+  }
+  return true;
+}
+
+int WiFiManager::finishTelegramRequest(HttpRequestWriter<WiFiClientSecure>& request, String* body) {
+  int httpResponseCode = HTTP_ERROR_WRITE;
+  bool keepAlive = false;
+  if (request.end(TELEGRAM_HOST, true)) {
+    httpResponseCode = readResponse(telegramClient, body, TELEGRAM_MAX_RESPONSE, &keepAlive);
+  }
+
+  // Keep the connection for the next request unless the server or an error ended it
+  if (!keepAlive) {
+    telegramClient.stop();
+  }
+  telegramLastUse = millis();
+  return httpResponseCode;
+}
 
-    // Create fresh client for each attempt
-    WiFiClientSecure client;
-    client.setInsecure();
-    client.setTimeout(10000);
+int WiFiManager::readResponse(WiFiClient& client, String* body, size_t maxBody, bool* keepAlive) {
+  char line[128];
+  *keepAlive = false;
 
-    HTTPClient http;
-    http.setTimeout(10000);
-    http.setReuse(false);
+  // Status line: "HTTP/1.1 200 OK"
+  int status = 0;
+  if (!readLine(client, line, sizeof(line))) {
+    return HTTP_ERROR_TIMEOUT;
+  }
+  const char* code = strchr(line, ' ');
+  if (!flashStartsWith(line, PSTR("HTTP/")) || code == nullptr || (status = atoi(code + 1)) <= 0) {
+    return HTTP_ERROR_PROTOCOL;
+  }
 
-    if (!http.begin(client, url)) {
-      DEBUG_PRINTLN("WiFiManager: Failed to begin HTTP connection");
-      client.stop();
-      continue;  // Try again
+  long contentLength = -1;
+  bool chunked = false;
+  bool close = false;
+  while (true) {
+    if (!readLine(client, line, sizeof(line))) {
+      return HTTP_ERROR_TIMEOUT;
     }
+    if (line[0] == '\0') {
+      break;
+    }
+    if (strncasecmp_P(line, PSTR("Content-Length:"), 15) == 0) {
+      contentLength = atol(line + 15);
+    } else if (strncasecmp_P(line, PSTR("Transfer-Encoding:"), 18) == 0) {
+      chunked = strstr_P(line + 18, PSTR("chunked")) != nullptr;
+    } else if (strncasecmp_P(line, PSTR("Connection:"), 11) == 0) {
+      close = strstr_P(line + 11, PSTR("close")) != nullptr;
+    }
+  }
 
-    int httpResponseCode = http.GET();
-    http.end();
-    client.stop();
+  // Body: kept up to maxBody bytes, the rest is read and dropped so the connection stays usable
+  if (body != nullptr) {
+    *body = String();
+    body->reserve(contentLength > 0 ? min((size_t)contentLength, maxBody) : 0);
+  }
+  char buffer[64];
+  while (true) {
+    long remaining = contentLength;
+    if (chunked) {
+      if (!readLine(client, line, sizeof(line))) {
+        return HTTP_ERROR_TIMEOUT;
+      }
+      remaining = strtol(line, nullptr, 16);
+      if (remaining == 0) {
+        while (readLine(client, line, sizeof(line)) && line[0] != '\0') {
+          // Trailer headers
+        }
+        break;
+      }
+    } else if (remaining < 0) {
+      // No length - the body ends when the server closes the connection
+      close = true;
+      remaining = LONG_MAX;
+    }
 
-    if (httpResponseCode > 0) {
-      DEBUG_PRINT("WiFiManager: Telegram notification sent successfully (HTTP ");
-      DEBUG_PRINT(httpResponseCode);
-      DEBUG_PRINTLN(")");
-      return true;
-    } else {
-      DEBUG_PRINT("WiFiManager: Attempt ");
-      DEBUG_PRINT(attempt);
-      DEBUG_PRINT(" failed (Error: ");
-      DEBUG_PRINT(httpResponseCode);
-      DEBUG_PRINTLN(")");
+    while (remaining > 0) {
+      size_t count = client.readBytes(buffer, min((size_t)remaining, sizeof(buffer)));
+      if (count == 0) {
+        break;
+      }
+      if (body != nullptr && body->length() < maxBody) {
+        body->concat(buffer, min(count, maxBody - body->length()));
+      }
+      remaining -= count;
+    }
+
+    if (!chunked) {
+      if (remaining > 0 && contentLength >= 0) {
+        return HTTP_ERROR_TIMEOUT;
+      }
+      break;
+    }
+    readLine(client, line, sizeof(line));  // CRLF after the chunk
+  }
+
+  *keepAlive = !close;
+  return status;
+}
+
+bool WiFiManager::readLine(WiFiClient& client, char* line, size_t size) {
+  size_t length = client.readBytesUntil('\n', line, size - 1);
+  if (length == 0 && !client.connected() && client.available() == 0) {
+    return false;
+  }
+
+  // Drop the rest of an overlong line so it is not mistaken for the next one
+  if (length == size - 1) {
+    char discard[32];
+    while (client.readBytesUntil('\n', discard, sizeof(discard)) == sizeof(discard)) {
     }
   }
 
-  // All retries failed
-  DEBUG_PRINTLN("WiFiManager: All retry attempts failed");
-  return false;
+  if (length > 0 && line[length - 1] == '\r') {
+    length--;
+  }
+  line[length] = '\0';
+  return true;
+}
+
+void WiFiManager::closeIdleTelegram() {
+  if (telegramClient.connected() && millis() - telegramLastUse >= TELEGRAM_KEEPALIVE_IDLE) {
+    DEBUG_PRINTLN(F("WiFiManager: Closing idle Telegram connection"));
+    telegramClient.stop();
+  }
 }
 
 // Calculate DST offset based on US DST rules
@@ -257,37 +380,6 @@ int WiFiManager::calculateDSTOffset() {
   return isDST ? 1 : 0;
 }
 
-// URL encode helper function
-String WiFiManager::urlencode(const char* str) {
-  String encoded = "";
-  char c;
-  char code0;
-  char code1;
-
-  for (int i = 0; i < strlen(str); i++) {
-    c = str[i];
-    if (c == ' ') {
-      encoded += '+';
-    } else if (isalnum(c)) {
-      encoded += c;
-    } else {
-      code1 = (c & 0xf) + '0';
-      if ((c & 0xf) > 9) {
-        code1 = (c & 0xf) - 10 + 'A';
-      }
-      c = (c >> 4) & 0xf;
-      code0 = c + '0';
-      if (c > 9) {
-        code0 = c - 10 + 'A';
-      }
-      encoded += '%';
-      encoded += code0;
-      encoded += code1;
-    }
-  }
-  return encoded;
-}
-
 // Set callback for handling Telegram commands
 void WiFiManager::setTelegramCommandCallback(TelegramCommandCallback callback) {
   commandCallback = callback;
@@ -298,16 +390,30 @@ void WiFiManager::setReplyPending(bool pending) {
   replyPending = pending;
   if (pending) {
     replyPendingSince = millis();
-    DEBUG_PRINTLN("WiFiManager: Reply pending - pausing polling");
+    DEBUG_PRINTLN(F("WiFiManager: Reply pending - pausing polling"));
   } else {
-    DEBUG_PRINTLN("WiFiManager: Reply complete - resuming polling");
+    DEBUG_PRINTLN(F("WiFiManager: Reply complete - resuming polling"));
+  }
+}
+
+// Get Telegram update offset for a bot
+unsigned long WiFiManager::getUpdateOffset(int botIndex) {
+  if (botIndex < 0 || botIndex >= TELEGRAM_MAX_BOTS) {
+    return 0;
   }
+  return updateOffsets[botIndex];
+}
+
+// Restore Telegram update offset (prevents re-running old commands after a reset)
+void WiFiManager::setUpdateOffset(int botIndex, unsigned long offset) {
+  if (botIndex < 0 || botIndex >= TELEGRAM_MAX_BOTS) {
+    return;
+  }
+  updateOffsets[botIndex] = offset;
 }
 
 // Poll for incoming Telegram messages
-void WiFiManager::pollTelegramMessages(const char* botToken1, const char* chatID1,
-                                       const char* botToken2, const char* chatID2,
-                                       const char* botToken3, const char* chatID3) {
+void WiFiManager::pollTelegramMessages(RecipientRegistry* recipients) {
   // Only poll if connected to WiFi
   if (!isConnected()) {
     return;
@@ -318,7 +424,7 @@ void WiFiManager::pollTelegramMessages(const char* botToken1, const char* chatID
     unsigned long now = millis();
     // Auto-clear flag after 30 seconds in case something went wrong
     if (now - replyPendingSince > 30000) {
-      DEBUG_PRINTLN("WiFiManager: Reply timeout - clearing pending flag");
+      DEBUG_PRINTLN(F("WiFiManager: Reply timeout - clearing pending flag"));
       replyPending = false;
     } else {
       return;  // Skip polling while reply is being sent
@@ -332,53 +438,43 @@ void WiFiManager::pollTelegramMessages(const char* botToken1, const char* chatID
   }
   lastTelegramCheck = now;
 
-  // Poll each configured bot for messages
-  if (botToken1 != nullptr && strlen(botToken1) > 0 && chatID1 != nullptr && strlen(chatID1) > 0) {
-    checkBotForMessages(botToken1, chatID1, 0);
-  }
-
-  if (botToken2 != nullptr && strlen(botToken2) > 0 && chatID2 != nullptr && strlen(chatID2) > 0) {
-    checkBotForMessages(botToken2, chatID2, 1);
-  }
-
-  if (botToken3 != nullptr && strlen(botToken3) > 0 && chatID3 != nullptr && strlen(chatID3) > 0) {
-    checkBotForMessages(botToken3, chatID3, 2);
+  // Poll each bot once, however many people share it (one connection for all of them)
+  for (int bot = 0; bot < recipients->getBotCount(); bot++) {
+    checkBotForMessages(recipients, bot);
   }
 }
 
 // Helper function to check a specific bot for messages
-void WiFiManager::checkBotForMessages(const char* botToken, const char* chatID, int botIndex) {
-  WiFiClientSecure client;
-  client.setInsecure();  // Skip certificate validation
-
-  HTTPClient http;
-
-  // Build Telegram API URL to get updates
-  // Use long polling with offset to only get new messages
-  String url = "https://api.telegram.org/bot";
-  url += botToken;
-  url += "/getUpdates?offset=";
-  url += String(updateOffsets[botIndex]);
-  url += "&timeout=0";  // Don't wait, return immediately
-
-  DEBUG_PRINT("WiFiManager: Checking for Telegram messages (bot ");
+void WiFiManager::checkBotForMessages(RecipientRegistry* recipients, int botIndex) {
+  DEBUG_PRINT(F("WiFiManager: Checking for Telegram messages (bot "));
   DEBUG_PRINT(botIndex + 1);
-  DEBUG_PRINTLN(")");
+  DEBUG_PRINTLN(F(")"));
+
+  if (!openTelegram()) {
+    return;
+  }
 
-  // Begin HTTP connection
-  http.begin(client, url);
+  // GET /bot<token>/getUpdates with offset so only new messages are returned
+  // (one at a time - only the first update is parsed, the offset moves past it)
+  HttpRequestWriter<WiFiClientSecure> request(telegramClient);
+  request.begin(PSTR("GET"), PSTR("/bot"));
+  request.addPath(recipients->getBot(botIndex));
+  request.addPath_P(PSTR("/getUpdates"));
+  request.addQuery(PSTR("offset"), updateOffsets[botIndex]);
+  request.addQuery(PSTR("limit"), 1UL);
+  request.addQuery(PSTR("timeout"), 0UL);  // Don't wait, return immediately
 
-  // Send GET request
-  int httpResponseCode = http.GET();
+  // Send over the shared connection
+  String response;
+  int httpResponseCode = finishTelegramRequest(request, &response);
 
   if (httpResponseCode == 200) {
-    String response = http.getString();
-    DEBUG_PRINTLN("WiFiManager: Got Telegram response");
+    DEBUG_PRINTLN(F("WiFiManager: Got Telegram response"));
 
     // Parse JSON response manually (simple parsing since we only need a few fields)
     // Look for "update_id", "chat":{"id"}, and "text"
 
-    int updateIdPos = response.indexOf("\"update_id\":");
+    int updateIdPos = flashIndexOf(response.c_str(), PSTR("\"update_id\":"));
     if (updateIdPos > 0) {
       // Extract update_id
       int updateIdStart = updateIdPos + 12;  // Length of "update_id":
@@ -392,23 +488,23 @@ void WiFiManager::checkBotForMessages(const char* botToken, const char* chatID,
         updateOffsets[botIndex] = newUpdateId;
 
         // Extract chat ID
-        int chatIdPos = response.indexOf("\"chat\":{\"id\":");
+        int chatIdPos = flashIndexOf(response.c_str(), PSTR("\"chat\":{\"id\":"));
         if (chatIdPos > 0) {
           int chatIdStart = chatIdPos + 13;  // Length of "chat":{"id":
           int chatIdEnd = response.indexOf(',', chatIdStart);
           if (chatIdEnd < 0) chatIdEnd = response.indexOf('}', chatIdStart);
           String chatIdStr = response.substring(chatIdStart, chatIdEnd);
 
-          // Only process if message is from the authorized chat ID
-          if (chatIdStr == String(chatID)) {
+          // Only process if message is from a recipient of this bot
+          if (recipients->isAuthorized(botIndex, chatIdStr.c_str())) {
             // Extract text/command
-            int textPos = response.indexOf("\"text\":\"");
+            int textPos = flashIndexOf(response.c_str(), PSTR("\"text\":\""));
             if (textPos > 0) {
               int textStart = textPos + 8;  // Length of "text":"
-              int textEnd = response.indexOf("\"", textStart);
+              int textEnd = response.indexOf('"', textStart);
               String command = response.substring(textStart, textEnd);
 
-              DEBUG_PRINT("WiFiManager: Received command: ");
+              DEBUG_PRINT(F("WiFiManager: Received command: "));
               DEBUG_PRINTLN(command);
 
               // Call the callback with chat ID and command
@@ -417,74 +513,14 @@ void WiFiManager::checkBotForMessages(const char* botToken, const char* chatID,
               }
             }
           } else {
-            DEBUG_PRINTLN("WiFiManager: Message from unauthorized chat ID - ignoring");
+            DEBUG_PRINTLN(F("WiFiManager: Message from unauthorized chat ID - ignoring"));
           }
         }
       }
     }
   } else if (httpResponseCode < 0) {
-    DEBUG_PRINT("WiFiManager: Telegram polling failed (Error: ");
-    DEBUG_PRINT(httpResponseCode);
-    DEBUG_PRINTLN(")");
-  }
-
-  http.end();
-}
-
-// Trigger Voice Monkey device (Alexa routine)
-bool WiFiManager::triggerVoiceMonkey(const char* token, const char* device) {
-  // Check if we're connected to WiFi
-  if (!isConnected()) {
-    DEBUG_PRINTLN("WiFiManager: Cannot trigger Voice Monkey - not connected to WiFi");
-    return false;
-  }
-
-  // Check if token and device are configured
-  if (token == nullptr || strlen(token) == 0 || device == nullptr || strlen(device) == 0) {
-    DEBUG_PRINTLN("WiFiManager: Voice Monkey token or device not configured");
-    return false;
-  }
-
-  WiFiClientSecure client;
-  client.setInsecure();  // Skip certificate validation
-
-  HTTPClient http;
-
-  // Build Voice Monkey API URL with GET parameters
-  // Convert device name to lowercase (Voice Monkey API requires lowercase)
-  String deviceLower = String(device);
-  deviceLower.toLowerCase();
-
-  String url = "https://api-v2.voicemonkey.io/trigger?token=";
-  url += token;
-  url += "&device=";
-  url += deviceLower;
-
-  DEBUG_PRINT("WiFiManager: Triggering Voice Monkey device: ");
-  DEBUG_PRINT(device);
-  DEBUG_PRINT(" (lowercased to: ");
-  DEBUG_PRINT(deviceLower);
-  DEBUG_PRINTLN(")");
-  DEBUG_PRINT("WiFiManager: Full URL: ");
-  DEBUG_PRINTLN(url);
-
-  // Begin HTTP connection
-  http.begin(client, url);
-
-  // Send GET request
-  int httpResponseCode = http.GET();
-
-  if (httpResponseCode >= 200 && httpResponseCode < 300) {
-    DEBUG_PRINT("WiFiManager: Voice Monkey triggered successfully (HTTP ");
-    DEBUG_PRINT(httpResponseCode);
-    DEBUG_PRINTLN(")");
-    http.end();
-    return true;
-  } else {
-    DEBUG_PRINT("WiFiManager: Voice Monkey trigger failed (HTTP ");
+    DEBUG_PRINT(F("WiFiManager: Telegram polling failed (Error: "));
     DEBUG_PRINT(httpResponseCode);
-    DEBUG_PRINTLN(")");
-    http.end();
-    return false;
+    DEBUG_PRINTLN(F(")"));
   }
 }
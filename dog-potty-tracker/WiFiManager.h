@@ -3,11 +3,23 @@
 
 #include <Arduino.h>
 #include <ESP8266WiFi.h>
-#include <ESP8266HTTPClient.h>
 #include <WiFiClient.h>
 #include <WiFiClientSecure.h>
 #include <time.h>
 #include "config.h"
+#include "FlashStrings.h"
+#include "RecipientRegistry.h"
+#include "HttpRequestWriter.h"
+
+#define TELEGRAM_HOST "api.telegram.org"
+
+// Negative results of outgoing requests (positive values are HTTP status codes)
+#define HTTP_ERROR_WRITE -1      // Connection did not accept the request
+#define HTTP_ERROR_TIMEOUT -2    // No (complete) response in time
+#define HTTP_ERROR_PROTOCOL -3   // Response is not HTTP
+#define HTTP_ERROR_CONNECT -4    // Not sent (no WiFi, no TLS connection or not configured)
+
+#define HTTP_IS_SUCCESS(status) ((status) >= 200 && (status) < 300)
 
 // Callback type for handling incoming Telegram commands
 typedef void (*TelegramCommandCallback)(String chatId, String command);
@@ -31,23 +43,30 @@ public:
   // Force time sync
   void syncTime();
 
-  // Send Telegram notification
-  bool sendTelegramNotification(const char* botToken, const char* chatID, const char* message);
+  // Send Telegram notification (back-to-back sends share one kept-alive TLS connection)
+  // Returns the HTTP status (2xx = delivered) or a negative HTTP_ERROR_*
+  int sendTelegramNotification(const char* botToken, const char* chatID, const char* message);
 
-  // Poll for incoming Telegram messages (call in loop)
-  void pollTelegramMessages(const char* botToken1, const char* chatID1,
-                            const char* botToken2, const char* chatID2,
-                            const char* botToken3, const char* chatID3);
+  // Poll every bot for incoming Telegram messages (call in loop)
+  void pollTelegramMessages(RecipientRegistry* recipients);
 
   // Set callback for handling Telegram commands
   void setTelegramCommandCallback(TelegramCommandCallback callback);
 
-  // Trigger Voice Monkey device (Alexa routine)
-  bool triggerVoiceMonkey(const char* token, const char* device);
-
   // Mark that a reply is pending (stops polling temporarily)
   void setReplyPending(bool pending);
 
+  // Get/set Telegram update offset for a bot (kept across warm resets)
+  unsigned long getUpdateOffset(int botIndex);
+  void setUpdateOffset(int botIndex, unsigned long offset);
+
+  // Read status, headers and body of an HTTP/1.1 response (body up to maxBody bytes kept)
+  // Returns the status code or a negative error; keepAlive is false if the server closes
+  static int readResponse(WiFiClient& client, String* body, size_t maxBody, bool* keepAlive);
+
+  // Read one header line without the line ending (longer lines are truncated)
+  static bool readLine(WiFiClient& client, char* line, size_t size);
+
 private:
   const char* wifiSsid;
   const char* wifiPassword;
@@ -60,7 +79,7 @@ private:
   TelegramCommandCallback commandCallback;
   unsigned long lastTelegramCheck;
   unsigned long telegramCheckInterval;
-  unsigned long updateOffsets[3];  // Track update_id for each bot
+  unsigned long updateOffsets[TELEGRAM_MAX_BOTS];  // Track update_id for each bot
   bool replyPending;  // Flag to prevent polling while reply is being sent
   unsigned long replyPendingSince;  // Time when reply started
 
@@ -76,11 +95,21 @@ private:
   // Calculate DST offset based on US DST rules
   int calculateDSTOffset();
 
-  // URL encode helper function for Telegram
-  String urlencode(const char* str);
-
   // Check a specific bot for messages
-  void checkBotForMessages(const char* botToken, const char* chatID, int botIndex);
+  void checkBotForMessages(RecipientRegistry* recipients, int botIndex);
+
+  // Kept-alive connection to api.telegram.org, shared by sends and polling
+  WiFiClientSecure telegramClient;
+  unsigned long telegramLastUse;
+
+  // Connect the shared Telegram connection unless it is still open
+  bool openTelegram();
+
+  // Send a composed request on the shared connection and read the reply (body is optional)
+  int finishTelegramRequest(HttpRequestWriter<WiFiClientSecure>& request, String* body);
+
+  // Close the shared connection once it has been idle for TELEGRAM_KEEPALIVE_IDLE
+  void closeIdleTelegram();
 };
 
 #endif
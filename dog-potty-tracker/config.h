@@ -16,13 +16,38 @@
 #define SCREEN_HEIGHT 64
 #define OLED_RESET -1
 #define OLED_ADDRESS 0x3C  // Or 0x3D, check with I2C scanner if display doesn't work
+#define OLED_I2C_CLOCK 400000     // Fast mode (Hz); the bus is bit-banged, so this is CPU time
+#define OLED_FLUSH_CHUNK 32       // Bytes per I2C data transfer (ESP8266 Wire buffer is 128)
+#define OLED_FLUSH_BUDGET_US 2000 // Longest a display update may spend sending (microseconds)
 
 // Button Configuration
 #define DEBOUNCE_DELAY 50        // milliseconds
 
 // Display Configuration
 #define VIEW_ROTATION_INTERVAL 5000  // milliseconds (5 seconds)
-#define NIGHT_MODE_WAKE_DURATION 10000  // milliseconds (10 seconds)
+#define NIGHT_MODE_WAKE_DURATION 10000  // Display stays on this long after a button press at night (ms)
+
+// Display power (limits OLED burn-in; no I2C traffic while blanked)
+// A button press or a new yellow/red alert (outside night hours) wakes the panel
+#define DISPLAY_DIM_TIMEOUT 300000      // Dim after this long without activity (ms, 0 = never)
+#define DISPLAY_BLANK_TIMEOUT 0         // Blank after this long without activity in the daytime (ms, 0 = never)
+#define DISPLAY_CONTRAST_NORMAL 0xCF    // SSD1306 contrast (0x00-0xFF)
+#define DISPLAY_CONTRAST_DIM 0x01
+#define DISPLAY_RENDER_LOG_INTERVAL 60000  // Log how many frames were rendered this often (ms)
+
+// LED effects (run on the PWM/waveform generator and an SDK timer - no work in the main loop)
+// Green breathes, yellow blinks slowly, red strobes faster the longer the alert is ignored
+#define LED_PWM_FREQ 1000             // PWM frequency for dimmed LEDs (Hz)
+#define LED_TICK_MS 20                // Step of breathing and fades (ms)
+#define LED_BREATHE_PERIOD 4000       // Green breathing cycle (ms)
+#define LED_BREATHE_MIN 8             // Dimmest point of a breath (0-255)
+#define LED_BLINK_MS 1000             // Yellow on and off time (ms)
+#define LED_STROBE_FLASH_MS 60        // Red flash length (ms)
+#define LED_STROBE_SLOW_MS 1000       // Red flash period at the red threshold (ms)
+#define LED_STROBE_FAST_MS 250        // ...shortening to this (ms)
+#define LED_STROBE_RAMP_MINUTES 60    // ...this many minutes past the red threshold
+#define LED_NIGHT_BRIGHTNESS 24       // LED brightness during night hours (0 = off, 255 = full)
+#define LED_NIGHT_FADE_MS 3000        // Fade into and out of night brightness (ms)
 
 // LED Alert Thresholds (in minutes)
 // Yellow LED turns on after this many minutes since last pee
@@ -40,16 +65,29 @@
 // Mode 1: Show timestamps only (e.g., "OUT: 1:30 PM") - requires WiFi/NTP sync
 // Mode 2: Cycle between elapsed and timestamps (default)
 // Mode 3: Rotate through each timer individually with LARGE text (easier to read from distance)
+// Fixed at compile time: only the selected mode's rendering code is built (see DISPLAY_CONFIG below)
+#ifndef DISPLAY_MODE
 #define DISPLAY_MODE 3              // 0 = elapsed only, 1 = timestamps only, 2 = cycle, 3 = large rotating
+#endif
 #define DISPLAY_CYCLE_SECONDS 3.0   // Seconds between view changes (supports decimals)
 
 // Telegram Notification Configuration
 // Button press notifications (physical buttons only, not remote commands)
-// Note: Button notifications are delayed by 20 seconds to prevent blocking
+// These and NOTIFY_ON_YELLOW/RED are the defaults of the "notify" runtime setting
+// Presses are collected into one digest per recipient (e.g. "Rover peed and pooped at 3:12 PM")
 #define NOTIFY_ON_OUTSIDE false  // Notify when Outside button is pressed
 #define NOTIFY_ON_PEE true       // Notify when Pee button is pressed
 #define NOTIFY_ON_POOP true      // Notify when Poop button is pressed
 
+// Button notification digest
+#define NOTIFY_DIGEST_WINDOW 20000      // Send once no button was pressed for this long (ms)
+#define NOTIFY_DIGEST_MAX_WAIT 60000    // ...but never hold the first press longer than this (ms)
+#define NOTIFY_EVENT_BUFFER 12          // Presses kept until every recipient has them
+#define NOTIFY_BUDGET_MESSAGES 6        // Messages per recipient per budget period (burst size)
+#define NOTIFY_BUDGET_PERIOD 3600000    // Budget refills evenly over this period (ms)
+#define NOTIFY_RETRY_INTERVAL 30000     // Wait after a failed send, doubled per failure (ms)
+#define NOTIFY_RETRY_MAX 600000         // Longest wait between retries (ms)
+
 // LED alert notifications (when timer thresholds are exceeded)
 #define NOTIFY_ON_YELLOW true    // Notify when yellow LED turns on (warning)
 #define NOTIFY_ON_RED true       // Notify when red LED turns on (urgent)
@@ -57,7 +95,61 @@
 // EEPROM Configuration
 #define EEPROM_SIZE 512
 #define EEPROM_ADDRESS 0
-#define EEPROM_SAVE_INTERVAL 300000  // 5 minutes in milliseconds
+#define EEPROM_SAVE_INTERVAL 300000  // 5 minutes in milliseconds (safety flush, skipped if unchanged)
+#define EEPROM_COALESCE_WINDOW 2000  // Bursts of changes within this window share one flash commit
+
+// Brown-out protection: flush pending changes immediately when supply voltage drops
+// Set to 0 to disable (uses the ADC to read VCC, so A0 cannot be used for anything else)
+#define EEPROM_BROWNOUT_MV 2900      // Millivolts
+#define EEPROM_VCC_CHECK_INTERVAL 1000  // milliseconds
+
+// RTC Memory Configuration (hot state cache, survives warm resets but not power loss)
+// Offset is in 4-byte blocks; the first 32 blocks (128 bytes) are reserved for OTA (eboot)
+#define RTC_STATE_OFFSET 32
+#define RTC_STATE_MAGIC 0x444F4704  // "DOG" + layout version
+#define RTC_AGE_STEP 60             // Seconds; alert cooldown ages are rounded down to this in RTC memory
+
+// Statistics Configuration (interval stats, hour-of-day histograms, daily counts)
+// Persisted in EEPROM next to the timers and updated in O(1) on every timer change
+#define STATS_EEPROM_ADDRESS 64      // After PersistentData
+#define STATS_MAGIC 0x53544101       // "STA" + layout version
+#define STATS_DAYS 7                 // Days of daily counts kept (today first)
+#define STATS_MIN_INTERVAL 120       // Seconds; shorter gaps are double presses and are ignored
+#define STATS_MAX_INTERVAL 86400     // Seconds; longer gaps (missed logging) count but add no interval
+#define STATS_EWMA_SHIFT 3           // EWMA weight of the newest interval = 1/2^shift
+#define STATS_ON_DISPLAY true        // Add a stats page to display mode 2 (cycle)
+
+// Predictive Alerts (learn the dog's routine and move the yellow/red deadlines to match)
+// Yellow = expected next pee minus typical error, red = plus twice the typical error
+// The static thresholds (and setyellow/setred) apply until the prediction is confident
+#define PREDICT_ENABLED true
+#define PREDICT_EEPROM_ADDRESS 320     // After StatsData
+#define PREDICT_MIN_CONFIDENCE 40      // Percent
+#define PREDICT_MIN_MINUTES 60         // Predicted deadlines are clamped to this range
+#define PREDICT_MAX_MINUTES 600
+#define PREDICT_MIN_WINDOW 15          // Minutes between yellow and red at least
+
+// Runtime Configuration (set <key> <value> / config commands)
+// Thresholds, night mode, quiet hours, notification events and predictive alerts can be
+// changed without a reflash. The values in this file are the defaults until a setting is
+// changed; from then on the copy in EEPROM (between PersistentData and StatsData) wins.
+#define CONFIG_EEPROM_ADDRESS 24       // After PersistentData
+#define CONFIG_MAGIC 0x43464700        // "CFG" (layout version is stored separately for migration)
+
+// History Configuration (LittleFS, fixed-size circular tiers, ~16 KB in total)
+// Raw events for recent days, then hourly -> daily -> weekly rollups built at hour boundaries
+#define HISTORY_ENABLED true
+#define HISTORY_RAW_EVENTS 256       // Most recent timer events (16 bytes each)
+#define HISTORY_HOURS 168            // Hourly rollups: 7 days (16 bytes each)
+#define HISTORY_DAYS 366             // Daily rollups: 1 year
+#define HISTORY_WEEKS 260            // Weekly rollups: 5 years
+#define HISTORY_CHECK_INTERVAL 5000  // How often to look for a finished hour (ms)
+
+// History export over the HTTP API (GET /export, chunked CSV or JSON straight from flash)
+#define HISTORY_EXPORT_BUFFER_SIZE 512     // One chunk - the only RAM an export uses
+#define HISTORY_EXPORT_READS_PER_LOOP 8    // Records read from flash per loop iteration
+#define HISTORY_EXPORT_TIMEOUT 10000       // Abort if the client accepts no data for this long (ms)
+#define HISTORY_EXPORT_DEFAULT_DAYS 30     // Range when ?from= is not given
 
 // NTP Configuration
 #define NTP_SERVER1 "pool.ntp.org"
@@ -69,11 +161,123 @@
 #define WIFI_CONNECT_TIMEOUT 10000  // milliseconds (10 seconds)
 #define WIFI_RECONNECT_MAX_BACKOFF 60000  // 1 minute cap
 
+// Local HTTP API Configuration (LAN only, no authentication - keep it off untrusted networks)
+// GET /status, GET /events?since=<seq>, GET /commands, POST /commands (cmd=<command>)
+#define API_SERVER_ENABLED true
+#define API_SERVER_PORT 80
+#define API_STATUS_BUFFER_SIZE 320  // Preformatted /status JSON
+#define EVENT_LOG_SIZE 32           // Recent timer events kept in RAM for /events
+
+// Server-Sent Events push channel (GET /stream on the HTTP API)
+#define SSE_MAX_CLIENTS 3              // Concurrent live clients
+#define SSE_CLIENT_QUEUE_SIZE 256      // Bytes of pending events per client
+#define SSE_STALL_TIMEOUT 5000         // Evict a client that accepts no data for this long (ms)
+#define SSE_KEEPALIVE_INTERVAL 15000   // Comment line sent to idle clients (ms)
+
+// MQTT Configuration (persistent broker connection, broker address/credentials in secrets.h)
+// Topics: <prefix>/<id>/state/<timer> and <prefix>/<id>/alert (retained),
+//         <prefix>/<id>/events (timer events), <prefix>/<id>/cmd (commands in, QoS 1),
+//         <prefix>/<id>/cmd/result (command replies), <prefix>/<id>/online (last will)
+#define MQTT_ENABLED 0                   // 1 = enable (requires PubSubClient library)
+#define MQTT_PORT 1883
+#define MQTT_TOPIC_PREFIX "dogtracker"
+#define MQTT_KEEPALIVE 30                // seconds
+#define MQTT_RECONNECT_INTERVAL 5000     // milliseconds between connection attempts
+#define MQTT_OUTBOX_SIZE 8               // Events kept while the broker is unreachable
+#define MQTT_BUFFER_SIZE 1024            // PubSubClient packet buffer (longest command or reply plus topic)
+#define MQTT_COMMAND_SIZE 256            // Longest command accepted on the cmd topic (update with secret ~170)
+#define MQTT_REPLACES_TELEGRAM_POLLING true  // Skip Telegram polling while MQTT is connected
+
+// Peer Sync Configuration (several trackers on one LAN share timers over UDP multicast)
+// Only the elected node (lowest chip ID online) sends Telegram/Voice Monkey alerts
+#define PEER_SYNC_ENABLED false
+#define PEER_MULTICAST_GROUP 239, 255, 42, 99
+#define PEER_PORT 4210
+#define PEER_HEARTBEAT_INTERVAL 10000   // Full state broadcast (ms)
+#define PEER_UPDATE_REPEAT_DELAY 150    // Timer updates are sent twice, this far apart (ms)
+#define PEER_NODE_TIMEOUT 35000         // Peer considered gone after this long without packets (ms)
+#define PEER_MAX_NODES 8
+
 // Telegram Notifications Configuration
 #define TELEGRAM_NOTIFICATION_COOLDOWN 3600000  // 1 hour in milliseconds (prevent spam)
-#define NOTIFICATION_QUIET_START_HOUR 22     // 10 PM - don't send notifications
+#define TELEGRAM_MAX_RECIPIENTS 8            // Entries used from TELEGRAM_RECIPIENTS in secrets.h
+#define TELEGRAM_MAX_BOTS 4                  // Distinct bot tokens (each one is polled for commands)
+#define TELEGRAM_KEEPALIVE_IDLE 5000         // Close the shared TLS connection after this long unused (ms)
+#define TELEGRAM_MAX_RESPONSE 2048           // Bytes of a getUpdates reply kept for parsing
+#define NOTIFICATION_QUIET_START_HOUR 22     // 10 PM - don't send notifications (-1 = no quiet hours)
 #define NOTIFICATION_QUIET_END_HOUR 7        // 7 AM - resume notifications
 
+// Voice Monkey (Alexa) triggers - queued and sent from the main loop, never inline with alerts
+#define VOICE_MONKEY_QUEUE_SIZE 4            // Triggers waiting to be sent
+#define VOICE_MONKEY_DEVICE_SIZE 32          // Longest device name (lowercased copy kept in RAM)
+#define VOICE_MONKEY_DEDUP_WINDOW 60000      // Repeat triggers of the same device within this are dropped (ms)
+#define VOICE_MONKEY_TIMEOUT 10000           // Give up on a response after this long (ms)
+#define VOICE_MONKEY_RETRY_INTERVAL 5000     // Wait after a failed trigger, doubled per failure (ms)
+#define VOICE_MONKEY_MAX_ATTEMPTS 5          // Drop a trigger after this many failures
+#define VOICE_MONKEY_KEEPALIVE_IDLE 15000    // Close the TLS connection after this long unused (ms)
+#define VOICE_MONKEY_MIN_HEAP 20000          // Largest free heap block needed to open a TLS connection
+
+// OTA firmware updates pulled over HTTP from a server on the LAN (see tools/ota-server)
+// Started with "update http://<host>:<port>/<file> <sha256>" (HTTP API, MQTT or Telegram);
+// gzip-compressed images (.bin.gz) are accepted and unpacked by the bootloader
+#define OTA_ENABLED true
+#define OTA_CHUNK_SIZE 512               // Bytes read and written per loop iteration
+#define OTA_TIMEOUT 10000                // No data for this long = connection lost (ms)
+#define OTA_RETRY_INTERVAL 3000          // Wait before resuming after a lost connection (ms)
+#define OTA_MAX_ATTEMPTS 5               // Give up after this many connections in a row without data
+
+// Power saving (battery packs): the loop idles until it next has work to do instead of
+// every 10 ms, and a button press ends the idle at once (pin interrupt)
+// 0 = off (fixed 10 ms loop delay), 1 = WiFi modem sleep (radio off between beacons),
+// 2 = automatic light sleep (CPU stops too; LAN requests are answered a few beacons late)
+#define POWER_SAVE_MODE 0
+#define POWER_LISTEN_INTERVAL 3          // Sleeping radio wakes for every Nth DTIM beacon (1-10)
+#define POWER_MAX_IDLE 1000              // Longest idle - alerts and the clock are checked this often (ms)
+#define POWER_NETWORK_IDLE 100           // Longest idle while the HTTP API, MQTT or peer sync run (ms)
+#define POWER_BUTTON_POLL 10             // Idle while a button is debouncing (ms)
+#define POWER_REPORT_INTERVAL 3600000    // Duty cycle is measured and logged over this window (ms)
+
+// Display settings as typed constants, checked at compile time
+// DISPLAY_MODE can also be set from the build (-DDISPLAY_MODE=<n>, used by tools/size-report)
+struct DisplayConfig {
+  int mode;                  // DISPLAY_MODE
+  unsigned long cycleMs;     // DISPLAY_CYCLE_SECONDS in milliseconds
+  bool statsPage;            // Stats page in the mode 2 cycle
+};
+
+constexpr DisplayConfig DISPLAY_CONFIG = {
+  DISPLAY_MODE,
+  (unsigned long)(DISPLAY_CYCLE_SECONDS * 1000.0),
+  STATS_ON_DISPLAY && DISPLAY_MODE == 2
+};
+
+static_assert(DISPLAY_CONFIG.mode >= 0 && DISPLAY_CONFIG.mode <= 3, "DISPLAY_MODE must be 0, 1, 2 or 3");
+static_assert(DISPLAY_CONFIG.cycleMs >= 500, "DISPLAY_CYCLE_SECONDS must be at least 0.5");
+static_assert(SCREEN_HEIGHT % 8 == 0 && SCREEN_HEIGHT / 8 <= 8, "SCREEN_HEIGHT must be 8-64 in steps of 8 (one dirty bit per page)");
+static_assert(SCREEN_WIDTH <= 128, "SCREEN_WIDTH is at most 128 (SSD1306)");
+static_assert(OLED_FLUSH_CHUNK >= 1 && OLED_FLUSH_CHUNK <= 127, "OLED_FLUSH_CHUNK must fit the Wire buffer with the control byte");
+static_assert(SCREEN_WIDTH % OLED_FLUSH_CHUNK == 0, "OLED_FLUSH_CHUNK must divide SCREEN_WIDTH (chunks never cross a page)");
+static_assert(DISPLAY_CONTRAST_NORMAL <= 0xFF && DISPLAY_CONTRAST_DIM <= 0xFF, "Display contrast is 0x00-0xFF");
+static_assert(LED_STROBE_FAST_MS > LED_STROBE_FLASH_MS && LED_STROBE_SLOW_MS >= LED_STROBE_FAST_MS,
+              "Red strobe periods must be longer than the flash and slow >= fast");
+static_assert(LED_NIGHT_BRIGHTNESS >= 0 && LED_NIGHT_BRIGHTNESS <= 255 && LED_BREATHE_MIN <= 255, "LED brightness is 0-255");
+static_assert(POWER_SAVE_MODE >= 0 && POWER_SAVE_MODE <= 2, "POWER_SAVE_MODE must be 0, 1 or 2");
+static_assert(POWER_LISTEN_INTERVAL >= 1 && POWER_LISTEN_INTERVAL <= 10, "POWER_LISTEN_INTERVAL is 1-10 beacons");
+static_assert(POWER_NETWORK_IDLE <= POWER_MAX_IDLE && POWER_BUTTON_POLL < DEBOUNCE_DELAY,
+              "POWER_NETWORK_IDLE must not exceed POWER_MAX_IDLE, POWER_BUTTON_POLL must be below DEBOUNCE_DELAY");
+static_assert(YELLOW_THRESHOLD < RED_THRESHOLD, "YELLOW_THRESHOLD must be below RED_THRESHOLD");
+static_assert(YELLOW_THRESHOLD >= 1 && RED_THRESHOLD <= 1439, "Alert thresholds are 1-1439 minutes");
+static_assert(NOTIFICATION_QUIET_START_HOUR >= -1 && NOTIFICATION_QUIET_START_HOUR <= 23 &&
+              NOTIFICATION_QUIET_END_HOUR >= -1 && NOTIFICATION_QUIET_END_HOUR <= 23, "Quiet hours are 0-23 (or -1)");
+static_assert(NIGHT_MODE_START_HOUR >= -1 && NIGHT_MODE_START_HOUR <= 23 &&
+              NIGHT_MODE_END_HOUR >= -1 && NIGHT_MODE_END_HOUR <= 23, "Night mode hours are 0-23 (or -1)");
+static_assert((NOTIFICATION_QUIET_START_HOUR == -1) == (NOTIFICATION_QUIET_END_HOUR == -1) &&
+              (NOTIFICATION_QUIET_START_HOUR == -1 || NOTIFICATION_QUIET_START_HOUR != NOTIFICATION_QUIET_END_HOUR),
+              "Quiet hours need two different hours (or both -1)");
+static_assert((NIGHT_MODE_START_HOUR == -1) == (NIGHT_MODE_END_HOUR == -1) &&
+              (NIGHT_MODE_START_HOUR == -1 || NIGHT_MODE_START_HOUR != NIGHT_MODE_END_HOUR),
+              "Night mode needs two different hours (or both -1)");
+
 // Debug Configuration
 #define DEBUG 1  // Set to 0 to disable debug output
 
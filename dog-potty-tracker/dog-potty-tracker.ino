@@ -18,12 +18,32 @@
 #include <Wire.h>
 #include "config.h"
 #include "secrets.h"
+#include "FlashStrings.h"
 #include "TimerManager.h"
 #include "ButtonHandler.h"
 #include "DisplayManager.h"
 #include "WiFiManager.h"
 #include "LEDController.h"
 #include "Storage.h"
+#include "EventLog.h"
+#include "PottyStats.h"
+#include "PeePredictor.h"
+#include "RuntimeConfig.h"
+#include "History.h"
+#include "HistoryExport.h"
+#include "NotificationDigest.h"
+#include "RecipientRegistry.h"
+#include "VoiceMonkeyQueue.h"
+#include "ApiServer.h"
+#include "EventStream.h"
+#include "MqttManager.h"
+#include "PeerSync.h"
+#include "PowerManager.h"
+#include "OtaUpdater.h"
+
+#if EEPROM_BROWNOUT_MV > 0
+ADC_MODE(ADC_VCC);  // Route ADC to supply voltage for brown-out detection
+#endif
 
 // Global instances
 TimerManager timerManager;
@@ -32,65 +52,105 @@ DisplayManager displayManager;
 WiFiManager wifiManager;
 LEDController ledController;
 Storage storage;
+EventLog eventLog;
+PottyStats pottyStats;
+PeePredictor peePredictor;
+RuntimeConfig runtimeConfig;
+History history;
+HistoryExport historyExport;
+NotificationDigest notificationDigest;
+RecipientRegistry recipients;
+VoiceMonkeyQueue voiceMonkey;
+ApiServer apiServer;
+EventStream eventStream;
+#if MQTT_ENABLED
+MqttManager mqttManager;
+#endif
+PeerSync peerSync;
+PowerManager powerManager;
+OtaUpdater otaUpdater;
 
 // State tracking
 unsigned long lastEEPROMSave = 0;
-unsigned long nightModeWakeUntil = 0;
-bool temporaryWake = false;
 unsigned long lastRedNotificationTime = 0;
 unsigned long lastYellowNotificationTime = 0;
 bool redLEDWasOn = false;
 bool yellowLEDWasOn = false;
 bool wasInNightMode = false;
+AlertLevel lastAlertLevel = ALERT_GREEN;
 bool startupNotificationSent = false;
+uint8_t otaProgressShown = 0;  // Tens of percent last shown on the display
 
-// Queued button press notification (delayed to prevent blocking)
-bool buttonNotificationPending = false;
-unsigned long buttonNotificationSendTime = 0;
-String pendingButtonMessage = "";
-const unsigned long BUTTON_NOTIFICATION_DELAY = 20000;  // 20 second delay before sending
-
-// Runtime LED thresholds (can be modified via Telegram commands)
-unsigned int yellowThreshold = YELLOW_THRESHOLD;
-unsigned int redThreshold = RED_THRESHOLD;
+// Thresholds in force for the current pee interval (predicted when confident, else the
+// yellow/red settings in runtimeConfig)
+unsigned int activeYellowThreshold = YELLOW_THRESHOLD;
+unsigned int activeRedThreshold = RED_THRESHOLD;
+bool predictionActive = false;
 
 // Function prototypes
 void onButtonShortPress(Button button);
 bool isNightMode();
 bool isQuietHours();
-void handleNightMode();
 void saveToEEPROM();
+void saveSettings();
+void saveHotState();
+uint32_t getCooldownAge(unsigned long elapsed);
+bool restoreHotState();
 void checkAndSendNotification();
 void processQueuedButtonNotification();
-void queueButtonNotification(const char* eventName);
+void queueButtonNotification(Timer timer);
+int sendDigestMessage(uint8_t recipient, const char* message);
+int notifyRecipients(uint8_t event, const char* message);
 void sendStartupNotification();
 void handleTelegramCommand(String chatId, String command);
+bool executeCommand(String command, String& response);
+bool executeCommand(String command, String& response, bool trusted);
+bool isOtaSecret(const char* secret);
+void onTimerChanged(Timer timer, time_t previous, time_t current);
+void handlePeerChanges(uint8_t changedTimers);
+bool getPeePrediction(PeePrediction* prediction);
+void updateAlertThresholds();
+unsigned long getIdleTime();
+void rebootIntoUpdate();
 
 void setup() {
   // Initialize serial for debugging
   Serial.begin(115200);
   delay(100);
-  DEBUG_PRINTLN("\n\n=== Dog Potty Tracker ===");
-  DEBUG_PRINTLN("Initializing...\n");
+  DEBUG_PRINTLN(F("\n\n=== Dog Potty Tracker ==="));
+  DEBUG_PRINTLN(F("Initializing...\n"));
 
-  // Initialize storage
+  // Initialize storage (settings and statistics are committed together with the timers)
   storage.begin();
+  storage.setConfig(&runtimeConfig);
+  storage.loadConfig();
+  storage.setStats(&pottyStats);
+  storage.loadStats();
+  storage.setPredictor(&peePredictor);
+  storage.loadPredictor();
+
+  // Long-term history on LittleFS (raw events plus hourly/daily/weekly rollups)
+  if (HISTORY_ENABLED) {
+    history.begin();
+  }
 
   // Initialize display
-  DEBUG_PRINTLN("About to initialize display...");
+  DEBUG_PRINTLN(F("About to initialize display..."));
   if (!displayManager.begin()) {
-    DEBUG_PRINTLN("ERROR: Display initialization failed!");
+    DEBUG_PRINTLN(F("ERROR: Display initialization failed!"));
     // Continue anyway - device can still function
   }
-  DEBUG_PRINTLN("Display initialization attempt complete");
+  DEBUG_PRINTLN(F("Display initialization attempt complete"));
 
-  // Configure display mode
-  displayManager.setDisplayMode(DISPLAY_MODE, DISPLAY_CYCLE_SECONDS);
+  // Display mode is fixed at compile time (DISPLAY_CONFIG in config.h)
+  if (DISPLAY_CONFIG.statsPage) {
+    displayManager.setStats(&pottyStats);
+  }
 
   // Show startup message
-  DEBUG_PRINTLN("Showing startup message...");
+  DEBUG_PRINTLN(F("Showing startup message..."));
   displayManager.showStartup();
-  DEBUG_PRINTLN("Startup message complete");
+  DEBUG_PRINTLN(F("Startup message complete"));
 
   // Initialize button handler
   buttonHandler.begin();
@@ -102,21 +162,64 @@ void setup() {
   ledController.begin();
   ledController.test();  // Test LEDs on startup
 
-  // Load saved timer data from EEPROM
-  if (storage.load(&timerManager)) {
-    DEBUG_PRINTLN("Restored timer data from EEPROM");
-    displayManager.showFeedback("Data Loaded", 1500);
+  // Restore state from RTC memory after a warm reset, EEPROM only after power-up
+  if (restoreHotState()) {
+    DEBUG_PRINTLN(F("Restored hot state from RTC memory"));
+    displayManager.showFeedback(F("Data Restored"), 1500);
+  } else if (storage.load(&timerManager)) {
+    DEBUG_PRINTLN(F("Restored timer data from EEPROM"));
+    displayManager.showFeedback(F("Data Loaded"), 1500);
   } else {
-    DEBUG_PRINTLN("No valid saved data, starting fresh");
+    DEBUG_PRINTLN(F("No valid saved data, starting fresh"));
   }
 
   // Start WiFi connection (non-blocking)
   wifiManager.begin(WIFI_SSID, WIFI_PASSWORD);
 
+  // WiFi sleep type and button wake-up for the loop idle
+  powerManager.begin();
+
   // Set up Telegram command handler
   wifiManager.setTelegramCommandCallback(handleTelegramCommand);
 
-  DEBUG_PRINTLN("\nSetup complete!\n");
+  // Telegram recipients from secrets.h, grouped by bot
+  recipients.begin(TELEGRAM_RECIPIENTS, sizeof(TELEGRAM_RECIPIENTS) / sizeof(TELEGRAM_RECIPIENTS[0]));
+
+  // Button presses are sent as one digest per recipient
+  notificationDigest.begin(DOG_NAME, sendDigestMessage);
+  for (int i = 0; i < recipients.getCount(); i++) {
+    notificationDigest.setRecipientEnabled(i, recipients.wantsEvent(i, NOTIFY_EVENT_BUTTONS));
+  }
+
+  // Alexa routines (triggered from the loop so alerts never wait on Voice Monkey)
+  voiceMonkey.begin(VOICE_MONKEY_TOKEN, VOICE_MONKEY_DEVICE_STARTUP,
+                    VOICE_MONKEY_DEVICE_YELLOW, VOICE_MONKEY_DEVICE_RED);
+
+  // Track timer changes from here on (restored state above is not a new event)
+  timerManager.setChangeCallback(onTimerChanged);
+
+  // Share timers with other trackers on the LAN
+  if (PEER_SYNC_ENABLED) {
+    peerSync.begin(&timerManager);
+  }
+
+  // Start local HTTP API (serves once WiFi is connected)
+  if (API_SERVER_ENABLED) {
+    apiServer.begin(&timerManager, &eventLog, &storage);
+    apiServer.setCommandCallback(executeCommand);
+    apiServer.setEventStream(&eventStream);
+    if (HISTORY_ENABLED) {
+      apiServer.setHistoryExport(&historyExport, &history);
+    }
+  }
+
+  #if MQTT_ENABLED
+    // Persistent broker connection for state publishing and instant commands
+    mqttManager.begin(MQTT_HOST, MQTT_USER, MQTT_PASSWORD);
+    mqttManager.setCommandCallback(executeCommand);
+  #endif
+
+  DEBUG_PRINTLN(F("\nSetup complete!\n"));
 }
 
 void loop() {
@@ -125,10 +228,17 @@ void loop() {
   // Update WiFi (handles reconnection)
   wifiManager.update();
 
-  // Poll for incoming Telegram commands
-  wifiManager.pollTelegramMessages(TELEGRAM_BOT_TOKEN_1, TELEGRAM_CHAT_ID_1,
-                                   TELEGRAM_BOT_TOKEN_2, TELEGRAM_CHAT_ID_2,
-                                   TELEGRAM_BOT_TOKEN_3, TELEGRAM_CHAT_ID_3);
+  // Keep MQTT connection alive, receive commands and publish state
+  bool mqttConnected = false;
+  #if MQTT_ENABLED
+    mqttManager.update(&timerManager);
+    mqttConnected = mqttManager.isConnected();
+  #endif
+
+  // Poll for incoming Telegram commands (not needed while MQTT delivers commands)
+  if (!(mqttConnected && MQTT_REPLACES_TELEGRAM_POLLING)) {
+    wifiManager.pollTelegramMessages(&recipients);
+  }
 
   // Send startup notification once WiFi and time are ready
   if (!startupNotificationSent && wifiManager.isConnected() && wifiManager.isTimeSynced()) {
@@ -139,13 +249,27 @@ void loop() {
   // Check for button presses
   buttonHandler.update();
 
+  // Merge timer changes made on other trackers
+  if (PEER_SYNC_ENABLED) {
+    uint8_t peerChanges = peerSync.update(&timerManager);
+    if (peerChanges != 0) {
+      handlePeerChanges(peerChanges);
+    }
+  }
+
+  // Serve local HTTP API requests and push live updates to stream clients
+  if (API_SERVER_ENABLED) {
+    apiServer.update();
+    eventStream.update(&timerManager);
+  }
+
   // Check night mode
   bool nightMode = isNightMode();
 
   // Check if we just exited night mode
   if (wasInNightMode && !nightMode) {
     // Just exited night mode - reset notification cooldown timers
-    DEBUG_PRINTLN("Exited night mode - resetting notification timers");
+    DEBUG_PRINTLN(F("Exited night mode - resetting notification timers"));
     lastRedNotificationTime = millis();  // Prevent immediate red alert
     lastYellowNotificationTime = millis();  // Prevent immediate yellow alert
     redLEDWasOn = false;  // Reset LED tracking
@@ -154,71 +278,144 @@ void loop() {
 
   wasInNightMode = nightMode;  // Track for next loop iteration
 
-  // Note: Night mode no longer turns off display or LEDs
-  // It only suppresses notifications during quiet hours
+  // Night mode blanks the display shortly after the last button press (LEDs dim)
+  displayManager.setNightHours(nightMode);
+  ledController.setNightMode(nightMode);
+
+  // Move alert deadlines to the predicted next pee (when confident)
+  updateAlertThresholds();
 
-  // Update LED status based on timers (always called, but LEDs are managed by nightMode flag internally)
+  // Update LED pattern based on timers (the pins are only touched when the pattern changes)
   ledController.update(&timerManager);
 
+  // A new yellow/red alert wakes the display (not at night - the red LED covers that)
+  AlertLevel alertLevel = LEDController::getAlertLevel(&timerManager);
+  if (alertLevel > lastAlertLevel && !nightMode) {
+    displayManager.wake();
+  }
+  lastAlertLevel = alertLevel;
+
   // Check if we should send notifications (yellow/red LED status changes)
   checkAndSendNotification();
 
   // Process any queued button notification (delayed send)
   processQueuedButtonNotification();
 
+  // Send queued Voice Monkey triggers (one request in flight, response read when it arrives)
+  voiceMonkey.update(wifiManager.isConnected());
+
+  // Download a running firmware update, a chunk per iteration, and reboot into it once installed
+  if (OTA_ENABLED && otaUpdater.isBusy()) {
+    if (otaUpdater.update(wifiManager.isConnected())) {
+      rebootIntoUpdate();
+    } else if (!otaUpdater.isBusy()) {
+      displayManager.showFeedback(F("Update Failed"), 3000);
+    } else if (otaUpdater.getProgress() / 10 != otaProgressShown) {
+      otaProgressShown = otaUpdater.getProgress() / 10;
+      char message[16];
+      snprintf_P(message, sizeof(message), PSTR("Update %u%%"), otaProgressShown * 10);
+      displayManager.showFeedback(message, 3000);
+    }
+  }
+
   // Update display (handles view rotation)
   displayManager.update(&timerManager, wifiManager.isTimeSynced());
 
-  // Periodic EEPROM save (every 5 minutes)
+  // Roll the finished hour into the history tiers
+  if (HISTORY_ENABLED) {
+    history.update();
+  }
+
+  // Commit coalesced EEPROM changes (or flush early on low voltage)
+  storage.update(&timerManager);
+
+  // Periodic EEPROM safety save (every 5 minutes, skipped if unchanged)
   if (currentMillis - lastEEPROMSave >= EEPROM_SAVE_INTERVAL) {
-    saveToEEPROM();
+    storage.save(&timerManager);
     lastEEPROMSave = currentMillis;
   }
 
-  // Small delay to prevent overwhelming the loop
-  delay(10);
+  // Mirror hot state into RTC memory (only written when something changed)
+  saveHotState();
+
+  // Stream the next piece of a running history export (lowest priority, bounded per loop)
+  if (API_SERVER_ENABLED && HISTORY_ENABLED) {
+    historyExport.update();
+  }
+
+  // Idle until the next thing is due (a fixed 10 ms with POWER_SAVE_MODE 0)
+  powerManager.idle(getIdleTime());
+}
+
+// How long the loop can idle before something needs it (ms, capped to POWER_MAX_IDLE).
+// Timer minutes, alerts, notification windows and the history/EEPROM schedules work in
+// seconds, so the POWER_MAX_IDLE cap covers them; only shorter deadlines are checked here.
+unsigned long getIdleTime() {
+  // History export or firmware download still streaming - come straight back
+  if ((API_SERVER_ENABLED && HISTORY_ENABLED && historyExport.isBusy()) || (OTA_ENABLED && otaUpdater.isBusy())) {
+    return 0;
+  }
+
+  // Next frame, rotation or end of a feedback message (0 while a frame is being sent)
+  unsigned long idle = min((unsigned long)POWER_MAX_IDLE, displayManager.getIdleTime());
+
+  // Keep polling while a press is debouncing (the interrupt only catches the first edge)
+  if (buttonHandler.isSettling()) {
+    idle = min(idle, (unsigned long)POWER_BUTTON_POLL);
+  }
+
+  // LAN services and Voice Monkey responses are served from the loop
+  bool networkActive = API_SERVER_ENABLED || MQTT_ENABLED || PEER_SYNC_ENABLED || voiceMonkey.hasPending();
+  if (networkActive && wifiManager.isConnected()) {
+    idle = min(idle, (unsigned long)POWER_NETWORK_IDLE);
+  }
+
+  return idle;
+}
+
+// New firmware is installed - commit the timers to EEPROM and RTC memory, then restart
+// into it (a software restart keeps RTC memory, so cooldowns and offsets survive too)
+void rebootIntoUpdate() {
+  DEBUG_PRINTLN(F("Rebooting into the new firmware"));
+  storage.flush(&timerManager);
+  saveHotState();
+  ESP.restart();
 }
 
 void onButtonShortPress(Button button) {
-  DEBUG_PRINT("Short press: ");
+  DEBUG_PRINT(F("Short press: "));
   DEBUG_PRINTLN(button);
 
+  // Any press brightens or turns the display back on (the press still counts)
+  displayManager.wake();
+
   // Process button action and queue notification if enabled
   switch (button) {
     case BTN_OUTSIDE:
       timerManager.resetOutside();
-      displayManager.showFeedback("Outside!", 1500);
-      if (NOTIFY_ON_OUTSIDE) {
-        queueButtonNotification("went outside");
-      }
+      displayManager.showFeedback(F("Outside!"), 1500);
+      queueButtonNotification(TIMER_OUTSIDE);
       break;
 
     case BTN_PEE:
       timerManager.resetPee();
-      displayManager.showFeedback("Pee!", 1500);
-      if (NOTIFY_ON_PEE) {
-        queueButtonNotification("peed");
-      }
+      displayManager.showFeedback(F("Pee!"), 1500);
+      queueButtonNotification(TIMER_PEE);
       break;
 
     case BTN_POOP:
       timerManager.resetPoop();
-      displayManager.showFeedback("Poop!", 1500);
-      if (NOTIFY_ON_POOP) {
-        queueButtonNotification("pooped");
-      }
+      displayManager.showFeedback(F("Poop!"), 1500);
+      queueButtonNotification(TIMER_POOP);
       break;
   }
 
-  // Save to EEPROM immediately after button press
+  // Save to EEPROM (coalesced with any other press in the next few seconds)
   saveToEEPROM();
 }
 
 bool isNightMode() {
-  // Check if night mode is disabled
-  if (NIGHT_MODE_START_HOUR == -1 || NIGHT_MODE_END_HOUR == -1) {
-    return false;
-  }
+  const ConfigSettings& settings = runtimeConfig.get();
 
   // Only enable night mode if time is synced
   if (!wifiManager.isTimeSynced()) {
@@ -229,11 +426,13 @@ bool isNightMode() {
   struct tm* t = localtime(&now);
   int hour = t->tm_hour;
 
-  // Check if current hour is within night mode range
-  return (hour >= NIGHT_MODE_START_HOUR || hour < NIGHT_MODE_END_HOUR);
+  // Check if current hour is within night mode range (false when disabled)
+  return RuntimeConfig::isHourInWindow(settings.nightStartHour, settings.nightEndHour, hour);
 }
 
 bool isQuietHours() {
+  const ConfigSettings& settings = runtimeConfig.get();
+
   // Only check quiet hours if time is synced
   if (!wifiManager.isTimeSynced()) {
     return false;
@@ -243,233 +442,256 @@ bool isQuietHours() {
   struct tm* t = localtime(&now);
   int hour = t->tm_hour;
 
-  // Quiet hours: 10pm (22) to 7am
-  return (hour >= NOTIFICATION_QUIET_START_HOUR || hour < NOTIFICATION_QUIET_END_HOUR);
+  // Quiet hours: 10pm (22) to 7am by default (false when disabled)
+  return RuntimeConfig::isHourInWindow(settings.quietStartHour, settings.quietEndHour, hour);
+}
+
+void saveToEEPROM() {
+  // Write-back: RTC hot state is updated this loop, flash commit is coalesced
+  storage.markDirty();
 }
 
-void handleNightMode() {
-  // Check if temporary wake has expired
-  if (temporaryWake && millis() > nightModeWakeUntil) {
-    temporaryWake = false;
-    displayManager.setDisplayOn(false);
-    ledController.setNightMode(true);
-    DEBUG_PRINTLN("Night mode: Display sleep");
+void saveSettings() {
+  // Settings change rarely - commit now so a reset right after the command keeps them
+  storage.markDirty();
+  storage.flush(&timerManager);
+}
+
+void saveHotState() {
+  RtcState state;
+  memset(&state, 0, sizeof(state));
+  unsigned long now = millis();
+
+  state.outsideTimestamp = (uint32_t)timerManager.getTimestamp(TIMER_OUTSIDE);
+  state.peeTimestamp = (uint32_t)timerManager.getTimestamp(TIMER_PEE);
+  state.poopTimestamp = (uint32_t)timerManager.getTimestamp(TIMER_POOP);
+
+  // Alert latches
+  if (yellowLEDWasOn) state.flags |= RTC_FLAG_YELLOW_LED_WAS_ON;
+  if (redLEDWasOn) state.flags |= RTC_FLAG_RED_LED_WAS_ON;
+
+  // Cooldowns are stored as ages because millis() restarts from zero after a reset
+  if (lastYellowNotificationTime != 0) {
+    state.flags |= RTC_FLAG_YELLOW_NOTIFIED;
+    state.yellowNotificationAge = getCooldownAge(now - lastYellowNotificationTime);
+  }
+  if (lastRedNotificationTime != 0) {
+    state.flags |= RTC_FLAG_RED_NOTIFIED;
+    state.redNotificationAge = getCooldownAge(now - lastRedNotificationTime);
   }
 
-  // If not temporarily awake, ensure display and LEDs are off
-  if (!temporaryWake) {
-    displayManager.setNightMode(true);
-    ledController.setNightMode(true);
+  // Telegram offsets (so commands are not executed twice after a reset)
+  for (int i = 0; i < TELEGRAM_MAX_BOTS; i++) {
+    state.updateOffsets[i] = wifiManager.getUpdateOffset(i);
   }
-}
 
-void saveToEEPROM() {
-  storage.save(&timerManager);
+  // Button presses not delivered to every recipient yet
+  if (notificationDigest.hasPending()) {
+    state.flags |= RTC_FLAG_PENDING_MESSAGE;
+    notificationDigest.getSnapshot(&state.notifications, &state.pendingDelay);
+  }
+
+  // MQTT events the broker has not received yet
+  #if MQTT_ENABLED
+    state.mqttEventCount = mqttManager.getOutbox(state.mqttEvents);
+  #endif
+
+  storage.saveHotState(&state);
 }
 
-void queueButtonNotification(const char* eventName) {
-  // Queue a button notification to be sent after a delay
-  // This prevents blocking the device when buttons are pressed rapidly
-  pendingButtonMessage = String(DOG_NAME) + " " + eventName + "!";
-  buttonNotificationPending = true;
-  buttonNotificationSendTime = millis() + BUTTON_NOTIFICATION_DELAY;
-  DEBUG_PRINT("Button notification queued: ");
-  DEBUG_PRINTLN(pendingButtonMessage);
+// Age of an alert cooldown for RTC memory (seconds). Rounded down to RTC_AGE_STEP and capped
+// once the cooldown is over, so the hot state changes once a minute while a cooldown runs and
+// not at all afterwards; after a reset the cooldown runs at most RTC_AGE_STEP longer
+uint32_t getCooldownAge(unsigned long elapsed) {
+  uint32_t age = min(elapsed, (unsigned long)TELEGRAM_NOTIFICATION_COOLDOWN) / 1000;
+  return age - age % RTC_AGE_STEP;
 }
 
-void processQueuedButtonNotification() {
-  // Check if there's a pending button notification to send
-  if (!buttonNotificationPending) {
-    return;
+bool restoreHotState() {
+  RtcState state;
+  if (!storage.loadHotState(&state)) {
+    return false;
   }
 
-  // Check if it's time to send
-  if (millis() < buttonNotificationSendTime) {
-    return;
-  }
+  unsigned long now = millis();
 
-  // Clear the pending flag first (so we don't resend on failure)
-  buttonNotificationPending = false;
-  DEBUG_PRINTLN("Sending queued button notification...");
+  timerManager.setTimestamp(TIMER_OUTSIDE, (time_t)state.outsideTimestamp);
+  timerManager.setTimestamp(TIMER_PEE, (time_t)state.peeTimestamp);
+  timerManager.setTimestamp(TIMER_POOP, (time_t)state.poopTimestamp);
 
-  int successCount = 0;
+  yellowLEDWasOn = (state.flags & RTC_FLAG_YELLOW_LED_WAS_ON) != 0;
+  redLEDWasOn = (state.flags & RTC_FLAG_RED_LED_WAS_ON) != 0;
 
-  // Send to user 1
-  if (strlen(TELEGRAM_BOT_TOKEN_1) > 0 && strlen(TELEGRAM_CHAT_ID_1) > 0) {
-    DEBUG_PRINTLN("Sending button notification to user 1...");
-    if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_1, TELEGRAM_CHAT_ID_1, pendingButtonMessage.c_str())) {
-      successCount++;
-    }
+  // Rebuild cooldown timestamps relative to the new millis() (unsigned wrap is intended)
+  if (state.flags & RTC_FLAG_YELLOW_NOTIFIED) {
+    lastYellowNotificationTime = now - state.yellowNotificationAge * 1000;
+    if (lastYellowNotificationTime == 0) lastYellowNotificationTime = 1;
+  }
+  if (state.flags & RTC_FLAG_RED_NOTIFIED) {
+    lastRedNotificationTime = now - state.redNotificationAge * 1000;
+    if (lastRedNotificationTime == 0) lastRedNotificationTime = 1;
   }
 
-  // Send to user 2
-  if (strlen(TELEGRAM_BOT_TOKEN_2) > 0 && strlen(TELEGRAM_CHAT_ID_2) > 0) {
-    DEBUG_PRINTLN("Sending button notification to user 2...");
-    if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_2, TELEGRAM_CHAT_ID_2, pendingButtonMessage.c_str())) {
-      successCount++;
-    }
+  for (int i = 0; i < TELEGRAM_MAX_BOTS; i++) {
+    wifiManager.setUpdateOffset(i, state.updateOffsets[i]);
   }
 
-  // Send to user 3
-  if (strlen(TELEGRAM_BOT_TOKEN_3) > 0 && strlen(TELEGRAM_CHAT_ID_3) > 0) {
-    DEBUG_PRINTLN("Sending button notification to user 3...");
-    if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_3, TELEGRAM_CHAT_ID_3, pendingButtonMessage.c_str())) {
-      successCount++;
+  if (state.flags & RTC_FLAG_PENDING_MESSAGE) {
+    notificationDigest.restoreSnapshot(state.notifications, state.pendingDelay);
+  }
+
+  #if MQTT_ENABLED
+    mqttManager.restoreOutbox(state.mqttEvents, (int)min(state.mqttEventCount, (uint32_t)MQTT_OUTBOX_SIZE));
+  #endif
+
+  return true;
+}
+
+void queueButtonNotification(Timer timer) {
+  // Each button can be switched off with "set notify"
+  if (!(runtimeConfig.get().notifyEvents & NOTIFY_SETTING_BUTTON(timer))) {
+    return;
+  }
+
+  // Presses are collected and sent as one digest once the buttons go quiet
+  // This prevents blocking the device when buttons are pressed rapidly
+  notificationDigest.add(timer, timerManager.getTimestamp(timer));
+}
+
+void processQueuedButtonNotification() {
+  // Another tracker is the elected sender - it queued the same events from peer sync
+  if (!peerSync.isLeader()) {
+    if (notificationDigest.hasPending()) {
+      DEBUG_PRINTLN(F("Not the elected notifier - dropping queued button notifications"));
+      notificationDigest.discard();
     }
+    return;
   }
 
+  // Sends at most one digest per loop iteration
+  int upToDate = notificationDigest.update();
+
   // Show feedback on display
-  if (successCount > 0) {
-    String feedbackMessage = "Notified (";
-    feedbackMessage += successCount;
-    feedbackMessage += ")";
-    displayManager.showFeedback(feedbackMessage.c_str(), 1500);
-    DEBUG_PRINT("Button notifications sent successfully to ");
-    DEBUG_PRINT(successCount);
-    DEBUG_PRINTLN(" recipient(s)!");
+  if (upToDate > 0) {
+    char feedbackMessage[24];
+    snprintf_P(feedbackMessage, sizeof(feedbackMessage), PSTR("Notified (%d)"), upToDate);
+    displayManager.showFeedback(feedbackMessage, 1500);
   }
+}
 
-  // Clear the message
-  pendingButtonMessage = "";
+int sendDigestMessage(uint8_t recipient, const char* message) {
+  return wifiManager.sendTelegramNotification(recipients.getBotToken(recipient),
+                                              recipients.getChatId(recipient), message);
+}
+
+int notifyRecipients(uint8_t event, const char* message) {
+  // Event type switched off with "set notify"
+  if (!(runtimeConfig.get().notifyEvents & event)) {
+    return 0;
+  }
+
+  // Recipients are grouped by bot, so back-to-back sends reuse one TLS connection
+  int successCount = 0;
+  for (int i = 0; i < recipients.getCount(); i++) {
+    if (!recipients.wantsEvent(i, event)) {
+      continue;
+    }
+    DEBUG_PRINT(F("Sending notification to recipient "));
+    DEBUG_PRINTLN(i + 1);
+    if (HTTP_IS_SUCCESS(wifiManager.sendTelegramNotification(recipients.getBotToken(i), recipients.getChatId(i), message))) {
+      successCount++;
+    }
+  }
+  return successCount;
 }
 
 void checkAndSendNotification() {
   // Don't send notifications during quiet hours (10pm-7am)
   if (isQuietHours()) {
-    DEBUG_PRINTLN("Quiet hours active - notifications suppressed");
+    DEBUG_PRINTLN(F("Quiet hours active - notifications suppressed"));
     return;
   }
 
   // Get pee timer in minutes
   unsigned long peeMinutes = timerManager.getElapsed(TIMER_PEE) / 60;
-  bool yellowLEDIsOn = (peeMinutes > yellowThreshold);
-  bool redLEDIsOn = (peeMinutes > redThreshold);
+  bool yellowLEDIsOn = (peeMinutes > activeYellowThreshold);
+  bool redLEDIsOn = (peeMinutes > activeRedThreshold);
+
+  // Another tracker is the elected sender - only track LED state for failover
+  if (!peerSync.isLeader()) {
+    yellowLEDWasOn = yellowLEDIsOn;
+    redLEDWasOn = redLEDIsOn;
+    return;
+  }
 
   // Track if we sent any notifications this cycle
   int successCount = 0;
-  String feedbackMessage = "";
+  char feedbackMessage[24];
+  feedbackMessage[0] = '\0';
 
   // === YELLOW LED NOTIFICATION (All users) ===
-  if (yellowLEDIsOn && !yellowLEDWasOn && NOTIFY_ON_YELLOW) {
+  if (yellowLEDIsOn && !yellowLEDWasOn && (runtimeConfig.get().notifyEvents & NOTIFY_SETTING_YELLOW)) {
     // Yellow LED just turned on - send to all configured users
     unsigned long timeSinceLastYellowNotification = millis() - lastYellowNotificationTime;
 
     if (timeSinceLastYellowNotification >= TELEGRAM_NOTIFICATION_COOLDOWN || lastYellowNotificationTime == 0) {
       // Build notification message with actual time
-      String message = String(DOG_NAME) + " should go out soon (last pee at ";
-      message += timerManager.getTimestampFormatted(TIMER_PEE);
-      message += ")";
-
-      int yellowSuccessCount = 0;
-
-      // Send to user 1
-      if (strlen(TELEGRAM_BOT_TOKEN_1) > 0 && strlen(TELEGRAM_CHAT_ID_1) > 0) {
-        DEBUG_PRINTLN("Sending yellow alert to user 1...");
-        if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_1, TELEGRAM_CHAT_ID_1, message.c_str())) {
-          yellowSuccessCount++;
-        }
-      }
+      char message[96];
+      snprintf_P(message, sizeof(message), PSTR("%s should go out soon (last pee at %s)"),
+                 DOG_NAME, timerManager.getTimestampFormatted(TIMER_PEE).c_str());
 
-      // Send to user 2
-      if (strlen(TELEGRAM_BOT_TOKEN_2) > 0 && strlen(TELEGRAM_CHAT_ID_2) > 0) {
-        DEBUG_PRINTLN("Sending yellow alert to user 2...");
-        if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_2, TELEGRAM_CHAT_ID_2, message.c_str())) {
-          yellowSuccessCount++;
-        }
-      }
-
-      // Send to user 3
-      if (strlen(TELEGRAM_BOT_TOKEN_3) > 0 && strlen(TELEGRAM_CHAT_ID_3) > 0) {
-        DEBUG_PRINTLN("Sending yellow alert to user 3...");
-        if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_3, TELEGRAM_CHAT_ID_3, message.c_str())) {
-          yellowSuccessCount++;
-        }
-      }
+      int yellowSuccessCount = notifyRecipients(NOTIFY_EVENT_YELLOW, message);
 
-      // Trigger Voice Monkey (Alexa) yellow alert if configured
-      if (strlen(VOICE_MONKEY_TOKEN) > 0 && strlen(VOICE_MONKEY_DEVICE_YELLOW) > 0) {
-        DEBUG_PRINTLN("Triggering Voice Monkey yellow alert...");
-        wifiManager.triggerVoiceMonkey(VOICE_MONKEY_TOKEN, VOICE_MONKEY_DEVICE_YELLOW);
-      }
+      // Queue Voice Monkey (Alexa) yellow alert if configured
+      voiceMonkey.trigger(VM_DEVICE_YELLOW);
 
       // Update status
       if (yellowSuccessCount > 0) {
         lastYellowNotificationTime = millis();
         successCount += yellowSuccessCount;
-        feedbackMessage = "Yellow Alert Sent (";
-        feedbackMessage += yellowSuccessCount;
-        feedbackMessage += ")";
-        DEBUG_PRINT("Yellow notifications sent successfully to ");
+        snprintf_P(feedbackMessage, sizeof(feedbackMessage), PSTR("Yellow Alert Sent (%d)"), yellowSuccessCount);
+        DEBUG_PRINT(F("Yellow notifications sent successfully to "));
         DEBUG_PRINT(yellowSuccessCount);
-        DEBUG_PRINTLN(" recipient(s)!");
+        DEBUG_PRINTLN(F(" recipient(s)!"));
       }
     } else {
-      DEBUG_PRINTLN("Yellow notification cooldown active - skipping");
+      DEBUG_PRINTLN(F("Yellow notification cooldown active - skipping"));
     }
   }
 
   // === RED LED NOTIFICATION (All users) ===
-  if (redLEDIsOn && !redLEDWasOn && NOTIFY_ON_RED) {
+  if (redLEDIsOn && !redLEDWasOn && (runtimeConfig.get().notifyEvents & NOTIFY_SETTING_RED)) {
     // Red LED just turned on - send to all configured users
     unsigned long timeSinceLastRedNotification = millis() - lastRedNotificationTime;
 
     if (timeSinceLastRedNotification >= TELEGRAM_NOTIFICATION_COOLDOWN || lastRedNotificationTime == 0) {
       // Build notification message with actual time
-      String message = String(DOG_NAME) + " needs to pee NOW! (last pee at ";
-      message += timerManager.getTimestampFormatted(TIMER_PEE);
-      message += ")";
-
-      int redSuccessCount = 0;
-
-      // Send to user 1
-      if (strlen(TELEGRAM_BOT_TOKEN_1) > 0 && strlen(TELEGRAM_CHAT_ID_1) > 0) {
-        DEBUG_PRINTLN("Sending red alert to user 1...");
-        if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_1, TELEGRAM_CHAT_ID_1, message.c_str())) {
-          redSuccessCount++;
-        }
-      }
-
-      // Send to user 2
-      if (strlen(TELEGRAM_BOT_TOKEN_2) > 0 && strlen(TELEGRAM_CHAT_ID_2) > 0) {
-        DEBUG_PRINTLN("Sending red alert to user 2...");
-        if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_2, TELEGRAM_CHAT_ID_2, message.c_str())) {
-          redSuccessCount++;
-        }
-      }
+      char message[96];
+      snprintf_P(message, sizeof(message), PSTR("%s needs to pee NOW! (last pee at %s)"),
+                 DOG_NAME, timerManager.getTimestampFormatted(TIMER_PEE).c_str());
 
-      // Send to user 3
-      if (strlen(TELEGRAM_BOT_TOKEN_3) > 0 && strlen(TELEGRAM_CHAT_ID_3) > 0) {
-        DEBUG_PRINTLN("Sending red alert to user 3...");
-        if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_3, TELEGRAM_CHAT_ID_3, message.c_str())) {
-          redSuccessCount++;
-        }
-      }
+      int redSuccessCount = notifyRecipients(NOTIFY_EVENT_RED, message);
 
-      // Trigger Voice Monkey (Alexa) red alert if configured
-      if (strlen(VOICE_MONKEY_TOKEN) > 0 && strlen(VOICE_MONKEY_DEVICE_RED) > 0) {
-        DEBUG_PRINTLN("Triggering Voice Monkey red alert...");
-        wifiManager.triggerVoiceMonkey(VOICE_MONKEY_TOKEN, VOICE_MONKEY_DEVICE_RED);
-      }
+      // Queue Voice Monkey (Alexa) red alert if configured
+      voiceMonkey.trigger(VM_DEVICE_RED);
 
       // Update status
       if (redSuccessCount > 0) {
         lastRedNotificationTime = millis();
         successCount += redSuccessCount;
-        feedbackMessage = "Red Alert Sent (";
-        feedbackMessage += redSuccessCount;
-        feedbackMessage += ")";
-        DEBUG_PRINT("Red notifications sent successfully to ");
+        snprintf_P(feedbackMessage, sizeof(feedbackMessage), PSTR("Red Alert Sent (%d)"), redSuccessCount);
+        DEBUG_PRINT(F("Red notifications sent successfully to "));
         DEBUG_PRINT(redSuccessCount);
-        DEBUG_PRINTLN(" recipient(s)!");
+        DEBUG_PRINTLN(F(" recipient(s)!"));
       }
     } else {
-      DEBUG_PRINTLN("Red notification cooldown active - skipping");
+      DEBUG_PRINTLN(F("Red notification cooldown active - skipping"));
     }
   }
 
   // Show feedback on display if any notifications were sent
-  if (successCount > 0 && feedbackMessage.length() > 0) {
-    displayManager.showFeedback(feedbackMessage.c_str(), 2000);
+  if (successCount > 0 && feedbackMessage[0] != '\0') {
+    displayManager.showFeedback(feedbackMessage, 2000);
   }
 
   // Update LED states for next iteration
@@ -478,61 +700,183 @@ void checkAndSendNotification() {
 }
 
 void sendStartupNotification() {
-  DEBUG_PRINTLN("Sending startup notifications...");
+  DEBUG_PRINTLN(F("Sending startup notifications..."));
 
-  String message = String(DOG_NAME) + " tracker is online!";
-  int successCount = 0;
+  char message[64];
+  snprintf_P(message, sizeof(message), PSTR("%s tracker is online!"), DOG_NAME);
+  int successCount = notifyRecipients(NOTIFY_EVENT_STARTUP, message);
 
-  // Send to all configured Telegram users
-  if (strlen(TELEGRAM_BOT_TOKEN_1) > 0 && strlen(TELEGRAM_CHAT_ID_1) > 0) {
-    DEBUG_PRINTLN("Sending startup notification to Telegram user 1...");
-    if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_1, TELEGRAM_CHAT_ID_1, message.c_str())) {
-      successCount++;
-    }
+  // Queue Voice Monkey (Alexa) startup alert if configured (trigger logs a repeat or full queue)
+  if (voiceMonkey.isConfigured(VM_DEVICE_STARTUP)) {
+    voiceMonkey.trigger(VM_DEVICE_STARTUP);
+  } else {
+    DEBUG_PRINTLN(F("Voice Monkey not configured - skipping startup alert"));
   }
 
-  if (strlen(TELEGRAM_BOT_TOKEN_2) > 0 && strlen(TELEGRAM_CHAT_ID_2) > 0) {
-    DEBUG_PRINTLN("Sending startup notification to Telegram user 2...");
-    if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_2, TELEGRAM_CHAT_ID_2, message.c_str())) {
-      successCount++;
-    }
+  // Show feedback on display
+  if (successCount > 0) {
+    char feedbackMessage[24];
+    snprintf_P(feedbackMessage, sizeof(feedbackMessage), PSTR("Startup Sent (%d)"), successCount);
+    displayManager.showFeedback(feedbackMessage, 2000);
+    DEBUG_PRINT(F("Startup notifications sent successfully to "));
+    DEBUG_PRINT(successCount);
+    DEBUG_PRINTLN(F(" recipient(s)!"));
+  } else {
+    DEBUG_PRINTLN(F("No notification recipients configured"));
   }
+}
 
-  if (strlen(TELEGRAM_BOT_TOKEN_3) > 0 && strlen(TELEGRAM_CHAT_ID_3) > 0) {
-    DEBUG_PRINTLN("Sending startup notification to Telegram user 3...");
-    if (wifiManager.sendTelegramNotification(TELEGRAM_BOT_TOKEN_3, TELEGRAM_CHAT_ID_3, message.c_str())) {
-      successCount++;
+void onTimerChanged(Timer timer, time_t previous, time_t current) {
+  // Update running statistics and the predictor (persisted with the next timer commit)
+  pottyStats.record(timer, previous, current);
+  if (timer == TIMER_PEE && current >= 1000000000) {
+    bool hasPrevious = previous >= 1000000000;
+    peePredictor.recordPee(hasPrevious ? (uint32_t)previous : 0, (uint32_t)current,
+                           hasPrevious ? localtime(&previous)->tm_hour : 0);
+  } else if (timer == TIMER_OUTSIDE && current >= 1000000000) {
+    peePredictor.recordOutside((uint32_t)current);
+  }
+
+  // Keep the event in long-term history
+  if (HISTORY_ENABLED) {
+    history.record(timer, previous, current);
+  }
+
+  // Redraw now instead of at the next minute
+  displayManager.invalidate();
+
+  // Keep recent events for the HTTP API and push them to live clients
+  eventLog.record(timer, current);
+  eventStream.pushTimerChange(timer, current);
+
+  #if MQTT_ENABLED
+    mqttManager.publishTimerChange(timer, current);
+  #endif
+
+  // Tell the other trackers (skipped for changes that came from them)
+  if (PEER_SYNC_ENABLED) {
+    peerSync.onLocalChange(timer, current);
+  }
+}
+
+void handlePeerChanges(uint8_t changedTimers) {
+  displayManager.showFeedback(F("Synced"), 1000);
+  saveToEEPROM();
+
+  // The elected node notifies for presses made on other trackers
+  if (!peerSync.isLeader()) {
+    return;
+  }
+
+  time_t now = time(nullptr);
+  for (int i = 0; i < 3; i++) {
+    // Only fresh events count as presses (setpee 90 and similar are not announced)
+    if ((changedTimers & (1 << i)) &&
+        now - timerManager.getTimestamp((Timer)i) < 60) {
+      queueButtonNotification((Timer)i);
     }
   }
+}
 
-  // Trigger Voice Monkey (Alexa) startup alert if configured
-  if (strlen(VOICE_MONKEY_TOKEN) > 0 && strlen(VOICE_MONKEY_DEVICE_STARTUP) > 0) {
-    DEBUG_PRINTLN("Triggering Voice Monkey startup alert...");
-    wifiManager.triggerVoiceMonkey(VOICE_MONKEY_TOKEN, VOICE_MONKEY_DEVICE_STARTUP);
-  } else {
-    DEBUG_PRINTLN("Voice Monkey not configured - skipping startup alert");
+bool getPeePrediction(PeePrediction* prediction) {
+  time_t lastPee = timerManager.getTimestamp(TIMER_PEE);
+  if (!timerManager.isTimeSynced() || lastPee < 1000000000) {
+    return false;
   }
+  return peePredictor.predict((uint32_t)lastPee, localtime(&lastPee)->tm_hour,
+                              (uint32_t)time(nullptr), prediction);
+}
 
-  // Show feedback on display
-  if (successCount > 0) {
-    String feedbackMessage = "Startup Sent (";
-    feedbackMessage += successCount;
-    feedbackMessage += ")";
-    displayManager.showFeedback(feedbackMessage.c_str(), 2000);
-    DEBUG_PRINT("Startup notifications sent successfully to ");
-    DEBUG_PRINT(successCount);
-    DEBUG_PRINTLN(" recipient(s)!");
-  } else {
-    DEBUG_PRINTLN("No notification recipients configured");
+void updateAlertThresholds() {
+  static unsigned long lastUpdate = 0;
+  static unsigned long lastRevision = 0;
+  static unsigned long lastConfigRevision = 0;
+
+  // Prediction only changes with timer events or slowly (outside-without-pee), check once a minute
+  if (lastUpdate != 0 && timerManager.getRevision() == lastRevision &&
+      runtimeConfig.getRevision() == lastConfigRevision && millis() - lastUpdate < 60000) {
+    return;
+  }
+  lastUpdate = millis();
+  lastRevision = timerManager.getRevision();
+  lastConfigRevision = runtimeConfig.getRevision();
+
+  const ConfigSettings& settings = runtimeConfig.get();
+  activeYellowThreshold = settings.yellowThreshold;
+  activeRedThreshold = settings.redThreshold;
+  predictionActive = false;
+
+  PeePrediction prediction;
+  if (!settings.predict || !getPeePrediction(&prediction) ||
+      prediction.confidence < PREDICT_MIN_CONFIDENCE) {
+    return;
   }
+
+  // Yellow when the pee is due (minus typical error), red once it is clearly overdue
+  long yellow = ((long)prediction.interval - (long)prediction.spread) / 60;
+  long red = ((long)prediction.interval + 2 * (long)prediction.spread) / 60;
+  yellow = constrain(yellow, PREDICT_MIN_MINUTES, PREDICT_MAX_MINUTES - PREDICT_MIN_WINDOW);
+  red = constrain(red, yellow + PREDICT_MIN_WINDOW, PREDICT_MAX_MINUTES);
+
+  activeYellowThreshold = (unsigned int)yellow;
+  activeRedThreshold = (unsigned int)red;
+  predictionActive = true;
 }
 
 void handleTelegramCommand(String chatId, String command) {
-  DEBUG_PRINT("Handling Telegram command from ");
+  DEBUG_PRINT(F("Handling Telegram command from "));
   DEBUG_PRINT(chatId);
-  DEBUG_PRINT(": ");
+  DEBUG_PRINT(F(": "));
   DEBUG_PRINTLN(command);
 
+  String response;
+  executeCommand(command, response, true);  // Sender's chat ID was checked against the recipients
+
+  // REPLIES DISABLED: ESP8266 hardware limitation
+  // The ESP8266 has only ~11KB free heap and cannot handle HTTPS polling + replies
+  // Even with 5+ second delays, the SSL/TLS stack remains exhausted (heap doesn't recover)
+  // Commands still execute successfully - verify via:
+  //   1. Display shows "Pee! (Remote)" or similar feedback
+  //   2. Timer values update on screen
+  //   3. EEPROM saves (check serial output)
+  //   4. GET /status on the local HTTP API
+  //
+  // Alternative solutions:
+  //   - Upgrade to ESP32 (32KB+ heap, better SSL stack)
+  //   - Raspberry Pi Pico W (much more memory)
+  //   - Disable Telegram polling and only send alerts (no remote commands)
+  //   - Use MQTT instead of HTTPS for bidirectional communication
+  //   - Use POST /commands on the local HTTP API, which does reply
+
+  DEBUG_PRINT(F("Command executed successfully: "));
+  DEBUG_PRINTLN(response);
+  DEBUG_PRINTLN(F("(Reply disabled - ESP8266 SSL limitation)"));
+}
+
+// Commands from the HTTP API and MQTT - any host on the LAN can send them
+bool executeCommand(String command, String& response) {
+  return executeCommand(command, response, false);
+}
+
+// Check the secret a LAN caller sent with an update (never matches while OTA_SECRET is blank)
+bool isOtaSecret(const char* secret) {
+  size_t length = strlen(OTA_SECRET);
+  if (length == 0 || strlen(secret) != length) {
+    return false;
+  }
+  uint8_t difference = 0;
+  for (size_t i = 0; i < length; i++) {
+    difference |= (uint8_t)(secret[i] ^ OTA_SECRET[i]);
+  }
+  return difference == 0;
+}
+
+// trusted: the sender is authenticated (Telegram) - required for firmware updates
+// unless the command carries OTA_SECRET
+bool executeCommand(String command, String& response, bool trusted) {
+  // Update URLs are case-sensitive - keep the command as sent for them
+  String original = command;
+
   // Convert command to lowercase for case-insensitive matching
   command.toLowerCase();
 
@@ -543,41 +887,41 @@ void handleTelegramCommand(String chatId, String command) {
   }
 
   // Remove leading slash if present (accept both "/pee" and "pee")
-  if (command.startsWith("/")) {
+  if (flashStartsWith(command.c_str(), PSTR("/"))) {
     command = command.substring(1);
   }
 
-  String response = "";
+  response = F("");
   bool commandRecognized = false;
 
   // Handle commands (without slash)
-  if (command == "pee") {
+  if (flashEquals(command.c_str(), PSTR("pee"))) {
     timerManager.resetPee();
-    displayManager.showFeedback("Pee! (Remote)", 1500);
+    displayManager.showFeedback(F("Pee! (Remote)"), 1500);
     saveToEEPROM();
-    response = "Pee timer reset!";
+    response = F("Pee timer reset!");
     commandRecognized = true;
-    DEBUG_PRINTLN("Remote pee command executed");
+    DEBUG_PRINTLN(F("Remote pee command executed"));
   }
-  else if (command == "poo" || command == "poop") {
+  else if (flashEquals(command.c_str(), PSTR("poo")) || flashEquals(command.c_str(), PSTR("poop"))) {
     timerManager.resetPoop();
-    displayManager.showFeedback("Poop! (Remote)", 1500);
+    displayManager.showFeedback(F("Poop! (Remote)"), 1500);
     saveToEEPROM();
-    response = "Poop timer reset!";
+    response = F("Poop timer reset!");
     commandRecognized = true;
-    DEBUG_PRINTLN("Remote poop command executed");
+    DEBUG_PRINTLN(F("Remote poop command executed"));
   }
-  else if (command == "out" || command == "outside") {
+  else if (flashEquals(command.c_str(), PSTR("out")) || flashEquals(command.c_str(), PSTR("outside"))) {
     timerManager.resetOutside();
-    displayManager.showFeedback("Outside! (Remote)", 1500);
+    displayManager.showFeedback(F("Outside! (Remote)"), 1500);
     saveToEEPROM();
-    response = "Outside timer reset!";
+    response = F("Outside timer reset!");
     commandRecognized = true;
-    DEBUG_PRINTLN("Remote outside command executed");
+    DEBUG_PRINTLN(F("Remote outside command executed"));
   }
   // Note: /status command removed - cannot send replies on ESP8266 due to SSL limitations
   // For status with replies, upgrade to Raspberry Pi Pico W (see micropython-pico-w branch)
-  else if (command.startsWith("setpee ")) {
+  else if (flashStartsWith(command.c_str(), PSTR("setpee "))) {
     // Format: setpee 90 (minutes ago)
     int minutes = command.substring(7).toInt();
     if (minutes > 0) {
@@ -585,55 +929,61 @@ void handleTelegramCommand(String chatId, String command) {
       time_t targetTime = now - (minutes * 60);
       timerManager.setTimestamp(TIMER_PEE, targetTime);
       saveToEEPROM();
-      response = "Pee timer set to " + String(minutes) + " minutes ago";
-      displayManager.showFeedback("Pee Set (Remote)", 1500);
+      response = F("Pee timer set to ");
+      response += minutes;
+      response += F(" minutes ago");
+      displayManager.showFeedback(F("Pee Set (Remote)"), 1500);
       commandRecognized = true;
-      DEBUG_PRINT("Pee timer manually set to ");
+      DEBUG_PRINT(F("Pee timer manually set to "));
       DEBUG_PRINT(minutes);
-      DEBUG_PRINTLN(" minutes ago");
+      DEBUG_PRINTLN(F(" minutes ago"));
     } else {
-      response = "Invalid format. Use: setpee <minutes>\nExample: setpee 90";
+      response = F("Invalid format. Use: setpee <minutes>\nExample: setpee 90");
     }
   }
-  else if (command.startsWith("setpoo ") || command.startsWith("setpoop ")) {
+  else if (flashStartsWith(command.c_str(), PSTR("setpoo ")) || flashStartsWith(command.c_str(), PSTR("setpoop "))) {
     // Format: setpoo 120 (minutes ago)
-    int startPos = command.startsWith("setpoo ") ? 7 : 8;
+    int startPos = flashStartsWith(command.c_str(), PSTR("setpoo ")) ? 7 : 8;
     int minutes = command.substring(startPos).toInt();
     if (minutes > 0) {
       time_t now = time(nullptr);
       time_t targetTime = now - (minutes * 60);
       timerManager.setTimestamp(TIMER_POOP, targetTime);
       saveToEEPROM();
-      response = "Poop timer set to " + String(minutes) + " minutes ago";
-      displayManager.showFeedback("Poop Set (Remote)", 1500);
+      response = F("Poop timer set to ");
+      response += minutes;
+      response += F(" minutes ago");
+      displayManager.showFeedback(F("Poop Set (Remote)"), 1500);
       commandRecognized = true;
-      DEBUG_PRINT("Poop timer manually set to ");
+      DEBUG_PRINT(F("Poop timer manually set to "));
       DEBUG_PRINT(minutes);
-      DEBUG_PRINTLN(" minutes ago");
+      DEBUG_PRINTLN(F(" minutes ago"));
     } else {
-      response = "Invalid format. Use: setpoo <minutes>\nExample: setpoo 120";
+      response = F("Invalid format. Use: setpoo <minutes>\nExample: setpoo 120");
     }
   }
-  else if (command.startsWith("setout ") || command.startsWith("setoutside ")) {
+  else if (flashStartsWith(command.c_str(), PSTR("setout ")) || flashStartsWith(command.c_str(), PSTR("setoutside "))) {
     // Format: setout 45 (minutes ago)
-    int startPos = command.startsWith("setout ") ? 7 : 11;
+    int startPos = flashStartsWith(command.c_str(), PSTR("setout ")) ? 7 : 11;
     int minutes = command.substring(startPos).toInt();
     if (minutes > 0) {
       time_t now = time(nullptr);
       time_t targetTime = now - (minutes * 60);
       timerManager.setTimestamp(TIMER_OUTSIDE, targetTime);
       saveToEEPROM();
-      response = "Outside timer set to " + String(minutes) + " minutes ago";
-      displayManager.showFeedback("Outside Set (Remote)", 1500);
+      response = F("Outside timer set to ");
+      response += minutes;
+      response += F(" minutes ago");
+      displayManager.showFeedback(F("Outside Set (Remote)"), 1500);
       commandRecognized = true;
-      DEBUG_PRINT("Outside timer manually set to ");
+      DEBUG_PRINT(F("Outside timer manually set to "));
       DEBUG_PRINT(minutes);
-      DEBUG_PRINTLN(" minutes ago");
+      DEBUG_PRINTLN(F(" minutes ago"));
     } else {
-      response = "Invalid format. Use: setout <minutes>\nExample: setout 45";
+      response = F("Invalid format. Use: setout <minutes>\nExample: setout 45");
     }
   }
-  else if (command.startsWith("setall ")) {
+  else if (flashStartsWith(command.c_str(), PSTR("setall "))) {
     // Format: setall 60 (sets all timers to 60 minutes ago)
     int minutes = command.substring(7).toInt();
     if (minutes > 0) {
@@ -643,64 +993,179 @@ void handleTelegramCommand(String chatId, String command) {
       timerManager.setTimestamp(TIMER_PEE, targetTime);
       timerManager.setTimestamp(TIMER_POOP, targetTime);
       saveToEEPROM();
-      response = "All timers set to " + String(minutes) + " minutes ago";
-      displayManager.showFeedback("All Set (Remote)", 1500);
+      response = F("All timers set to ");
+      response += minutes;
+      response += F(" minutes ago");
+      displayManager.showFeedback(F("All Set (Remote)"), 1500);
       commandRecognized = true;
-      DEBUG_PRINT("All timers manually set to ");
+      DEBUG_PRINT(F("All timers manually set to "));
       DEBUG_PRINT(minutes);
-      DEBUG_PRINTLN(" minutes ago");
+      DEBUG_PRINTLN(F(" minutes ago"));
     } else {
-      response = "Invalid format. Use: setall <minutes>\nExample: setall 60";
+      response = F("Invalid format. Use: setall <minutes>\nExample: setall 60");
     }
   }
-  else if (command.startsWith("setyellow ")) {
-    // Format: setyellow 150 (sets yellow threshold to 150 minutes)
+  else if (flashStartsWith(command.c_str(), PSTR("setyellow "))) {
+    // Format: setyellow 150 (sets yellow threshold to 150 minutes, same as set yellow 150)
     int minutes = command.substring(10).toInt();
-    if (minutes > 0 && minutes < 1440) {  // Max 24 hours
-      yellowThreshold = minutes;
-      response = "Yellow alert threshold set to " + String(minutes) + " minutes (until reboot)";
-      displayManager.showFeedback("Yellow Set", 1500);
+    if (minutes <= 0 || minutes >= 1440) {  // Max 24 hours
+      response = F("Invalid format. Use: setyellow <minutes> (1-1439)\nExample: setyellow 150");
+    } else if (runtimeConfig.set(CONFIG_YELLOW, minutes, response)) {
+      saveSettings();
+      response = F("Yellow alert threshold set to ");
+      response += minutes;
+      response += F(" minutes");
+      displayManager.showFeedback(F("Yellow Set"), 1500);
       commandRecognized = true;
-      DEBUG_PRINT("Yellow threshold set to ");
+      DEBUG_PRINT(F("Yellow threshold set to "));
       DEBUG_PRINT(minutes);
-      DEBUG_PRINTLN(" minutes");
-    } else {
-      response = "Invalid format. Use: setyellow <minutes> (1-1439)\nExample: setyellow 150";
+      DEBUG_PRINTLN(F(" minutes"));
     }
   }
-  else if (command.startsWith("setred ")) {
-    // Format: setred 240 (sets red threshold to 240 minutes)
+  else if (flashStartsWith(command.c_str(), PSTR("setred "))) {
+    // Format: setred 240 (sets red threshold to 240 minutes, same as set red 240)
     int minutes = command.substring(7).toInt();
-    if (minutes > 0 && minutes < 1440) {  // Max 24 hours
-      redThreshold = minutes;
-      response = "Red alert threshold set to " + String(minutes) + " minutes (until reboot)";
-      displayManager.showFeedback("Red Set", 1500);
+    if (minutes <= 0 || minutes >= 1440) {  // Max 24 hours
+      response = F("Invalid format. Use: setred <minutes> (1-1439)\nExample: setred 240");
+    } else if (runtimeConfig.set(CONFIG_RED, minutes, response)) {
+      saveSettings();
+      response = F("Red alert threshold set to ");
+      response += minutes;
+      response += F(" minutes");
+      displayManager.showFeedback(F("Red Set"), 1500);
       commandRecognized = true;
-      DEBUG_PRINT("Red threshold set to ");
+      DEBUG_PRINT(F("Red threshold set to "));
       DEBUG_PRINT(minutes);
-      DEBUG_PRINTLN(" minutes");
+      DEBUG_PRINTLN(F(" minutes"));
+    }
+  }
+  else if (flashEquals(command.c_str(), PSTR("config"))) {
+    response = runtimeConfig.getSummary();
+    commandRecognized = true;
+    DEBUG_PRINTLN(F("Config command executed"));
+  }
+  else if (flashEquals(command.c_str(), PSTR("config reset"))) {
+    runtimeConfig.reset();
+    saveSettings();
+    response = F("Settings reset to the config.h defaults");
+    displayManager.showFeedback(F("Config Reset"), 1500);
+    commandRecognized = true;
+    DEBUG_PRINTLN(F("Settings reset"));
+  }
+  else if (flashStartsWith(command.c_str(), PSTR("set "))) {
+    // Format: set quietstart 21 (any key listed by the config command)
+    if (runtimeConfig.set(command.c_str() + 4, response)) {
+      saveSettings();
+      displayManager.showFeedback(F("Setting Saved"), 1500);
+      commandRecognized = true;
+    }
+    DEBUG_PRINTLN(response);
+  }
+  else if (flashEquals(command.c_str(), PSTR("stats"))) {
+    response = pottyStats.getSummary();
+    commandRecognized = true;
+    DEBUG_PRINTLN(F("Stats command executed"));
+  }
+  else if (flashEquals(command.c_str(), PSTR("resetstats"))) {
+    pottyStats.reset();
+    saveToEEPROM();
+    response = F("Statistics cleared");
+    displayManager.showFeedback(F("Stats Reset"), 1500);
+    commandRecognized = true;
+    DEBUG_PRINTLN(F("Statistics cleared"));
+  }
+  else if (flashEquals(command.c_str(), PSTR("history"))) {
+    response = history.getTrendSummary();
+    commandRecognized = true;
+    DEBUG_PRINTLN(F("History command executed"));
+  }
+  else if (flashEquals(command.c_str(), PSTR("predict"))) {
+    PeePrediction prediction;
+    if (getPeePrediction(&prediction)) {
+      time_t expected = timerManager.getTimestamp(TIMER_PEE) + prediction.interval;
+      struct tm* timeinfo = localtime(&expected);
+      char buffer[96];
+      snprintf_P(buffer, sizeof(buffer), PSTR("Next pee expected around %d:%02d (+/-%lu min, %u%% confidence)"),
+               timeinfo->tm_hour, timeinfo->tm_min,
+               (unsigned long)(prediction.spread / 60), prediction.confidence);
+      response = buffer;
     } else {
-      response = "Invalid format. Use: setred <minutes> (1-1439)\nExample: setred 240";
+      response = F("Not enough data to predict yet");
+    }
+    char alerts[64];
+    snprintf_P(alerts, sizeof(alerts),
+               predictionActive ? PSTR("\nAlerts: yellow %u min, red %u min (predicted)")
+                                : PSTR("\nAlerts: yellow %u min, red %u min (static)"),
+               activeYellowThreshold, activeRedThreshold);
+    response += alerts;
+    commandRecognized = true;
+    DEBUG_PRINTLN(F("Predict command executed"));
+  }
+  else if (flashEquals(command.c_str(), PSTR("predict on")) || flashEquals(command.c_str(), PSTR("predict off"))) {
+    bool enable = flashEquals(command.c_str(), PSTR("predict on"));
+    if (runtimeConfig.set(CONFIG_PREDICT, enable ? 1 : 0, response)) {
+      saveSettings();
+      response = enable ? F("Predictive alerts enabled") : F("Predictive alerts disabled");
+      displayManager.showFeedback(enable ? F("Predict On") : F("Predict Off"), 1500);
+      commandRecognized = true;
     }
+    DEBUG_PRINTLN(response);
+  }
+  else if (flashEquals(command.c_str(), PSTR("update"))) {
+    response = otaUpdater.getStatus();
+    commandRecognized = true;
+    DEBUG_PRINTLN(F("Update status command executed"));
+  }
+  else if (flashStartsWith(command.c_str(), PSTR("update "))) {
+    // Format: update http://192.168.1.20:8000/dog-potty-tracker.ino.bin.gz <sha256> [<secret>]
+    String arguments = original.substring(original.indexOf(' ') + 1);
+    arguments.trim();
+    int space = arguments.indexOf(' ');
+    String sha256 = arguments.substring(space + 1);
+    String secret;
+    int secretSpace = sha256.indexOf(' ');
+    if (secretSpace >= 0) {
+      secret = sha256.substring(secretSpace + 1);
+      secret.trim();
+      sha256 = sha256.substring(0, secretSpace);
+    }
+    if (!OTA_ENABLED) {
+      response = F("OTA updates are disabled (OTA_ENABLED in config.h)");
+    } else if (space < 0) {
+      response = F("Invalid format. Use: update <url> <sha256>\nExample: update http://192.168.1.20:8000/dog-potty-tracker.ino.bin.gz 9f86d0...");
+    } else if (!trusted && strlen(OTA_SECRET) == 0) {
+      // The hash comes from the same caller, so it proves nothing about who built the image
+      response = F("Updates over the LAN need OTA_SECRET in secrets.h - use Telegram");
+    } else if (!trusted && !isOtaSecret(secret.c_str())) {
+      response = F("Wrong or missing secret. Use: update <url> <sha256> <secret>");
+    } else if (otaUpdater.start(arguments.substring(0, space).c_str(), sha256.c_str(), response)) {
+      otaProgressShown = 0;
+      response = F("Update started - check progress with: update");
+      displayManager.showFeedback(F("Updating..."), 3000);
+      commandRecognized = true;
+      DEBUG_PRINTLN(F("Firmware update started"));
+    }
+  }
+  else if (flashEquals(command.c_str(), PSTR("power"))) {
+    response = powerManager.getSummary();
+    commandRecognized = true;
+    DEBUG_PRINTLN(F("Power command executed"));
+  }
+  else if (flashEquals(command.c_str(), PSTR("resetpredict"))) {
+    peePredictor.reset();
+    saveToEEPROM();
+    response = F("Predictor model cleared");
+    displayManager.showFeedback(F("Predict Reset"), 1500);
+    commandRecognized = true;
+    DEBUG_PRINTLN(F("Predictor model cleared"));
   }
   // Note: /help command removed - set up commands via @BotFather instead (see secrets.h.example)
   // This avoids SSL connection failures and provides better UI in Telegram
 
-  // REPLIES DISABLED: ESP8266 hardware limitation
-  // The ESP8266 has only ~11KB free heap and cannot handle HTTPS polling + replies
-  // Even with 5+ second delays, the SSL/TLS stack remains exhausted (heap doesn't recover)
-  // Commands still execute successfully - verify via:
-  //   1. Display shows "Pee! (Remote)" or similar feedback
-  //   2. Timer values update on screen
-  //   3. EEPROM saves (check serial output)
-  //
-  // Alternative solutions:
-  //   - Upgrade to ESP32 (32KB+ heap, better SSL stack)
-  //   - Raspberry Pi Pico W (much more memory)
-  //   - Disable Telegram polling and only send alerts (no remote commands)
-  //   - Use MQTT instead of HTTPS for bidirectional communication
+  if (!commandRecognized && response.length() == 0) {
+    response = F("Unknown command: ");
+    response += command;
+  }
 
-  DEBUG_PRINT("Command executed successfully: ");
-  DEBUG_PRINTLN(response);
-  DEBUG_PRINTLN("(Reply disabled - ESP8266 SSL limitation)");
+  return commandRecognized;
 }
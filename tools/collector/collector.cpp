@@ -0,0 +1,661 @@
+// Event collector for a fleet of trackers (Linux).
+//
+// Ingests timer changes and stores them in an append-only columnar store that
+// can answer range and per-day aggregation queries over years of history.
+//
+// Ingestion uses the same 38-byte framing the trackers already speak
+// (PeerPacket from PeerProtocol.h, timer order as in PersistentData):
+//   - UDP: joins the peer sync multicast group (trackers need PEER_SYNC_ENABLED)
+//   - HTTP: POST /ingest with a body of concatenated packets (backfill/replay)
+// A row is stored whenever a tracker's write time for a timer changes, so
+// repeats and heartbeats do not create duplicates and missed updates are
+// recovered from the next heartbeat.
+//
+// Storage: one file per column in the data directory, appended in batches.
+//   node.col    uint32  tracker chip ID
+//   timer.col   uint8   0 = outside, 1 = pee, 2 = poop
+//   start.col   uint32  timer start time (Unix epoch)
+//   changed.col uint32  when the tracker wrote it (Unix epoch)
+// Rows are in arrival order; a per-block min/max of start times (built on open)
+// lets range queries skip blocks. A torn batch is trimmed to the shortest column.
+//
+// Build:
+//   g++ -std=c++17 -O2 -I../../dog-potty-tracker collector.cpp -o collector
+// Usage:
+//   ./collector serve <dir> [--http-port 8080] [--name <hexid>=<dog>]...
+//   ./collector daily <dir> [--timer pee] [--node <hexid>] [--from <epoch>] [--to <epoch>] [--tz <hours>]
+//   ./collector range <dir> [--timer pee] [--node <hexid>] [--from <epoch>] [--to <epoch>]
+//   ./collector bench [events] [nodes]
+
+#include "PeerProtocol.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <map>
+#include <netinet/in.h>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static const char* MULTICAST_GROUP = "239.255.42.99";
+static const uint16_t MULTICAST_PORT = 4210;
+static const size_t BLOCK_ROWS = 4096;       // Rows per zone-map block
+static const size_t BATCH_ROWS = 1024;       // Flush when this many rows are pending
+static const uint32_t BATCH_MAX_AGE_MS = 1000;  // ...or when the oldest pending row is this old
+static const char* TIMER_NAMES[3] = {"outside", "pee", "poop"};
+
+struct Row {
+  uint32_t node;
+  uint8_t timer;
+  uint32_t start;
+  uint32_t changed;
+};
+
+struct Filter {
+  int timer = -1;
+  uint32_t node = 0;
+  uint32_t from = 0;
+  uint32_t to = UINT32_MAX;
+};
+
+static uint64_t nowMs() {
+  using namespace std::chrono;
+  return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// Column store
+// ============================================================================
+
+class ColumnStore {
+public:
+  bool open(const std::string& directory) {
+    dir = directory;
+    mkdir(dir.c_str(), 0755);
+    if (!load("node.col", node) || !load("timer.col", timer) ||
+        !load("start.col", start) || !load("changed.col", changed)) {
+      return false;
+    }
+
+    // Trim a torn batch so every column has the same number of rows
+    size_t rows = std::min(std::min(node.size(), timer.size()), std::min(start.size(), changed.size()));
+    node.resize(rows);
+    timer.resize(rows);
+    start.resize(rows);
+    changed.resize(rows);
+    truncateTo("node.col", rows * sizeof(uint32_t));
+    truncateTo("timer.col", rows * sizeof(uint8_t));
+    truncateTo("start.col", rows * sizeof(uint32_t));
+    truncateTo("changed.col", rows * sizeof(uint32_t));
+
+    blockMin.clear();
+    blockMax.clear();
+    for (size_t i = 0; i < rows; i++) index(i);
+    flushedRows = rows;
+    return true;
+  }
+
+  void append(const Row& row) {
+    if (pendingRows() == 0) pendingSince = nowMs();
+    node.push_back(row.node);
+    timer.push_back(row.timer);
+    start.push_back(row.start);
+    changed.push_back(row.changed);
+    index(node.size() - 1);
+    if (pendingRows() >= BATCH_ROWS) flush();
+  }
+
+  void update() {
+    if (pendingRows() > 0 && nowMs() - pendingSince >= BATCH_MAX_AGE_MS) flush();
+  }
+
+  // Append pending rows to each column file
+  void flush() {
+    size_t count = pendingRows();
+    if (count == 0) return;
+    write("node.col", &node[flushedRows], count * sizeof(uint32_t));
+    write("timer.col", &timer[flushedRows], count * sizeof(uint8_t));
+    write("start.col", &start[flushedRows], count * sizeof(uint32_t));
+    write("changed.col", &changed[flushedRows], count * sizeof(uint32_t));
+    flushedRows = node.size();
+  }
+
+  size_t size() const {
+    return node.size();
+  }
+
+  Row row(size_t i) const {
+    return Row{node[i], timer[i], start[i], changed[i]};
+  }
+
+  // Visit rows matching the filter, skipping blocks outside the time range
+  template <typename Visitor>
+  void scan(const Filter& filter, Visitor visit) const {
+    for (size_t block = 0; block < blockMin.size(); block++) {
+      if (blockMax[block] < filter.from || blockMin[block] > filter.to) continue;
+      size_t end = std::min(node.size(), (block + 1) * BLOCK_ROWS);
+      for (size_t i = block * BLOCK_ROWS; i < end; i++) {
+        if (start[i] < filter.from || start[i] > filter.to) continue;
+        if (filter.timer >= 0 && timer[i] != filter.timer) continue;
+        if (filter.node != 0 && node[i] != filter.node) continue;
+        visit(i);
+      }
+    }
+  }
+
+  const std::vector<uint32_t>& startColumn() const { return start; }
+  const std::vector<uint32_t>& nodeColumn() const { return node; }
+
+private:
+  std::string dir;
+  std::vector<uint32_t> node;
+  std::vector<uint8_t> timer;
+  std::vector<uint32_t> start;
+  std::vector<uint32_t> changed;
+  std::vector<uint32_t> blockMin;
+  std::vector<uint32_t> blockMax;
+  size_t flushedRows = 0;
+  uint64_t pendingSince = 0;
+
+  size_t pendingRows() const {
+    return node.size() - flushedRows;
+  }
+
+  void index(size_t i) {
+    size_t block = i / BLOCK_ROWS;
+    if (block >= blockMin.size()) {
+      blockMin.push_back(start[i]);
+      blockMax.push_back(start[i]);
+    }
+    blockMin[block] = std::min(blockMin[block], start[i]);
+    blockMax[block] = std::max(blockMax[block], start[i]);
+  }
+
+  std::string path(const char* name) const {
+    return dir + "/" + name;
+  }
+
+  template <typename T>
+  bool load(const char* name, std::vector<T>& column) {
+    column.clear();
+    FILE* file = fopen(path(name).c_str(), "rb");
+    if (file == nullptr) return true;  // New store
+    fseek(file, 0, SEEK_END);
+    long bytes = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    column.resize(bytes / sizeof(T));
+    size_t got = fread(column.data(), sizeof(T), column.size(), file);
+    fclose(file);
+    if (got != column.size()) {
+      fprintf(stderr, "Failed to read %s\n", name);
+      return false;
+    }
+    return true;
+  }
+
+  void truncateTo(const char* name, size_t bytes) {
+    if (truncate(path(name).c_str(), bytes) != 0 && errno != ENOENT) {
+      perror(name);
+    }
+  }
+
+  void write(const char* name, const void* data, size_t bytes) {
+    int fd = ::open(path(name).c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0 || ::write(fd, data, bytes) != (ssize_t)bytes) {
+      perror(name);
+    }
+    if (fd >= 0) ::close(fd);
+  }
+};
+
+// ============================================================================
+// Ingestion
+// ============================================================================
+
+// Turns tracker state packets into rows, one per new (node, timer) write
+class Ingestor {
+public:
+  explicit Ingestor(ColumnStore& store) : store(store) {
+    // Resume from the newest write already stored for each tracker
+    for (size_t i = 0; i < store.size(); i++) {
+      Row row = store.row(i);
+      uint32_t& last = lastChanged[row.node][row.timer];
+      last = std::max(last, row.changed);
+    }
+  }
+
+  // Returns number of rows added
+  int ingest(const uint8_t* data, size_t length) {
+    if (length != sizeof(PeerPacket)) return 0;
+    PeerPacket packet;
+    memcpy(&packet, data, sizeof(packet));
+    if (packet.magic != PEER_MAGIC || packet.version != PEER_VERSION) return 0;
+
+    int added = 0;
+    auto& last = lastChanged[packet.nodeId];
+    for (uint8_t i = 0; i < 3; i++) {
+      if (packet.changedAt[i] == 0 || packet.changedAt[i] <= last[i]) continue;
+      last[i] = packet.changedAt[i];
+      store.append(Row{packet.nodeId, i, packet.timestamps[i], packet.changedAt[i]});
+      added++;
+    }
+    packets++;
+    return added;
+  }
+
+  uint64_t getPacketCount() const {
+    return packets;
+  }
+
+private:
+  struct Latest {
+    uint32_t value[3] = {0, 0, 0};
+    uint32_t& operator[](int i) { return value[i]; }
+  };
+
+  ColumnStore& store;
+  std::map<uint32_t, Latest> lastChanged;
+  uint64_t packets = 0;
+};
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+struct DailyStats {
+  uint32_t count = 0;
+  uint32_t intervals = 0;
+  uint64_t intervalTotal = 0;
+  uint32_t intervalMin = UINT32_MAX;
+  uint32_t intervalMax = 0;
+};
+
+// Intervals between consecutive events per tracker, grouped by local day of the later event
+static std::map<std::pair<uint32_t, int32_t>, DailyStats> dailyIntervals(const ColumnStore& store,
+                                                                        const Filter& filter,
+                                                                        int tzHours) {
+  std::map<uint32_t, std::vector<uint32_t>> perNode;
+  store.scan(filter, [&](size_t i) { perNode[store.nodeColumn()[i]].push_back(store.startColumn()[i]); });
+
+  std::map<std::pair<uint32_t, int32_t>, DailyStats> result;
+  for (auto& entry : perNode) {
+    std::vector<uint32_t>& times = entry.second;
+    std::sort(times.begin(), times.end());
+    times.erase(std::unique(times.begin(), times.end()), times.end());
+    for (size_t i = 0; i < times.size(); i++) {
+      int32_t day = (int32_t)(((int64_t)times[i] + tzHours * 3600) / 86400);
+      DailyStats& stats = result[{entry.first, day}];
+      stats.count++;
+      if (i == 0) continue;
+      uint32_t interval = times[i] - times[i - 1];
+      stats.intervals++;
+      stats.intervalTotal += interval;
+      stats.intervalMin = std::min(stats.intervalMin, interval);
+      stats.intervalMax = std::max(stats.intervalMax, interval);
+    }
+  }
+  return result;
+}
+
+static std::string formatDay(int32_t day) {
+  time_t t = (time_t)day * 86400;
+  char buffer[16];
+  strftime(buffer, sizeof(buffer), "%Y-%m-%d", gmtime(&t));
+  return buffer;
+}
+
+static std::map<uint32_t, std::string> names;
+
+static std::string nodeName(uint32_t node) {
+  auto it = names.find(node);
+  if (it != names.end()) return it->second;
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%06x", node);
+  return buffer;
+}
+
+static std::string dailyCsv(const ColumnStore& store, const Filter& filter, int tzHours) {
+  std::string out = "day,dog,count,mean_interval_min,min_interval_min,max_interval_min\n";
+  char line[160];
+  for (auto& entry : dailyIntervals(store, filter, tzHours)) {
+    const DailyStats& s = entry.second;
+    double mean = s.intervals ? s.intervalTotal / 60.0 / s.intervals : 0;
+    snprintf(line, sizeof(line), "%s,%s,%u,%.1f,%.1f,%.1f\n", formatDay(entry.first.second).c_str(),
+             nodeName(entry.first.first).c_str(), s.count, mean,
+             s.intervals ? s.intervalMin / 60.0 : 0, s.intervals ? s.intervalMax / 60.0 : 0);
+    out += line;
+  }
+  return out;
+}
+
+static std::string rangeCsv(const ColumnStore& store, const Filter& filter) {
+  std::string out = "start,dog,timer,changed\n";
+  char line[96];
+  store.scan(filter, [&](size_t i) {
+    Row row = store.row(i);
+    snprintf(line, sizeof(line), "%u,%s,%s,%u\n", row.start, nodeName(row.node).c_str(),
+             TIMER_NAMES[row.timer % 3], row.changed);
+    out += line;
+  });
+  return out;
+}
+
+// ============================================================================
+// Network
+// ============================================================================
+
+static int openMulticast() {
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  int on = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(MULTICAST_PORT);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(sock, (sockaddr*)&addr, sizeof(addr)) < 0) {
+    perror("udp bind");
+    return -1;
+  }
+
+  ip_mreq mreq = {};
+  inet_pton(AF_INET, MULTICAST_GROUP, &mreq.imr_multiaddr);
+  mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+  if (setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+    perror("multicast join");
+    return -1;
+  }
+  return sock;
+}
+
+static int openHttp(uint16_t port) {
+  int sock = socket(AF_INET, SOCK_STREAM, 0);
+  int on = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(sock, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(sock, 8) < 0) {
+    perror("http listen");
+    return -1;
+  }
+  return sock;
+}
+
+static std::string queryParam(const std::string& target, const char* key) {
+  std::string needle = std::string(key) + "=";
+  size_t query = target.find('?');
+  if (query == std::string::npos) return "";
+  size_t pos = query;
+  while ((pos = target.find(needle, pos + 1)) != std::string::npos) {
+    char before = target[pos - 1];
+    if (before != '?' && before != '&') continue;
+    size_t end = target.find('&', pos);
+    return target.substr(pos + needle.size(), end == std::string::npos ? std::string::npos : end - pos - needle.size());
+  }
+  return "";
+}
+
+static Filter filterFromQuery(const std::string& target) {
+  Filter filter;
+  std::string value;
+  if (!(value = queryParam(target, "node")).empty()) filter.node = strtoul(value.c_str(), nullptr, 16);
+  if (!(value = queryParam(target, "from")).empty()) filter.from = strtoul(value.c_str(), nullptr, 10);
+  if (!(value = queryParam(target, "to")).empty()) filter.to = strtoul(value.c_str(), nullptr, 10);
+  value = queryParam(target, "timer");
+  for (int i = 0; i < 3; i++) {
+    if (value == TIMER_NAMES[i]) filter.timer = i;
+  }
+  return filter;
+}
+
+static void sendResponse(int fd, int status, const char* reason, const std::string& body) {
+  char header[160];
+  int length = snprintf(header, sizeof(header),
+                        "HTTP/1.1 %d %s\r\nContent-Type: text/csv\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                        status, reason, body.size());
+  std::string response(header, length);
+  response += body;
+  size_t sent = 0;
+  while (sent < response.size()) {
+    ssize_t n = ::send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+    if (n <= 0) break;
+    sent += n;
+  }
+}
+
+// One request per connection; small enough that a blocking read is fine on a LAN
+static void handleHttp(int fd, ColumnStore& store, Ingestor& ingestor) {
+  std::string request;
+  char buffer[4096];
+  size_t headerEnd = std::string::npos;
+  size_t contentLength = 0;
+  timeval timeout = {2, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  while (true) {
+    ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+    if (n <= 0) break;
+    request.append(buffer, n);
+    if (headerEnd == std::string::npos && (headerEnd = request.find("\r\n\r\n")) != std::string::npos) {
+      std::string lower = request.substr(0, headerEnd);
+      std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+      size_t pos = lower.find("content-length:");
+      if (pos != std::string::npos) contentLength = strtoul(lower.c_str() + pos + 15, nullptr, 10);
+    }
+    if (headerEnd != std::string::npos && request.size() >= headerEnd + 4 + contentLength) break;
+  }
+  if (headerEnd == std::string::npos) return;
+
+  size_t space1 = request.find(' ');
+  size_t space2 = request.find(' ', space1 + 1);
+  std::string method = request.substr(0, space1);
+  std::string target = request.substr(space1 + 1, space2 - space1 - 1);
+  std::string route = target.substr(0, target.find('?'));
+
+  if (method == "POST" && route == "/ingest") {
+    const uint8_t* body = (const uint8_t*)request.data() + headerEnd + 4;
+    size_t length = std::min(contentLength, request.size() - headerEnd - 4);
+    int added = 0;
+    for (size_t offset = 0; offset + sizeof(PeerPacket) <= length; offset += sizeof(PeerPacket)) {
+      added += ingestor.ingest(body + offset, sizeof(PeerPacket));
+    }
+    store.flush();
+    sendResponse(fd, 200, "OK", "added," + std::to_string(added) + "\n");
+  } else if (method == "GET" && route == "/daily") {
+    std::string tz = queryParam(target, "tz");
+    Filter filter = filterFromQuery(target);
+    if (filter.timer < 0) filter.timer = 1;
+    sendResponse(fd, 200, "OK", dailyCsv(store, filter, atoi(tz.c_str())));
+  } else if (method == "GET" && route == "/range") {
+    sendResponse(fd, 200, "OK", rangeCsv(store, filterFromQuery(target)));
+  } else {
+    sendResponse(fd, 404, "Not Found", "routes,POST /ingest,GET /daily,GET /range\n");
+  }
+}
+
+static int serve(const std::string& dir, uint16_t httpPort) {
+  ColumnStore store;
+  if (!store.open(dir)) return 1;
+  Ingestor ingestor(store);
+  int udp = openMulticast();
+  int http = openHttp(httpPort);
+  if (udp < 0 || http < 0) return 1;
+  printf("Collector: %zu rows in %s, multicast %s:%u, http :%u\n", store.size(), dir.c_str(),
+         MULTICAST_GROUP, MULTICAST_PORT, httpPort);
+
+  while (true) {
+    pollfd fds[2] = {{udp, POLLIN, 0}, {http, POLLIN, 0}};
+    poll(fds, 2, 250);
+    if (fds[0].revents & POLLIN) {
+      uint8_t packet[256];
+      ssize_t length;
+      while ((length = recv(udp, packet, sizeof(packet), MSG_DONTWAIT)) > 0) {
+        ingestor.ingest(packet, (size_t)length);
+      }
+    }
+    if (fds[1].revents & POLLIN) {
+      int client = accept(http, nullptr, nullptr);
+      if (client >= 0) {
+        handleHttp(client, store, ingestor);
+        close(client);
+      }
+    }
+    store.update();
+  }
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+// Simulated packets from several trackers, ingested into a scratch store
+static int bench(size_t events, int nodes) {
+  char dir[] = "/tmp/collector-bench-XXXXXX";
+  if (mkdtemp(dir) == nullptr) {
+    perror("mkdtemp");
+    return 1;
+  }
+
+  std::mt19937 rng(42);
+  std::vector<PeerPacket> packets;
+  std::vector<uint32_t> clock(nodes, 1577836800);  // 2020-01-01
+  std::vector<PeerPacket> state(nodes);
+  for (int n = 0; n < nodes; n++) {
+    memset(&state[n], 0, sizeof(PeerPacket));
+    state[n].magic = PEER_MAGIC;
+    state[n].version = PEER_VERSION;
+    state[n].nodeId = 0x100000 + n;
+  }
+  packets.reserve(events * 2);
+  for (size_t i = 0; i < events; i++) {
+    int n = rng() % nodes;
+    PeerPacket& s = state[n];
+    clock[n] += 1800 + rng() % 14400;
+    uint8_t timer = rng() % 3;
+    s.type = PEER_TIMER_UPDATE;
+    s.timer = timer;
+    s.sequence++;
+    s.timestamps[timer] = clock[n];
+    s.changedAt[timer] = clock[n];
+    packets.push_back(s);
+    s.sequence++;
+    packets.push_back(s);  // Repeat, must not create a row
+  }
+
+  ColumnStore store;
+  store.open(dir);
+  Ingestor ingestor(store);
+  uint64_t begin = nowMs();
+  size_t rows = 0;
+  for (const PeerPacket& packet : packets) {
+    rows += ingestor.ingest((const uint8_t*)&packet, sizeof(packet));
+  }
+  store.flush();
+  double ingestSeconds = (nowMs() - begin) / 1000.0;
+
+  begin = nowMs();
+  ColumnStore reopened;
+  reopened.open(dir);
+  double openSeconds = (nowMs() - begin) / 1000.0;
+
+  Filter filter;
+  filter.timer = 1;
+  begin = nowMs();
+  size_t days = dailyIntervals(reopened, filter, 0).size();
+  double dailySeconds = (nowMs() - begin) / 1000.0;
+
+  filter.from = clock[0] - 86400 * 30;
+  size_t matched = 0;
+  begin = nowMs();
+  reopened.scan(filter, [&](size_t) { matched++; });
+  double rangeSeconds = (nowMs() - begin) / 1000.0;
+
+  printf("packets=%zu rows=%zu bytes_per_row=13\n", packets.size(), rows);
+  printf("ingest: %.3f s (%.0f packets/s)\n", ingestSeconds, packets.size() / std::max(ingestSeconds, 1e-6));
+  printf("open:   %.3f s\n", openSeconds);
+  printf("daily:  %.3f s (%zu dog-days)\n", dailySeconds, days);
+  printf("range:  %.3f s (%zu rows in last 30 days of first dog)\n", rangeSeconds, matched);
+
+  std::string cleanup = std::string("rm -rf ") + dir;
+  return system(cleanup.c_str()) == 0 && rows == events ? 0 : 1;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+static void usage() {
+  fprintf(stderr,
+          "usage: collector serve <dir> [--http-port N] [--name <hexid>=<dog>]...\n"
+          "       collector daily <dir> [--timer T] [--node ID] [--from E] [--to E] [--tz H]\n"
+          "       collector range <dir> [--timer T] [--node ID] [--from E] [--to E]\n"
+          "       collector bench [events] [nodes]\n");
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    usage();
+    return 2;
+  }
+  std::string command = argv[1];
+  if (command == "bench") {
+    size_t events = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+    int nodes = argc > 3 ? atoi(argv[3]) : 4;
+    return bench(events, nodes);
+  }
+  if (argc < 3) {
+    usage();
+    return 2;
+  }
+
+  std::string dir = argv[2];
+  Filter filter;
+  int tzHours = 0;
+  uint16_t httpPort = 8080;
+  for (int i = 3; i + 1 < argc; i += 2) {
+    std::string flag = argv[i];
+    std::string value = argv[i + 1];
+    if (flag == "--http-port") httpPort = (uint16_t)atoi(value.c_str());
+    else if (flag == "--node") filter.node = strtoul(value.c_str(), nullptr, 16);
+    else if (flag == "--from") filter.from = strtoul(value.c_str(), nullptr, 10);
+    else if (flag == "--to") filter.to = strtoul(value.c_str(), nullptr, 10);
+    else if (flag == "--tz") tzHours = atoi(value.c_str());
+    else if (flag == "--timer") {
+      for (int t = 0; t < 3; t++) {
+        if (value == TIMER_NAMES[t]) filter.timer = t;
+      }
+    } else if (flag == "--name") {
+      size_t eq = value.find('=');
+      if (eq != std::string::npos) names[strtoul(value.substr(0, eq).c_str(), nullptr, 16)] = value.substr(eq + 1);
+    }
+  }
+
+  if (command == "serve") return serve(dir, httpPort);
+
+  ColumnStore store;
+  if (!store.open(dir)) return 1;
+  if (command == "daily") {
+    if (filter.timer < 0) filter.timer = 1;
+    fputs(dailyCsv(store, filter, tzHours).c_str(), stdout);
+  } else if (command == "range") {
+    fputs(rangeCsv(store, filter).c_str(), stdout);
+  } else {
+    usage();
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,278 @@
+// Single-timer view benchmark: renders the mode 3 frame ("PEE", "12h 34m",
+// "At: 3:12 PM") into a 128x64 SSD1306 buffer the old way (Adafruit GFX print
+// with setTextSize(3), i.e. every lit pixel of the 5x7 font becomes a 3x3
+// fillRect split into vertical lines) and the new way (LargeFont glyphs copied
+// into the buffer column by column, label copied from the cache), and reports
+// CPU cycles per frame.
+//
+// The GFX path reproduces Adafruit_GFX::drawChar/fillRect and
+// Adafruit_SSD1306::drawFastVLine/drawPixel for the 180-degree rotation the
+// tracker uses. Cycles are read with rdtsc on x86 (time stamp counter, so they
+// scale with the host clock rather than the ESP8266's); elsewhere only
+// nanoseconds are shown.
+//
+// Build and run from this directory:
+//   g++ -std=c++17 -O2 -I../../dog-potty-tracker display_bench.cpp -o display_bench
+//   ./display_bench [iterations] [--show]
+
+#include "LargeFont.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#endif
+
+static const int WIDTH = 128;
+static const int HEIGHT = 64;
+static const int ROTATION = 2;
+
+static uint8_t buffer[WIDTH * HEIGHT / 8];
+
+// ---------------------------------------------------------------------------
+// Adafruit GFX + SSD1306 path
+// ---------------------------------------------------------------------------
+
+// Columns of the classic 5x7 GFX font for the characters used here (LSB = top)
+static const uint8_t* classicGlyph(char c) {
+  static const struct { char c; uint8_t columns[5]; } font[] = {
+    {' ', {0x00, 0x00, 0x00, 0x00, 0x00}}, {':', {0x00, 0x36, 0x36, 0x00, 0x00}},
+    {'0', {0x3E, 0x51, 0x49, 0x45, 0x3E}}, {'1', {0x00, 0x42, 0x7F, 0x40, 0x00}},
+    {'2', {0x72, 0x49, 0x49, 0x49, 0x46}}, {'3', {0x21, 0x41, 0x49, 0x4D, 0x33}},
+    {'4', {0x18, 0x14, 0x12, 0x7F, 0x10}}, {'5', {0x27, 0x45, 0x45, 0x45, 0x39}},
+    {'6', {0x3C, 0x4A, 0x49, 0x49, 0x31}}, {'7', {0x41, 0x21, 0x11, 0x09, 0x07}},
+    {'8', {0x36, 0x49, 0x49, 0x49, 0x36}}, {'9', {0x46, 0x49, 0x49, 0x29, 0x1E}},
+    {'A', {0x7C, 0x12, 0x11, 0x12, 0x7C}}, {'E', {0x7F, 0x49, 0x49, 0x49, 0x41}},
+    {'M', {0x7F, 0x02, 0x1C, 0x02, 0x7F}}, {'P', {0x7F, 0x09, 0x09, 0x09, 0x06}},
+    {'h', {0x7F, 0x08, 0x04, 0x04, 0x78}}, {'m', {0x7C, 0x04, 0x18, 0x04, 0x78}},
+    {'t', {0x04, 0x3F, 0x44, 0x40, 0x20}},
+  };
+  for (const auto& glyph : font) {
+    if (glyph.c == c) {
+      return glyph.columns;
+    }
+  }
+  return font[0].columns;
+}
+
+// Adafruit_SSD1306::drawPixel (WHITE)
+__attribute__((noinline)) static void drawPixel(int16_t x, int16_t y) {
+  if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) {
+    return;
+  }
+  if (ROTATION == 2) {
+    x = WIDTH - x - 1;
+    y = HEIGHT - y - 1;
+  }
+  buffer[x + (y / 8) * WIDTH] |= (1 << (y & 7));
+}
+
+// Adafruit_SSD1306::drawFastVLineInternal (WHITE)
+static void drawFastVLineInternal(int16_t x, int16_t yStart, int16_t hStart) {
+  if (x < 0 || x >= WIDTH) {
+    return;
+  }
+  if (yStart < 0) {
+    hStart += yStart;
+    yStart = 0;
+  }
+  if (yStart + hStart > HEIGHT) {
+    hStart = HEIGHT - yStart;
+  }
+  if (hStart <= 0) {
+    return;
+  }
+  uint8_t y = yStart;
+  uint8_t h = hStart;
+  uint8_t* pBuf = &buffer[(y / 8) * WIDTH + x];
+
+  uint8_t mod = (y & 7);
+  if (mod) {
+    mod = 8 - mod;
+    static const uint8_t premask[8] = {0x00, 0x80, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC, 0xFE};
+    uint8_t mask = premask[mod];
+    if (h < mod) {
+      mask &= (0xFF >> (mod - h));
+    }
+    *pBuf |= mask;
+    if (h < mod) {
+      return;
+    }
+    h -= mod;
+    pBuf += WIDTH;
+  }
+
+  if (h >= 8) {
+    do {
+      *pBuf = 0xFF;
+      pBuf += WIDTH;
+      h -= 8;
+    } while (h >= 8);
+  }
+
+  if (h) {
+    static const uint8_t postmask[8] = {0x00, 0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F};
+    *pBuf |= postmask[h & 7];
+  }
+}
+
+// Adafruit_SSD1306::drawFastVLine (virtual in the library)
+__attribute__((noinline)) static void drawFastVLine(int16_t x, int16_t y, int16_t h) {
+  if (ROTATION == 2) {
+    x = WIDTH - x - 1;
+    y = HEIGHT - y - h;
+  }
+  drawFastVLineInternal(x, y, h);
+}
+
+// Adafruit_GFX::fillRect
+__attribute__((noinline)) static void fillRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+  for (int16_t i = x; i < x + w; i++) {
+    drawFastVLine(i, y, h);
+  }
+}
+
+// Adafruit_GFX::drawChar (classic font, transparent background)
+static void drawChar(int16_t x, int16_t y, char c, uint8_t size) {
+  if ((x >= WIDTH) || (y >= HEIGHT) || ((x + 6 * size - 1) < 0) || ((y + 8 * size - 1) < 0)) {
+    return;
+  }
+  const uint8_t* columns = classicGlyph(c);
+  for (int8_t i = 0; i < 5; i++) {
+    uint8_t line = columns[i];
+    for (int8_t j = 0; j < 8; j++, line >>= 1) {
+      if (line & 1) {
+        if (size == 1) {
+          drawPixel(x + i, y + j);
+        } else {
+          fillRect(x + i * size, y + j * size, size, size);
+        }
+      }
+    }
+  }
+}
+
+// Adafruit_GFX::print at a cursor position
+static void gfxPrint(int16_t x, int16_t y, uint8_t size, const char* text) {
+  for (; *text != '\0'; text++) {
+    drawChar(x, y, *text, size);
+    x += 6 * size;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Frames
+// ---------------------------------------------------------------------------
+
+static const char* LABEL = "PEE";
+static const char* ELAPSED = "12h 34m";
+static const char* TIMESTAMP = "At: 3:12 PM";
+
+static void renderOld() {
+  memset(buffer, 0, sizeof(buffer));
+  gfxPrint(0, 0, 1, LABEL);
+  gfxPrint(0, 12, 3, ELAPSED);
+  gfxPrint(0, 56, 1, TIMESTAMP);
+}
+
+static uint8_t labelCache[48];
+
+static void fillLabelCache() {
+  memset(buffer, 0, sizeof(buffer));
+  gfxPrint(0, 0, 1, LABEL);
+  for (int x = 0; x < 48; x++) {
+    labelCache[x] = buffer[LargeFont::bufferIndex(WIDTH, HEIGHT, x, 0, true)];
+  }
+}
+
+static void renderNew() {
+  memset(buffer, 0, sizeof(buffer));
+  for (int x = 0; x < 48; x++) {
+    buffer[LargeFont::bufferIndex(WIDTH, HEIGHT, x, 0, true)] = labelCache[x];
+  }
+  int x = (WIDTH - LargeFont::measure(ELAPSED)) / 2;
+  LargeFont::draw(buffer, WIDTH, HEIGHT, x < 0 ? 0 : x, 2, ELAPSED, true);
+  gfxPrint(0, 56, 1, TIMESTAMP);
+}
+
+// Elapsed text only, without clearing and the small lines
+static void renderOldText() {
+  gfxPrint(0, 12, 3, ELAPSED);
+}
+
+static void renderNewText() {
+  LargeFont::draw(buffer, WIDTH, HEIGHT, 5, 2, ELAPSED, true);
+}
+
+// Print the buffer as the viewer sees it (undoing the 180-degree rotation)
+static void show(const char* title) {
+  printf("%s\n", title);
+  for (int y = HEIGHT - 1; y >= 0; y--) {
+    char line[WIDTH + 1];
+    for (int x = WIDTH - 1; x >= 0; x--) {
+      line[WIDTH - 1 - x] = (buffer[x + (y / 8) * WIDTH] >> (y & 7)) & 1 ? '#' : '.';
+    }
+    line[WIDTH] = '\0';
+    printf("  %s\n", line);
+  }
+  printf("\n");
+}
+
+static uint64_t readCycles() {
+#ifdef HAVE_RDTSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+static void run(const char* name, int iterations, void (*render)()) {
+  render();
+  uint64_t startCycles = readCycles();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    render();
+    __asm__ __volatile__("" : : "r"(buffer) : "memory");
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  uint64_t cycles = readCycles() - startCycles;
+  double nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+#ifdef HAVE_RDTSC
+  printf("  %-34s %8.0f cycles  %8.0f ns\n", name, (double)cycles / iterations, nanoseconds);
+#else
+  printf("  %-34s %8.0f ns\n", name, nanoseconds);
+#endif
+}
+
+int main(int argc, char** argv) {
+  int iterations = 100000;
+  bool showFrames = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--show") == 0) {
+      showFrames = true;
+    } else if (atoi(argv[i]) > 0) {
+      iterations = atoi(argv[i]);
+    }
+  }
+
+  fillLabelCache();
+
+  if (showFrames) {
+    renderOld();
+    show("GFX setTextSize(3):");
+    renderNew();
+    show("LargeFont:");
+  }
+
+  printf("%d iterations, \"%s\" / \"%s\" / \"%s\"\n\n", iterations, LABEL, ELAPSED, TIMESTAMP);
+  printf("Full frame (clear, label, elapsed, timestamp)\n");
+  run("GFX print, size 3", iterations, renderOld);
+  run("LargeFont blit + cached label", iterations, renderNew);
+  printf("\nElapsed text only\n");
+  run("GFX print, size 3", iterations, renderOldText);
+  run("LargeFont blit", iterations, renderNewText);
+  return 0;
+}
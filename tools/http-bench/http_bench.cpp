@@ -0,0 +1,326 @@
+// Outgoing request benchmark: composes the Telegram sendMessage and getUpdates
+// requests the tracker sends, once the way the old HTTPClient path did it (URL
+// String built by concatenation, urlencode() into a second String, the URL
+// parsed back into host/uri Strings, then the request header String) and once
+// through HttpRequestWriter (the same header the tracker includes), and reports
+// heap allocations, bytes allocated and time per request.
+//
+// The old path is modelled with a String that behaves like the ESP8266 core's
+// WString (11-byte small-string buffer, exact-size realloc on every growth), so
+// the allocation counts match what the device did. Both variants copy their
+// output into the same 2 KB sink, standing in for the TCP send buffer.
+//
+// Build and run from this directory:
+//   g++ -std=c++17 -O2 -I../../dog-potty-tracker http_bench.cpp -o http_bench
+//   ./http_bench [iterations]
+
+#include "HttpRequestWriter.h"
+
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+static unsigned long allocCount = 0;
+static unsigned long allocBytes = 0;
+
+void* operator new(size_t size) {
+  allocCount++;
+  allocBytes += size;
+  void* block = malloc(size);
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  return block;
+}
+
+void operator delete(void* block) noexcept {
+  free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+  free(block);
+}
+
+// ---------------------------------------------------------------------------
+// Old path
+// ---------------------------------------------------------------------------
+
+// Allocation behaviour of the core's String: short strings live inline, longer
+// ones get a heap buffer reallocated to the exact new length on each append
+class CoreString {
+public:
+  CoreString() : heap(nullptr), capacity(SSO_SIZE - 1), length(0) {
+    inline_[0] = '\0';
+  }
+
+  CoreString(const char* text) : CoreString() {
+    concat(text, strlen(text));
+  }
+
+  CoreString(const CoreString& other) : CoreString() {
+    concat(other.c_str(), other.length);
+  }
+
+  ~CoreString() {
+    free(heap);
+  }
+
+  CoreString& operator=(const CoreString&) = delete;
+
+  void reserve(size_t size) {
+    if (size > capacity) {
+      changeBuffer(size);
+    }
+  }
+
+  void concat(const char* text, size_t count) {
+    reserve(length + count);
+    memcpy(buffer() + length, text, count);
+    length += count;
+    buffer()[length] = '\0';
+  }
+
+  CoreString& operator+=(const char* text) {
+    concat(text, strlen(text));
+    return *this;
+  }
+
+  CoreString& operator+=(const CoreString& other) {
+    concat(other.c_str(), other.length);
+    return *this;
+  }
+
+  CoreString& operator+=(char c) {
+    concat(&c, 1);
+    return *this;
+  }
+
+  CoreString substring(size_t from, size_t to) const {
+    CoreString result;
+    result.concat(c_str() + from, to - from);
+    return result;
+  }
+
+  int indexOf(const char* text) const {
+    const char* found = strstr(c_str(), text);
+    return found == nullptr ? -1 : (int)(found - c_str());
+  }
+
+  int indexOf(char c, size_t from) const {
+    const char* found = strchr(c_str() + from, c);
+    return found == nullptr ? -1 : (int)(found - c_str());
+  }
+
+  const char* c_str() const {
+    return heap != nullptr ? heap : inline_;
+  }
+
+  size_t size() const {
+    return length;
+  }
+
+private:
+  static const size_t SSO_SIZE = 12;
+
+  char inline_[SSO_SIZE];
+  char* heap;
+  size_t capacity;
+  size_t length;
+
+  char* buffer() {
+    return heap != nullptr ? heap : inline_;
+  }
+
+  void changeBuffer(size_t size) {
+    bool wasInline = heap == nullptr;
+    char* block = (char*)realloc(heap, size + 1);
+    allocCount++;
+    allocBytes += size + 1;
+    if (wasInline) {
+      memcpy(block, inline_, length + 1);
+    }
+    heap = block;
+    capacity = size;
+  }
+};
+
+static CoreString fromNumber(unsigned long value) {
+  char digits[11];
+  snprintf(digits, sizeof(digits), "%lu", value);
+  return CoreString(digits);
+}
+
+// WiFiManager::urlencode() as it was
+static CoreString urlencode(const char* str) {
+  CoreString encoded = "";
+  char c;
+  char code0;
+  char code1;
+
+  for (size_t i = 0; i < strlen(str); i++) {
+    c = str[i];
+    if (c == ' ') {
+      encoded += '+';
+    } else if (isalnum((unsigned char)c)) {
+      encoded += c;
+    } else {
+      code1 = (c & 0xf) + '0';
+      if ((c & 0xf) > 9) {
+        code1 = (c & 0xf) - 10 + 'A';
+      }
+      c = (c >> 4) & 0xf;
+      code0 = c + '0';
+      if (c > 9) {
+        code0 = c - 10 + 'A';
+      }
+      encoded += '%';
+      encoded += code0;
+      encoded += code1;
+    }
+  }
+  return encoded;
+}
+
+struct Sink {
+  char data[2048];
+  size_t length;
+
+  size_t write(const uint8_t* bytes, size_t count) {
+    if (count > sizeof(data) - length) {
+      count = sizeof(data) - length;
+    }
+    memcpy(data + length, bytes, count);
+    length += count;
+    return count;
+  }
+};
+
+// HTTPClient::begin(url) splitting the URL, then sendHeader() building the
+// request header in one reserved String and writing it out
+static size_t sendWithHttpClient(Sink& sink, const CoreString& url) {
+  CoreString rest = url;
+  int index = rest.indexOf("://");
+  CoreString protocol = rest.substring(0, index);
+  CoreString hostAndPath = rest.substring(index + 3, rest.size());
+  int slash = hostAndPath.indexOf('/', 0);
+  CoreString host = hostAndPath.substring(0, slash);
+  CoreString uri = hostAndPath.substring(slash, hostAndPath.size());
+  CoreString userAgent = "ESP8266HTTPClient";
+
+  CoreString header;
+  header.reserve(uri.size() + host.size() + userAgent.size() + 128);
+  header += "GET ";
+  header += uri;
+  header += " HTTP/1.1\r\nHost: ";
+  header += host;
+  header += "\r\nUser-Agent: ";
+  header += userAgent;
+  header += "\r\nConnection: keep-alive\r\n"
+            "Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n\r\n";
+  return sink.write((const uint8_t*)header.c_str(), header.size());
+}
+
+static size_t oldSendMessage(Sink& sink, const char* token, const char* chatId, const char* message) {
+  CoreString url = "https://api.telegram.org/bot";
+  url += token;
+  url += "/sendMessage?chat_id=";
+  url += chatId;
+  url += "&text=";
+  url += urlencode(message);
+  return sendWithHttpClient(sink, url);
+}
+
+static size_t oldGetUpdates(Sink& sink, const char* token, unsigned long offset) {
+  CoreString url = "https://api.telegram.org/bot";
+  url += token;
+  url += "/getUpdates?offset=";
+  url += fromNumber(offset);
+  url += "&timeout=0";
+  return sendWithHttpClient(sink, url);
+}
+
+// ---------------------------------------------------------------------------
+// New path - the same calls WiFiManager makes
+// ---------------------------------------------------------------------------
+
+static size_t newSendMessage(Sink& sink, const char* token, const char* chatId, const char* message) {
+  HttpRequestWriter<Sink> request(sink);
+  request.begin(PSTR("GET"), PSTR("/bot"));
+  request.addPath(token);
+  request.addPath_P(PSTR("/sendMessage"));
+  request.addQuery(PSTR("chat_id"), chatId);
+  request.addQuery(PSTR("text"), message);
+  request.end("api.telegram.org", true);
+  return request.getWritten();
+}
+
+static size_t newGetUpdates(Sink& sink, const char* token, unsigned long offset) {
+  HttpRequestWriter<Sink> request(sink);
+  request.begin(PSTR("GET"), PSTR("/bot"));
+  request.addPath(token);
+  request.addPath_P(PSTR("/getUpdates"));
+  request.addQuery(PSTR("offset"), offset);
+  request.addQuery(PSTR("limit"), 1UL);
+  request.addQuery(PSTR("timeout"), 0UL);
+  request.end("api.telegram.org", true);
+  return request.getWritten();
+}
+
+// ---------------------------------------------------------------------------
+
+static const char* TOKEN = "1234567890:AAHk3-9fQzXcVbNmLpOiUyTrEwQaSdFgHjK";
+static const char* CHAT_ID = "-1001234567890";
+static const char* SHORT_MESSAGE = "Rex peed at 3:12 PM";
+static const char* DIGEST_MESSAGE =
+  "Rex peed and pooped between 2:58 PM and 3:12 PM (2x) (+3 earlier) - "
+  "last outside 47 min ago, next pee expected around 5:40 PM";
+
+template <typename Compose>
+static void run(const char* name, int iterations, Compose compose) {
+  static Sink sink;
+
+  // One untimed pass for the per-request figures
+  sink.length = 0;
+  unsigned long startCount = allocCount;
+  unsigned long startBytes = allocBytes;
+  size_t bytes = compose(sink);
+  unsigned long count = allocCount - startCount;
+  unsigned long allocated = allocBytes - startBytes;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    sink.length = 0;
+    bytes = compose(sink);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  double nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+
+  printf("  %-26s %5zu B sent  %3lu allocs  %5lu B allocated  %7.0f ns\n",
+         name, bytes, count, allocated, nanoseconds);
+}
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 200000;
+  if (iterations <= 0) {
+    iterations = 200000;
+  }
+
+  printf("%d iterations per case\n\n", iterations);
+
+  printf("sendMessage, %zu-char message\n", strlen(SHORT_MESSAGE));
+  run("String + HTTPClient", iterations, [](Sink& s) { return oldSendMessage(s, TOKEN, CHAT_ID, SHORT_MESSAGE); });
+  run("HttpRequestWriter", iterations, [](Sink& s) { return newSendMessage(s, TOKEN, CHAT_ID, SHORT_MESSAGE); });
+
+  printf("\nsendMessage, %zu-char digest\n", strlen(DIGEST_MESSAGE));
+  run("String + HTTPClient", iterations, [](Sink& s) { return oldSendMessage(s, TOKEN, CHAT_ID, DIGEST_MESSAGE); });
+  run("HttpRequestWriter", iterations, [](Sink& s) { return newSendMessage(s, TOKEN, CHAT_ID, DIGEST_MESSAGE); });
+
+  printf("\ngetUpdates\n");
+  run("String + HTTPClient", iterations, [](Sink& s) { return oldGetUpdates(s, TOKEN, 123456789UL); });
+  run("HttpRequestWriter", iterations, [](Sink& s) { return newGetUpdates(s, TOKEN, 123456789UL); });
+
+  return 0;
+}
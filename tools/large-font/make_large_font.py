@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# Generates dog-potty-tracker/LargeFontData.h: the digits and "h"/"m" of the
+# large single-timer view, 24 pixels tall, pre-packed in SSD1306 page order
+# (one byte = 8 vertical pixels, least significant bit on top) so the tracker
+# can copy them into the display buffer column by column.
+#
+# Glyphs are rendered from DejaVu Sans Bold at 8x resolution, narrowed so
+# "123h 45m" still fits the 128-pixel display, and thresholded.
+#
+# Requires Pillow:
+#   pip install pillow
+#   ./make_large_font.py [path/to/DejaVuSans-Bold.ttf] > ../../dog-potty-tracker/LargeFontData.h
+
+import sys
+from PIL import Image, ImageDraw, ImageFont
+
+HEIGHT = 24           # Rows (3 display pages)
+DIGIT_WIDTH = 14      # All digits share one width so the text does not jitter
+SCALE = 8             # Supersampling factor
+THRESHOLD = 110       # 0-255 coverage needed to light a pixel
+CHARS = "0123456789hm"
+
+font_path = sys.argv[1] if len(sys.argv) > 1 else "/usr/share/fonts/truetype/dejavu/DejaVuSans-Bold.ttf"
+
+# Size the font so the ascender of "h" fills the full height
+probe = ImageFont.truetype(font_path, 100 * SCALE)
+top = probe.getbbox("h")[1]
+bottom = probe.getbbox("0")[3]
+size = int(100 * SCALE * HEIGHT * SCALE / (bottom - top))
+font = ImageFont.truetype(font_path, size)
+top = font.getbbox("h")[1]
+
+
+def rasterize(char):
+    # Supersampled glyph cropped to its ink, top aligned to the ascender of "h"
+    image = Image.new("L", (font.size * 2, font.size * 2), 0)
+    ImageDraw.Draw(image).text((font.size // 2, font.size // 2), char, font=font, fill=255)
+    left, _, right, _ = image.getbbox()
+    return image.crop((left, font.size // 2 + top, right, font.size // 2 + top + HEIGHT * SCALE))
+
+
+# Horizontal squeeze that makes the widest digit DIGIT_WIDTH pixels
+digit_ink = max(rasterize(c).width for c in "0123456789")
+squeeze = DIGIT_WIDTH * SCALE / digit_ink
+
+
+def render(char):
+    glyph = rasterize(char)
+    if char.isdigit():
+        # Center narrow digits ("1") in the shared width
+        width = DIGIT_WIDTH
+        canvas = Image.new("L", (digit_ink, HEIGHT * SCALE), 0)
+        canvas.paste(glyph, ((digit_ink - glyph.width) // 2, 0))
+        glyph = canvas
+    else:
+        width = max(1, round(glyph.width * squeeze / SCALE))
+    image = glyph.resize((width, HEIGHT), Image.BOX)
+    pixels = image.load()
+    rows = [[pixels[x, y] >= THRESHOLD for x in range(width)] for y in range(HEIGHT)]
+    return width, rows
+
+
+def pack(width, rows):
+    data = []
+    for page in range(HEIGHT // 8):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                if rows[page * 8 + bit][x]:
+                    byte |= 1 << bit
+            data.append(byte)
+    return data
+
+
+out = sys.stdout
+out.write("#ifndef LARGE_FONT_DATA_H\n#define LARGE_FONT_DATA_H\n\n")
+out.write("// Generated by tools/large-font/make_large_font.py - do not edit\n")
+out.write("// Glyph bytes are page by page (top page first), one byte per column, LSB = top row\n\n")
+out.write("#define LARGE_FONT_HEIGHT %d\n" % HEIGHT)
+out.write("#define LARGE_FONT_PAGES %d\n" % (HEIGHT // 8))
+out.write("#define LARGE_FONT_CHARS \"%s\"\n\n" % CHARS)
+
+widths = []
+offsets = []
+out.write("static const uint8_t LARGE_FONT_BITMAPS[] PROGMEM = {\n")
+position = 0
+for char in CHARS:
+    width, rows = render(char)
+    data = pack(width, rows)
+    widths.append(width)
+    offsets.append(position)
+    position += len(data)
+    out.write("  // '%s'\n" % char)
+    for y in range(HEIGHT):
+        out.write("  //   %s\n" % "".join("#" if rows[y][x] else "." for x in range(width)).rstrip())
+    for i in range(0, len(data), 16):
+        out.write("  " + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",\n")
+out.write("};\n\n")
+
+out.write("static const uint8_t LARGE_FONT_WIDTHS[] PROGMEM = {%s};\n" % ", ".join(str(w) for w in widths))
+out.write("static const uint16_t LARGE_FONT_OFFSETS[] PROGMEM = {%s};\n\n" % ", ".join(str(o) for o in offsets))
+out.write("#endif\n")
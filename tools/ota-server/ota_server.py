@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+# Serves a firmware image to trackers on the LAN for an OTA update (OtaUpdater pulls it
+# over HTTP with Range requests, so a dropped connection resumes where it stopped).
+#
+# A raw .bin is gzip-compressed before serving (the ESP8266 bootloader unpacks gzip
+# images); the transfer and the flash writes to the update partition shrink by the
+# compression ratio, which is printed at startup. The SHA-256 printed (and sent) is
+# that of the file as served.
+#
+#   arduino-cli compile --fqbn esp8266:esp8266:d1_mini --output-dir build dog-potty-tracker
+#   ./ota_server.py build/dog-potty-tracker.ino.bin                   # Print the update command
+#   ./ota_server.py build/dog-potty-tracker.ino.bin --device 192.168.1.50 --secret <OTA_SECRET>  # ...and start it
+#   ./ota_server.py image.bin --drop-after 65536   # Cut every response short (tests resuming)
+
+import argparse
+import gzip
+import hashlib
+import http.server
+import os
+import re
+import socket
+import sys
+import urllib.parse
+import urllib.request
+
+
+def local_address(towards):
+    # Address of the interface that routes to the tracker (nothing is sent)
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as probe:
+        probe.connect((towards, 80))
+        return probe.getsockname()[0]
+
+
+def make_handler(name, image, drop_after):
+    class Handler(http.server.BaseHTTPRequestHandler):
+        def do_HEAD(self):
+            self.respond(send_body=False)
+
+        def do_GET(self):
+            self.respond(send_body=True)
+
+        def respond(self, send_body):
+            if urllib.parse.urlparse(self.path).path != "/" + name:
+                self.send_error(404)
+                return
+
+            start = 0
+            status = 200
+            match = re.match(r"bytes=(\d+)-$", self.headers.get("Range", ""))
+            if match:
+                start = int(match.group(1))
+                if start >= len(image):
+                    self.send_error(416)
+                    return
+                status = 206
+
+            self.send_response(status)
+            self.send_header("Content-Type", "application/octet-stream")
+            self.send_header("Content-Length", str(len(image) - start))
+            self.send_header("Accept-Ranges", "bytes")
+            if status == 206:
+                self.send_header("Content-Range", "bytes %d-%d/%d" % (start, len(image) - 1, len(image)))
+            self.end_headers()
+            if not send_body:
+                return
+
+            end = len(image)
+            if drop_after is not None:
+                end = min(end, start + drop_after)
+            try:
+                self.wfile.write(image[start:end])
+            except (BrokenPipeError, ConnectionResetError):
+                return
+            if end < len(image):
+                self.log_message("dropped the connection at byte %d of %d", end, len(image))
+                self.close_connection = True
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Serve a firmware image for OTA updates")
+    parser.add_argument("image", help="Firmware .bin (compressed here) or .bin.gz")
+    parser.add_argument("--port", type=int, default=8000)
+    parser.add_argument("--no-gzip", action="store_true", help="Serve a raw .bin as it is")
+    parser.add_argument("--device", help="Tracker address - start the update through its HTTP API")
+    parser.add_argument("--host", help="Address the tracker reaches this machine on (default: guessed)")
+    parser.add_argument("--secret", help="OTA_SECRET from secrets.h (required by the HTTP API)")
+    parser.add_argument("--drop-after", type=int, help="Close each response after this many bytes")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as source:
+        image = source.read()
+    name = os.path.basename(args.image)
+    raw_size = len(image)
+    if image[:2] != b"\x1f\x8b" and not args.no_gzip:
+        image = gzip.compress(image, compresslevel=9, mtime=0)
+        name += ".gz"
+        print("%s: %d bytes, gzip %d bytes (%.0f%% less to transfer and write)"
+              % (os.path.basename(args.image), raw_size, len(image), 100.0 * (raw_size - len(image)) / raw_size))
+    else:
+        print("%s: %d bytes" % (name, raw_size))
+
+    host = args.host or local_address(args.device or "192.168.0.1")
+    url = "http://%s:%d/%s" % (host, args.port, name)
+    sha256 = hashlib.sha256(image).hexdigest()
+    command = "update %s %s" % (url, sha256)
+    print("SHA-256 %s" % sha256)
+    print("Command: %s" % command)
+    if args.secret:
+        command += " " + args.secret
+
+    server = http.server.ThreadingHTTPServer(("", args.port), make_handler(name, image, args.drop_after))
+
+    if args.device:
+        if not args.secret:
+            sys.exit("--device needs --secret (the tracker only takes updates over HTTP with OTA_SECRET)")
+        data = urllib.parse.urlencode({"cmd": command}).encode()
+        try:
+            with urllib.request.urlopen("http://%s/commands" % args.device, data=data, timeout=10) as reply:
+                print("Tracker: %s" % reply.read().decode(errors="replace"))
+        except OSError as error:
+            sys.exit("Could not reach the tracker: %s" % error)
+
+    print("Serving on port %d (Ctrl+C to stop)" % args.port)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,177 @@
+// Peer sync simulator: runs several PeerState nodes on loopback UDP multicast
+// and checks that timer presses converge on every node and exactly one leader
+// is elected (including failover when the leader goes away).
+//
+// Build and run from this directory:
+//   g++ -std=c++17 -O2 -I../../dog-potty-tracker peer_sim.cpp -o peer_sim
+//   ./peer_sim [nodes] [presses]
+
+#define PEER_NODE_TIMEOUT 3000  // Shorter than on the device so failover is quick
+#include "PeerProtocol.h"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <poll.h>
+#include <random>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+static const char* GROUP = "239.255.42.99";
+static const uint16_t PORT = 4210;
+static const uint32_t HEARTBEAT_MS = 1000;
+
+struct Node {
+  PeerState state;
+  int sock = -1;
+  bool alive = true;
+  uint32_t lastHeartbeat = 0;
+};
+
+static uint32_t nowMs() {
+  using namespace std::chrono;
+  static const auto start = steady_clock::now();
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now() - start).count() + 1;
+}
+
+static int openSocket() {
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  int on = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(PORT);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(sock, (sockaddr*)&addr, sizeof(addr)) < 0) {
+    perror("bind");
+    exit(1);
+  }
+
+  ip_mreq mreq = {};
+  inet_pton(AF_INET, GROUP, &mreq.imr_multiaddr);
+  inet_pton(AF_INET, "127.0.0.1", &mreq.imr_interface);
+  if (setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+    perror("IP_ADD_MEMBERSHIP (is multicast allowed on lo?)");
+    exit(1);
+  }
+
+  in_addr iface;
+  inet_pton(AF_INET, "127.0.0.1", &iface);
+  setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface));
+  unsigned char loop = 1;
+  setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+  return sock;
+}
+
+static void sendPacket(Node& node, uint8_t type, uint8_t timer) {
+  PeerPacket packet;
+  node.state.buildPacket(&packet, type, timer);
+  sockaddr_in dest = {};
+  dest.sin_family = AF_INET;
+  dest.sin_port = htons(PORT);
+  inet_pton(AF_INET, GROUP, &dest.sin_addr);
+  sendto(node.sock, &packet, sizeof(packet), 0, (sockaddr*)&dest, sizeof(dest));
+}
+
+// Receive everything pending and run heartbeats for a while
+static void pump(std::vector<Node>& nodes, uint32_t durationMs) {
+  uint32_t end = nowMs() + durationMs;
+  while (nowMs() < end) {
+    for (auto& node : nodes) {
+      if (!node.alive) continue;
+      pollfd pfd = {node.sock, POLLIN, 0};
+      while (poll(&pfd, 1, 0) > 0) {
+        uint8_t buffer[256];
+        ssize_t length = recv(node.sock, buffer, sizeof(buffer), 0);
+        if (length > 0) node.state.merge(buffer, (size_t)length, nowMs());
+      }
+      if (nowMs() - node.lastHeartbeat >= HEARTBEAT_MS) {
+        node.lastHeartbeat = nowMs();
+        sendPacket(node, PEER_HEARTBEAT, PEER_NO_TIMER);
+      }
+    }
+    usleep(1000);
+  }
+}
+
+static bool converged(const std::vector<Node>& nodes, uint8_t timer, uint32_t value) {
+  for (const auto& node : nodes) {
+    if (node.alive && node.state.getTimestamp(timer) != value) return false;
+  }
+  return true;
+}
+
+static int leaderCount(const std::vector<Node>& nodes) {
+  int leaders = 0;
+  for (const auto& node : nodes) {
+    if (node.alive && node.state.isLeader(nowMs())) leaders++;
+  }
+  return leaders;
+}
+
+int main(int argc, char** argv) {
+  int nodeCount = argc > 1 ? atoi(argv[1]) : 4;
+  int presses = argc > 2 ? atoi(argv[2]) : 20;
+  std::mt19937 rng(12345);
+
+  std::vector<Node> nodes(nodeCount);
+  for (int i = 0; i < nodeCount; i++) {
+    nodes[i].state.begin(0x100000 + rng() % 0xEFFFFF);
+    nodes[i].sock = openSocket();
+  }
+
+  // Let heartbeats establish membership
+  pump(nodes, 1500);
+  printf("nodes=%d leaders=%d\n", nodeCount, leaderCount(nodes));
+
+  uint32_t epoch = 1760000000;
+  uint32_t worstMs = 0;
+  int failures = 0;
+
+  for (int p = 0; p < presses; p++) {
+    Node& presser = nodes[rng() % nodeCount];
+    uint8_t timer = rng() % 3;
+    epoch += 1 + rng() % 30;
+
+    // Same as PeerSync::onLocalChange: update, send, repeat shortly after
+    presser.state.setLocal(timer, epoch, epoch);
+    uint32_t start = nowMs();
+    sendPacket(presser, PEER_TIMER_UPDATE, timer);
+
+    bool ok = false;
+    while (nowMs() - start < 2000) {
+      pump(nodes, 2);
+      if (nowMs() - start > 150 && nowMs() - start < 160) sendPacket(presser, PEER_TIMER_UPDATE, timer);
+      if (converged(nodes, timer, epoch)) {
+        ok = true;
+        break;
+      }
+    }
+    uint32_t elapsed = nowMs() - start;
+    if (!ok) failures++;
+    if (elapsed > worstMs) worstMs = elapsed;
+  }
+  printf("presses=%d failures=%d worst_convergence_ms=%u\n", presses, failures, worstMs);
+
+  // Leader failover: stop the current leader and wait for the timeout
+  for (auto& node : nodes) {
+    if (node.alive && node.state.isLeader(nowMs())) {
+      node.alive = false;
+      close(node.sock);
+      printf("stopped leader %06x\n", node.state.getNodeId());
+      break;
+    }
+  }
+  pump(nodes, PEER_NODE_TIMEOUT + 1500);
+  int leaders = leaderCount(nodes);
+  printf("after failover leaders=%d\n", leaders);
+
+  bool pass = failures == 0 && leaders == 1;
+  printf("%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+// Next-pee predictor replay: feeds recorded events through PeePredictor (the
+// same fixed-point code the tracker runs) and compares the predicted alert
+// deadlines with the static YELLOW_THRESHOLD/RED_THRESHOLD ones.
+//
+// Input is the CSV written by the event collector (tools/collector):
+//   ./collector range ~/dog-history > events.csv
+// Without a file a synthetic routine is generated (day/night intervals plus
+// occasional trips outside without a pee).
+//
+// Build and run from this directory:
+//   g++ -std=c++17 -O2 -I../../dog-potty-tracker predictor_sim.cpp -o predictor_sim
+//   ./predictor_sim [events.csv] [--tz <hours>] [--dog <name>]
+
+#include "PeePredictor.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// Same defaults as config.h
+static const long YELLOW_THRESHOLD = 150;
+static const long RED_THRESHOLD = 240;
+static const long PREDICT_MIN_CONFIDENCE = 40;
+static const long PREDICT_MIN_MINUTES = 60;
+static const long PREDICT_MAX_MINUTES = 600;
+static const long PREDICT_MIN_WINDOW = 15;
+
+struct Event {
+  uint32_t time;
+  int timer;  // 0 = outside, 1 = pee, 2 = poop
+};
+
+// Where a pee landed relative to the alert deadlines
+struct Outcome {
+  int early = 0;      // Before yellow (no alert needed)
+  int warned = 0;     // Between yellow and red (alert in time)
+  int overdue = 0;    // After red
+  double absoluteError = 0;
+  int predictions = 0;
+
+  void add(long minutes, long yellow, long red) {
+    if (minutes <= yellow) early++;
+    else if (minutes <= red) warned++;
+    else overdue++;
+  }
+
+  void print(const char* name) const {
+    int total = early + warned + overdue;
+    printf("%-10s early %5.1f%%  warned %5.1f%%  overdue %5.1f%%", name, 100.0 * early / total,
+           100.0 * warned / total, 100.0 * overdue / total);
+    if (predictions > 0) printf("  MAE %.0f min", absoluteError / predictions);
+    printf("\n");
+  }
+};
+
+static int hourOf(uint32_t time, int tzHours) {
+  return (int)((((int64_t)time + tzHours * 3600) % 86400 + 86400) % 86400 / 3600);
+}
+
+static std::vector<Event> loadCsv(const char* path, const std::string& dog) {
+  std::vector<Event> events;
+  FILE* file = fopen(path, "r");
+  if (file == nullptr) {
+    perror(path);
+    exit(1);
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), file)) {
+    char name[64];
+    char timer[16];
+    unsigned long start;
+    if (sscanf(line, "%lu,%63[^,],%15[^,],", &start, name, timer) != 3) continue;  // Header
+    if (!dog.empty() && dog != name) continue;
+    int index = strcmp(timer, "outside") == 0 ? 0 : strcmp(timer, "pee") == 0 ? 1 : 2;
+    events.push_back(Event{(uint32_t)start, index});
+  }
+  fclose(file);
+  std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.time < b.time; });
+  return events;
+}
+
+// 90 days: ~3h intervals from a 7:00 wake-up, bedtime walk at ~22:30, sometimes
+// a trip outside without a pee (after which the pee comes sooner)
+static std::vector<Event> synthesize(int tzHours) {
+  std::vector<Event> events;
+  std::mt19937 rng(7);
+  std::normal_distribution<double> dayInterval(185, 20);
+  std::normal_distribution<double> jitter(0, 15);
+  auto walk = [&](uint32_t time) {
+    events.push_back(Event{time - 60, 0});
+    events.push_back(Event{time, 1});
+    if (rng() % 3 == 0) events.push_back(Event{time + 120, 2});
+  };
+
+  uint32_t midnight = 1735689600 - tzHours * 3600;  // 2025-01-01 00:00 local
+  for (int day = 0; day < 90; day++, midnight += 86400) {
+    uint32_t time = midnight + 7 * 3600 + (int32_t)(jitter(rng) * 60);
+    uint32_t bedtime = midnight + 22 * 3600 + 30 * 60 + (int32_t)(jitter(rng) * 60);
+    walk(time);
+    while (true) {
+      bool missed = rng() % 7 == 0;
+      uint32_t minutes = (uint32_t)std::max(60.0, dayInterval(rng) - (missed ? 45 : 0));
+      if (time + (minutes + 60) * 60 > bedtime) break;
+      if (missed) events.push_back(Event{time + (minutes - 50) * 60, 0});
+      time += minutes * 60;
+      walk(time);
+    }
+    walk(bedtime);
+  }
+  return events;
+}
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  int tzHours = 0;
+  std::string dog;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--tz") == 0 && i + 1 < argc) tzHours = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--dog") == 0 && i + 1 < argc) dog = argv[++i];
+    else path = argv[i];
+  }
+
+  std::vector<Event> events = path ? loadCsv(path, dog) : synthesize(tzHours);
+  printf("%zu events (%s)\n", events.size(), path ? path : "synthetic");
+
+  PeePredictor predictor;
+  Outcome fixed;
+  Outcome predicted;
+  uint32_t lastPee = 0;
+  int confident = 0;
+
+  for (const Event& event : events) {
+    if (event.timer == 0) {
+      predictor.recordOutside(event.time);
+      continue;
+    }
+    if (event.timer != 1) continue;
+
+    if (lastPee != 0 && event.time > lastPee) {
+      long minutes = (long)(event.time - lastPee) / 60;
+      long yellow = YELLOW_THRESHOLD;
+      long red = RED_THRESHOLD;
+      fixed.add(minutes, yellow, red);
+      fixed.absoluteError += labs(minutes - YELLOW_THRESHOLD);
+      fixed.predictions++;
+
+      // Deadlines exactly as updateAlertThresholds() derives them, evaluated just before the pee
+      PeePrediction prediction;
+      if (predictor.predict(lastPee, hourOf(lastPee, tzHours), event.time - 1, &prediction)) {
+        predicted.absoluteError += labs(minutes - (long)prediction.interval / 60);
+        predicted.predictions++;
+        if (prediction.confidence >= PREDICT_MIN_CONFIDENCE) {
+          yellow = std::min(std::max(((long)prediction.interval - (long)prediction.spread) / 60, PREDICT_MIN_MINUTES),
+                            PREDICT_MAX_MINUTES - PREDICT_MIN_WINDOW);
+          red = std::min(std::max(((long)prediction.interval + 2 * (long)prediction.spread) / 60, yellow + PREDICT_MIN_WINDOW),
+                         PREDICT_MAX_MINUTES);
+          confident++;
+        }
+      }
+      predicted.add(minutes, yellow, red);
+    }
+
+    predictor.recordPee(lastPee, event.time, hourOf(lastPee, tzHours));
+    lastPee = event.time;
+  }
+
+  if (fixed.early + fixed.warned + fixed.overdue == 0) {
+    printf("No pee intervals to evaluate\n");
+    return 1;
+  }
+  printf("intervals %d, predicted deadlines used for %d\n", fixed.early + fixed.warned + fixed.overdue, confident);
+  fixed.print("static");
+  predicted.print("predicted");
+  printf("PredictorData %zu bytes\n", sizeof(PredictorData));
+  return 0;
+}
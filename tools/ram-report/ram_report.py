@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+# Reads the linker map of an ESP8266 build and reports how much DRAM, IRAM and
+# flash each module uses, and how much heap is left for TLS connections.
+#
+# Every input section in the map is assigned to its object file (sketch modules
+# by file name, libraries and the core by archive) and to a memory region by its
+# address, so the report does not depend on how the core's linker script names
+# its output sections:
+#   DRAM  0x3FFE8000-0x3FFFFFFF  .data, .rodata (plain string literals!), .bss
+#   IRAM  0x40100000-0x4010FFFF  IRAM_ATTR code
+#   flash 0x40200000-0x40FFFFFF  code and PROGMEM/PSTR()/F() data
+#
+# The heap starts after .bss; whatever static DRAM a module takes is heap a
+# BearSSL handshake cannot have.
+#
+# With arduino-cli the map is written next to the ELF:
+#   arduino-cli compile --fqbn esp8266:esp8266:d1_mini --build-path build dog-potty-tracker
+#   ./ram_report.py build/dog-potty-tracker.ino.map
+#   ./ram_report.py new.map --baseline old.map      # Per-module difference
+
+import argparse
+import os
+import re
+import sys
+from collections import defaultdict
+
+DRAM_SIZE = 81920       # 0x3FFE8000-0x3FFFC000 usable by the sketch
+IRAM_SIZE = 32768       # Without the 48 KB IRAM option
+REGIONS = [
+    ("dram", 0x3FFE8000, 0x40000000),
+    ("iram", 0x40100000, 0x40110000),
+    ("flash", 0x40200000, 0x41000000),
+]
+
+# " .rodata.str1.1  0x3ffe8a44  0x2b1 /path/DisplayManager.cpp.o"
+# (long section names put the address on the next line)
+SECTION_LINE = re.compile(r"^ (\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+
+def module_name(path):
+    path = path.strip()
+    archive = re.match(r"(.*)\((.*)\)$", path)
+    if archive:
+        # core.a(core_esp8266_main.cpp.o) -> core; libraries by archive name
+        name = os.path.basename(archive.group(1))
+        return re.sub(r"\.a$", "", re.sub(r"^lib", "", name))
+    name = os.path.basename(path)
+    # Sketch objects: DisplayManager.cpp.o, dog-potty-tracker.ino.cpp.o
+    name = re.sub(r"\.o$", "", name)
+    name = re.sub(r"\.(cpp|c|S|ino\.cpp)$", "", name)
+    return name
+
+
+def region_of(address):
+    for name, start, end in REGIONS:
+        if start <= address < end:
+            return name
+    return None
+
+
+def parse_map(path):
+    usage = defaultdict(lambda: defaultdict(int))
+    strings = defaultdict(int)
+    in_map = False
+    pending = None
+    with open(path, errors="replace") as mapfile:
+        for line in mapfile:
+            line = line.rstrip("\n")
+            if not in_map:
+                # Sections before this point were discarded by --gc-sections
+                in_map = line.startswith("Linker script and memory map")
+                continue
+
+            if re.match(r"^ \S+$", line):
+                pending = line.strip()
+                continue
+            match = SECTION_LINE.match(line)
+            section = None
+            if match:
+                section = match.group(1) or pending
+            pending = None
+            if not match or section is None or section.startswith("*"):
+                continue
+
+            address = int(match.group(2), 16)
+            size = int(match.group(3), 16)
+            region = region_of(address)
+            if size == 0 or region is None:
+                continue
+            if region == "dram" and (section.startswith(".bss") or section == "COMMON"):
+                region = "bss"
+
+            module = module_name(match.group(4))
+            usage[module][region] += size
+            if region == "dram" and section.startswith(".rodata.str"):
+                strings[module] += size
+    return usage, strings
+
+
+def totals(usage):
+    result = defaultdict(int)
+    for regions in usage.values():
+        for region, size in regions.items():
+            result[region] += size
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Memory use per module from an ESP8266 linker map")
+    parser.add_argument("map")
+    parser.add_argument("--baseline", help="Older map to compare against")
+    parser.add_argument("--top", type=int, default=25, help="Modules listed (largest DRAM first)")
+    parser.add_argument("--tls-heap", type=int, default=20000,
+                        help="Heap a TLS connection needs (VOICE_MONKEY_MIN_HEAP)")
+    args = parser.parse_args()
+
+    usage, strings = parse_map(args.map)
+    if not usage:
+        sys.exit("No sections found - is this a GNU ld map file (-Wl,-Map)?")
+    base_usage = parse_map(args.baseline)[0] if args.baseline else None
+
+    def static_dram(regions):
+        return regions["dram"] + regions["bss"]
+
+    def cell(module, region):
+        value = usage[module][region] if module in usage else 0
+        if base_usage is None:
+            return "%7d" % value
+        before = base_usage[module][region] if module in base_usage else 0
+        return "%7d %+6d" % (value, value - before)
+
+    modules = set(usage) | (set(base_usage) if base_usage else set())
+    modules = sorted(modules, key=lambda m: -static_dram(usage[m]) if m in usage else 0)[:args.top]
+    width = max(len(m) for m in modules + ["Module"])
+    columns = ["data+rodata", "strings", "bss", "iram", "flash"]
+    cell_width = 14 if base_usage else 7
+    print("%-*s  %s" % (width, "Module", "  ".join("%*s" % (cell_width, c) for c in columns)))
+    for module in modules:
+        row = [cell(module, "dram"), "%*d" % (cell_width, strings[module]), cell(module, "bss"),
+               cell(module, "iram"), cell(module, "flash")]
+        print("%-*s  %s" % (width, module, "  ".join("%*s" % (cell_width, c) for c in row)))
+
+    total = totals(usage)
+    dram = static_dram(total)
+    heap = DRAM_SIZE - dram
+    print()
+    print("DRAM   %6d of %d bytes (data+rodata %d, bss %d, string literals %d)"
+          % (dram, DRAM_SIZE, total["dram"], total["bss"], sum(strings.values())))
+    print("IRAM   %6d of %d bytes" % (total["iram"], IRAM_SIZE))
+    print("Flash  %6d bytes" % total["flash"])
+    print("Heap at boot at most %d bytes, %d above the %d a TLS connection needs"
+          % (heap, heap - args.tls_heap, args.tls_heap))
+    if base_usage is not None:
+        before = static_dram(totals(base_usage))
+        print("Static DRAM %+d bytes against the baseline (heap %+d)" % (dram - before, before - dram))
+
+
+if __name__ == "__main__":
+    main()
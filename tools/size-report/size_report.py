@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+# Builds the tracker once per display mode and prints how much flash, IRAM and
+# RAM each build uses. The mode is a compile-time setting (DISPLAY_CONFIG in
+# config.h), so every build only contains the rendering code of its own mode.
+#
+# Requires arduino-cli with the ESP8266 core and the sketch libraries installed,
+# and dog-potty-tracker/secrets.h (copy secrets.h.example):
+#   ./size_report.py [--fqbn esp8266:esp8266:d1_mini] [--modes 0,1,2,3]
+#
+# The segment sizes are read from the memory summary the ESP8266 core prints
+# after linking (IROM = code in flash, IRAM = code in instruction RAM,
+# DATA/RODATA/BSS = RAM).
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+SKETCH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "dog-potty-tracker")
+SEGMENTS = ["IROM", "IRAM", "DATA", "RODATA", "BSS"]
+
+
+def build(fqbn, mode, build_path):
+    command = [
+        "arduino-cli", "compile",
+        "--fqbn", fqbn,
+        "--build-path", build_path,
+        "--build-property", "compiler.cpp.extra_flags=-DDISPLAY_MODE=%d" % mode,
+        SKETCH,
+    ]
+    result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout)
+        sys.exit("Build for mode %d failed" % mode)
+
+    sizes = {}
+    for line in result.stdout.splitlines():
+        # e.g. "╠══ IRAM     27575    code in IRAM"
+        match = re.search(r"\b(%s)\s+(\d+)\b" % "|".join(SEGMENTS), line)
+        if match:
+            sizes[match.group(1)] = int(match.group(2))
+    missing = [segment for segment in SEGMENTS if segment not in sizes]
+    if missing:
+        sys.exit("No sizes for %s in the build output (is this the ESP8266 core?)" % ", ".join(missing))
+    return sizes
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Binary size per display mode")
+    parser.add_argument("--fqbn", default="esp8266:esp8266:d1_mini")
+    parser.add_argument("--modes", default="0,1,2,3")
+    args = parser.parse_args()
+
+    modes = [int(mode) for mode in args.modes.split(",")]
+    results = {}
+    with tempfile.TemporaryDirectory() as work:
+        for mode in modes:
+            print("Building mode %d..." % mode, file=sys.stderr)
+            results[mode] = build(args.fqbn, mode, os.path.join(work, "mode%d" % mode))
+
+    # Markdown table, differences against the first mode
+    base = results[modes[0]]
+    print("| Mode | " + " | ".join(SEGMENTS) + " |")
+    print("|------|" + "|".join("-" * (len(segment) + 10) for segment in SEGMENTS) + "|")
+    for mode in modes:
+        cells = []
+        for segment in SEGMENTS:
+            value = results[mode][segment]
+            delta = value - base[segment]
+            cells.append("%d (%+d)" % (value, delta) if mode != modes[0] else str(value))
+        print("| %d | " % mode + " | ".join(cells) + " |")
+
+
+if __name__ == "__main__":
+    main()